@@ -0,0 +1,453 @@
+/*
+ * ═══════════════════════════════════════════════════════════════════════════
+ * SYNTHETIC LOG GENERATOR
+ * ═══════════════════════════════════════════════════════════════════════════
+ *
+ * Writes reproducible test logs for the Log File Analyzer:
+ * - Any size from kilobytes to tens of gigabytes (stops at the requested size)
+ * - All three supported line formats, or a per-line mix
+ * - Realistic level mix from weighted message templates
+ * - Repeated templates with variable fields and (UserID: N) suffixes
+ * - Occasional error bursts for the anomaly report
+ *
+ * The same seed and options always produce the same bytes: the random
+ * generator and all distributions are implemented here instead of relying
+ * on <random>, whose distributions differ between standard libraries.
+ *
+ * Usage: log_generator OUTPUT SIZE [options]   (OUTPUT "-" = stdout)
+ *
+ * C++ Standard: C++17
+ *
+ * ═══════════════════════════════════════════════════════════════════════════
+ */
+
+// ═══════════════════════════════════════════════════════════════════════════
+// INCLUDES
+// ═══════════════════════════════════════════════════════════════════════════
+
+#include <cstdio>           // fopen/fwrite for buffered output
+#include <cstdint>          // Fixed-width integers
+#include <cstdlib>          // strtoull / strtod
+#include <cstring>          // strcmp
+#include <cmath>            // log / pow for the distributions
+#include <string>           // Line assembly
+#include <vector>           // Template table
+#include <chrono>           // Elapsed time of the run
+
+using std::string;
+using std::vector;
+
+// ═══════════════════════════════════════════════════════════════════════════
+// CONSTANTS
+// ═══════════════════════════════════════════════════════════════════════════
+
+constexpr size_t   WRITE_BUFFER_BYTES   = 4u << 20;      // Output flushed in 4 MB writes
+constexpr uint64_t DEFAULT_SEED         = 42;
+constexpr double   DEFAULT_RATE         = 20.0;          // Mean lines per second of log time
+constexpr uint32_t DEFAULT_USERS        = 10000;         // Distinct UserID values
+constexpr int64_t  DEFAULT_START_EPOCH  = 1768348800;    // 2026-01-14 00:00:00
+constexpr double   BURST_CHANCE         = 0.002;         // Chance per log minute that an error burst starts
+constexpr int      BURST_MAX_MINUTES    = 5;             // Longest error burst
+constexpr double   BURST_ERROR_BOOST    = 12.0;          // Error template weight multiplier during a burst
+
+// ═══════════════════════════════════════════════════════════════════════════
+// DATA STRUCTURES
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * SplitMix64: tiny, fast and identical on every platform
+ */
+struct Random {
+    uint64_t state;
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+    double uniform() { return (next() >> 11) * (1.0 / 9007199254740992.0); } // [0, 1)
+    uint64_t below(uint64_t bound) { return static_cast<uint64_t>(uniform() * bound); }
+};
+
+/**
+ * Message template: placeholders are filled per line
+ *   {ms} latency, {n} small count, {ip} address, {path} URL path,
+ *   {code} HTTP status, {hex} request id; {user} appends (UserID: N)
+ */
+struct Template {
+    const char* level;
+    const char* text;
+    double weight;            // Relative frequency
+};
+
+/**
+ * Generator options
+ */
+struct Options {
+    string output;
+    uint64_t bytes = 0;
+    uint64_t seed = DEFAULT_SEED;
+    int format = 0;                   // 1-3, or 0 for a per-line mix
+    double rate = DEFAULT_RATE;
+    uint32_t users = DEFAULT_USERS;
+    int64_t startEpoch = DEFAULT_START_EPOCH;
+    double malformed = 0.0;           // Fraction of lines written without a valid prefix
+};
+
+// Weights give roughly 75% INFO, 8% DEBUG, 12% WARN, 4.5% ERROR and 0.5% CRITICAL
+static const vector<Template> TEMPLATES = {
+    {"INFO",     "User login successful {user}",                             14.0},
+    {"INFO",     "User logout {user}",                                       10.0},
+    {"INFO",     "GET {path} {code} in {ms}ms {user}",                       12.0},
+    {"INFO",     "POST {path} {code} in {ms}ms {user}",                       6.0},
+    {"INFO",     "Database query executed in {ms}ms {user}",                  9.0},
+    {"INFO",     "Cache hit for session {hex} {user}",                        7.0},
+    {"INFO",     "Payment processed for order {n} {user}",                    4.0},
+    {"INFO",     "Scheduled job completed: {n} records",                      3.0},
+    {"INFO",     "Connection established from {ip}",                          5.0},
+    {"INFO",     "Configuration reloaded",                                    1.0},
+    {"INFO",     "Health check passed",                                       4.0},
+    {"DEBUG",    "Cache miss for key user:{n}",                               3.0},
+    {"DEBUG",    "Request {hex} routed to worker {n}",                        3.0},
+    {"DEBUG",    "Session {hex} refreshed {user}",                            2.0},
+    {"WARN",     "Memory usage is high: {n}%",                                2.0},
+    {"WARN",     "Slow query took {ms}ms {user}",                             3.0},
+    {"WARN",     "Network latency increased to {ms}ms",                       2.0},
+    {"WARN",     "Retrying request {hex} (attempt {n})",                      2.5},
+    {"WARN",     "Rate limit approaching for {ip} {user}",                    1.5},
+    {"WARN",     "Timeout waiting for response from {ip} {user}",             1.0},
+    {"ERROR",    "Failed to connect to database {user}",                      1.2},
+    {"ERROR",    "Connection timeout after {ms}ms {user}",                    1.1},
+    {"ERROR",    "Payment declined for order {n} {user}",                     0.7},
+    {"ERROR",    "Unhandled exception in request {hex}",                      0.6},
+    {"ERROR",    "Database deadlock detected {user}",                         0.4},
+    {"ERROR",    "Disk write failed on volume {n}",                           0.5},
+    {"CRITICAL", "Connection pool exhausted",                                 0.3},
+    {"CRITICAL", "Service unavailable: {n} replicas down",                    0.2},
+};
+
+static const char* const PATHS[] = {
+    "/api/users", "/api/orders", "/api/cart", "/api/search", "/login", "/checkout", "/static/app.js", "/health"
+};
+static const char* const CODES[] = {"200", "200", "200", "200", "201", "204", "304", "400", "404", "500"};
+
+// ═══════════════════════════════════════════════════════════════════════════
+// IMPLEMENTATION
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Parse sizes like 500K, 64M or 20G (binary units)
+ *
+ * @param text  Size text
+ * @param bytes Receives the size
+ * @return      false if the text is not a size
+ */
+static bool parseSize(const char* text, uint64_t& bytes) {
+    char* end = nullptr;
+    double value = std::strtod(text, &end);
+    if (end == text || value <= 0) return false;
+    uint64_t scale = 1;
+    switch (*end) {
+        case 'k': case 'K': scale = 1ull << 10; end++; break;
+        case 'm': case 'M': scale = 1ull << 20; end++; break;
+        case 'g': case 'G': scale = 1ull << 30; end++; break;
+        case 't': case 'T': scale = 1ull << 40; end++; break;
+        default: break;
+    }
+    if (*end == 'B' || *end == 'b') end++;
+    if (*end != '\0') return false;
+    bytes = static_cast<uint64_t>(value * scale);
+    return bytes > 0;
+}
+
+/**
+ * Parse "YYYY-MM-DD HH:MM:SS" as seconds since 1970-01-01 (UTC, no time zones)
+ */
+static bool parseStart(const char* text, int64_t& epoch) {
+    int y, mo, d, h, mi, s;
+    if (std::sscanf(text, "%d-%d-%d %d:%d:%d", &y, &mo, &d, &h, &mi, &s) != 6) return false;
+    if (mo < 1 || mo > 12 || d < 1 || d > 31 || h > 23 || mi > 59 || s > 59) return false;
+    // Days from civil (proleptic Gregorian)
+    y -= mo <= 2;
+    int64_t era = (y >= 0 ? y : y - 399) / 400;
+    int64_t yoe = y - era * 400;
+    int64_t doy = (153 * (mo + (mo > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    epoch = (era * 146097 + doe - 719468) * 86400 + h * 3600 + mi * 60 + s;
+    return true;
+}
+
+/**
+ * Split an epoch day into year, month and day (civil from days)
+ */
+static void civilFromDays(int64_t days, int& year, int& month, int& day) {
+    days += 719468;
+    int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    int64_t doe = days - era * 146097;
+    int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    int64_t mp = (5 * doy + 2) / 153;
+    day = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+    month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+    year = static_cast<int>(yoe + era * 400 + (month <= 2));
+}
+
+static void appendTwo(string& out, int value) {
+    out += static_cast<char>('0' + value / 10);
+    out += static_cast<char>('0' + value % 10);
+}
+
+static void appendNumber(string& out, uint64_t value) {
+    char digits[20];
+    int count = 0;
+    do {
+        digits[count++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    while (count > 0) out += digits[--count];
+}
+
+/**
+ * Append the timestamp prefix and level of one line in the given format
+ *   1: YYYY-MM-DD HH:MM:SS [LEVEL]    2: [YYYY-MM-DD HH:MM:SS] LEVEL:
+ *   3: MM/DD/YYYY HH:MM:SS - LEVEL -
+ */
+static void appendPrefix(string& out, int format, int64_t epoch, const char* level) {
+    int64_t days = epoch >= 0 ? epoch / 86400 : (epoch - 86399) / 86400;
+    int64_t second = epoch - days * 86400;
+    int year, month, day;
+    civilFromDays(days, year, month, day);
+
+    char date[16];
+    if (format == 3) std::snprintf(date, sizeof(date), "%02d/%02d/%04d", month, day, year);
+    else std::snprintf(date, sizeof(date), "%04d-%02d-%02d", year, month, day);
+
+    if (format == 2) out += '[';
+    out += date;
+    out += ' ';
+    appendTwo(out, static_cast<int>(second / 3600));
+    out += ':';
+    appendTwo(out, static_cast<int>(second / 60 % 60));
+    out += ':';
+    appendTwo(out, static_cast<int>(second % 60));
+
+    if (format == 1) {
+        out += " [";
+        out += level;
+        out += "] ";
+    } else if (format == 2) {
+        out += "] ";
+        out += level;
+        out += ": ";
+    } else {
+        out += " - ";
+        out += level;
+        out += " - ";
+    }
+}
+
+/**
+ * Append a message with its placeholders filled in
+ */
+static void appendMessage(string& out, const char* text, Random& random, uint32_t users) {
+    for (const char* p = text; *p; ++p) {
+        if (*p != '{') {
+            out += *p;
+            continue;
+        }
+        const char* close = std::strchr(p, '}');
+        char kind = p[1];
+        p = close;
+
+        switch (kind) {
+            case 'u': {  // {user}: skewed popularity, a few users produce most of the traffic
+                double u = random.uniform();
+                out += "(UserID: ";
+                appendNumber(out, 1000 + static_cast<uint64_t>(u * u * u * users));
+                out += ')';
+                break;
+            }
+            case 'm':    // {ms}
+                appendNumber(out, static_cast<uint64_t>(5 - 40 * std::log(1.0 - random.uniform())));
+                break;
+            case 'n':    // {n}
+                appendNumber(out, 1 + random.below(100));
+                break;
+            case 'i':    // {ip}
+                out += "10.";
+                appendNumber(out, random.below(256));
+                out += '.';
+                appendNumber(out, random.below(256));
+                out += '.';
+                appendNumber(out, 1 + random.below(254));
+                break;
+            case 'p':    // {path}
+                out += PATHS[random.below(sizeof(PATHS) / sizeof(PATHS[0]))];
+                break;
+            case 'c':    // {code}
+                out += CODES[random.below(sizeof(CODES) / sizeof(CODES[0]))];
+                break;
+            case 'h': {  // {hex}
+                static const char DIGITS[] = "0123456789abcdef";
+                uint64_t value = random.next();
+                for (int shift = 60; shift >= 0; shift -= 4) out += DIGITS[(value >> shift) & 0xF];
+                break;
+            }
+            default:
+                break;
+        }
+    }
+}
+
+/**
+ * Pick a template by weight (linear scan over cumulative weights)
+ */
+static const Template& pickTemplate(Random& random, const vector<double>& cumulative) {
+    double target = random.uniform() * cumulative.back();
+    size_t i = 0;
+    while (i + 1 < cumulative.size() && cumulative[i] <= target) i++;
+    return TEMPLATES[i];
+}
+
+static void printUsage() {
+    std::fprintf(stderr,
+        "Usage: log_generator OUTPUT SIZE [options]\n"
+        "  OUTPUT            File to write (\"-\" = stdout)\n"
+        "  SIZE              Bytes to write, e.g. 500K, 64M, 20G\n"
+        "  --seed N          Random seed (default %llu)\n"
+        "  --format 1|2|3|mixed  Line format (default mixed)\n"
+        "  --rate N          Mean lines per second of log time (default %.0f)\n"
+        "  --users N         Distinct UserID values (default %u)\n"
+        "  --start \"YYYY-MM-DD HH:MM:SS\"  First timestamp (default 2026-01-14 00:00:00)\n"
+        "  --malformed P     Fraction of malformed lines, 0-1 (default 0)\n",
+        static_cast<unsigned long long>(DEFAULT_SEED), DEFAULT_RATE, DEFAULT_USERS);
+}
+
+/**
+ * Parse the command line
+ *
+ * @return false (after printing usage) on invalid arguments
+ */
+static bool parseOptions(int argc, char* argv[], Options& options) {
+    if (argc < 3 || !parseSize(argv[2], options.bytes)) {
+        printUsage();
+        return false;
+    }
+    options.output = argv[1];
+    for (int i = 3; i < argc; ++i) {
+        string option = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        bool ok = true;
+        if (value == nullptr) {
+            ok = false;
+        } else if (option == "--seed") {
+            options.seed = std::strtoull(value, nullptr, 10);
+        } else if (option == "--format") {
+            options.format = std::strcmp(value, "mixed") == 0 ? 0 : std::atoi(value);
+            ok = options.format >= 0 && options.format <= 3;
+        } else if (option == "--rate") {
+            options.rate = std::strtod(value, nullptr);
+            ok = options.rate > 0;
+        } else if (option == "--users") {
+            options.users = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+            ok = options.users > 0;
+        } else if (option == "--start") {
+            ok = parseStart(value, options.startEpoch);
+        } else if (option == "--malformed") {
+            options.malformed = std::strtod(value, nullptr);
+            ok = options.malformed >= 0 && options.malformed <= 1;
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            std::fprintf(stderr, "Invalid option: %s\n", option.c_str());
+            printUsage();
+            return false;
+        }
+        i++;
+    }
+    return true;
+}
+
+/**
+ * Generate lines until the requested size is reached
+ *
+ * Log time advances by exponential gaps (mean 1/rate seconds). Each new
+ * log minute may start an error burst that boosts error templates for a
+ * few minutes, so error-rate anomalies appear in large files.
+ */
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) return 1;
+
+    FILE* out = options.output == "-" ? stdout : std::fopen(options.output.c_str(), "wb");
+    if (out == nullptr) {
+        std::fprintf(stderr, "Could not create file: %s\n", options.output.c_str());
+        return 1;
+    }
+
+    Random random{options.seed};
+    vector<double> normal, burst;
+    double total = 0, burstTotal = 0;
+    for (const Template& t : TEMPLATES) {
+        bool error = std::strcmp(t.level, "ERROR") == 0 || std::strcmp(t.level, "CRITICAL") == 0;
+        total += t.weight;
+        burstTotal += t.weight * (error ? BURST_ERROR_BOOST : 1.0);
+        normal.push_back(total);
+        burst.push_back(burstTotal);
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    string buffer;
+    buffer.reserve(WRITE_BUFFER_BYTES + 1024);
+    uint64_t written = 0, lines = 0;
+    double clock = static_cast<double>(options.startEpoch);
+    int64_t minute = INT64_MIN;
+    int64_t burstEnd = INT64_MIN;
+
+    while (written + buffer.size() < options.bytes) {
+        clock += -std::log(1.0 - random.uniform()) / options.rate;
+        int64_t epoch = static_cast<int64_t>(clock);
+        if (epoch / 60 != minute) {
+            minute = epoch / 60;
+            if (epoch >= burstEnd && random.uniform() < BURST_CHANCE) {
+                burstEnd = epoch + 60 * (1 + static_cast<int64_t>(random.below(BURST_MAX_MINUTES)));
+            }
+        }
+
+        const Template& t = pickTemplate(random, epoch < burstEnd ? burst : normal);
+        int format = options.format ? options.format : static_cast<int>(1 + random.below(3));
+        if (options.malformed > 0 && random.uniform() < options.malformed) {
+            buffer += "?? ";  // No recognizable timestamp: the analyzer skips the line
+            appendMessage(buffer, t.text, random, options.users);
+        } else {
+            appendPrefix(buffer, format, epoch, t.level);
+            appendMessage(buffer, t.text, random, options.users);
+        }
+        buffer += '\n';
+        lines++;
+
+        if (buffer.size() >= WRITE_BUFFER_BYTES) {
+            if (std::fwrite(buffer.data(), 1, buffer.size(), out) != buffer.size()) {
+                std::fprintf(stderr, "Write failed: %s\n", options.output.c_str());
+                return 1;
+            }
+            written += buffer.size();
+            buffer.clear();
+        }
+    }
+    if (!buffer.empty() && std::fwrite(buffer.data(), 1, buffer.size(), out) != buffer.size()) {
+        std::fprintf(stderr, "Write failed: %s\n", options.output.c_str());
+        return 1;
+    }
+    written += buffer.size();
+    if (out != stdout) std::fclose(out);
+    else std::fflush(out);
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    std::fprintf(stderr, "Wrote %llu lines (%.1f MB) in %.2f s (%.0f MB/s), seed %llu\n",
+                 static_cast<unsigned long long>(lines), written / 1048576.0, seconds,
+                 seconds > 0 ? written / 1048576.0 / seconds : 0.0, static_cast<unsigned long long>(options.seed));
+    return 0;
+}
@@ -22,7 +22,11 @@
 // INCLUDES
 // ═══════════════════════════════════════════════════════════════════════════
 
+#include <winsock2.h>       // Sockets for the query server (before windows.h)
+#include <afunix.h>         // AF_UNIX socket addresses (Windows 10 1803+)
 #include <windows.h>        // Windows console API for ANSI color support
+#include <conio.h>          // _kbhit/_getch to cancel long-running scans
+#include <psapi.h>          // GetProcessMemoryInfo for the memory report
 
 #include <iostream>         // Input/output streams
 #include <fstream>          // File streams
@@ -30,13 +34,50 @@
 #include <vector>           // Dynamic arrays
 #include <regex>            // Regular expressions for log parsing
 #include <unordered_map>    // Hash maps for statistics
+#include <unordered_set>    // Per-block id sets for index builds
 #include <algorithm>        // STL algorithms (find, transform, etc.)
 #include <limits>           // Numeric limits
+#include <cmath>            // sqrt/pow for anomaly baselines
 #include <chrono>           // Time operations for timestamps
 #include <thread>           // Thread sleep for animations
 #include <sstream>          // String streams
 #include <iomanip>          // I/O manipulators (setw, setprecision)
 #include <filesystem>       // File system operations (C++17)
+#include <string_view>      // Non-owning views into pooled strings
+#include <mutex>            // Shard locks for the message pool
+#include <memory>           // unique_ptr for arena chunks
+#include <cstring>          // memcpy for arena copies and hashing
+#include <cstdint>          // Fixed-width integer ids
+#include <array>            // Fixed-size Bloom filter words
+#include <atomic>           // Work counter for parallel index builds
+#include <bitset>           // Character sets for the regex engine
+#include <map>              // DFA state cache keyed by NFA state sets
+#include <cctype>           // Character classification for regex classes
+#include <queue>            // Run heap for the external merge sort
+#include <list>             // LRU order of the result cache
+#include <deque>            // Recent search result sets
+#include <condition_variable> // Query server job queue
+#include <random>           // Random offsets and reservoir skips for sampling
+#include <new>              // Counting operator new for instrumentation
+#include <cstdlib>          // malloc / free behind operator new
+#include <cstdio>           // snprintf for timestamp formatting
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>      // SSE2 intrinsics for the substring kernel
+#define LOG_ANALYZER_SSE2 1
+#endif
+
+#if defined(__GNUC__)
+#define LOG_ANALYZER_NOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+#define LOG_ANALYZER_NOINLINE __declspec(noinline)
+#else
+#define LOG_ANALYZER_NOINLINE
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h>      // AVX2 intrinsics for bitmap combination (-mavx2, /arch:AVX2)
+#endif
 
 // ═══════════════════════════════════════════════════════════════════════════
 // NAMESPACE DECLARATIONS
@@ -47,6 +88,7 @@ using std::cin;
 using std::cerr;
 using std::endl;
 using std::string;
+using std::string_view;
 using std::vector;
 using std::ifstream;
 using std::istringstream;
@@ -89,25 +131,1216 @@ using std::tolower;
 constexpr int BANNER_ANIMATION_FRAMES = 40;  // Number of animation frames
 constexpr int BANNER_FRAME_DELAY_MS = 80;    // Milliseconds per frame
 
+constexpr size_t   MESSAGE_ARENA_MIN_CHUNK  = 4096;     // First arena chunk per shard
+constexpr size_t   MESSAGE_ARENA_MAX_CHUNK  = 1 << 20;  // Chunks double up to 1 MiB
+constexpr unsigned MESSAGE_POOL_SHARD_BITS  = 4;        // 16 independently locked shards
+constexpr unsigned MESSAGE_POOL_SHARDS      = 1u << MESSAGE_POOL_SHARD_BITS;
+
+constexpr size_t  LOG_BLOCK_SIZE     = 4096;      // Entries per skip-index block
+constexpr size_t  BLOOM_FILTER_BITS  = 1 << 16;   // 8 KB Bloom filter per block
+constexpr int     BLOOM_HASH_COUNT   = 3;         // Probes per trigram
+constexpr int64_t INVALID_EPOCH      = INT64_MIN; // Timestamp could not be parsed
+constexpr int64_t MAX_UTC_OFFSET     = 14 * 3600; // Largest --timezone offset (UTC+14:00)
+
+constexpr uint64_t LOW_MEMORY_AUTO_BYTES = 1ull << 30;  // Files above 1 GB load in low-memory mode
+constexpr size_t   MIN_MEMORY_BUDGET     = 16u << 20;   // Smallest --max-memory (keeps segments large)
+
+constexpr size_t REGEX_MAX_DFA_BYTES = 2 << 20;   // Lazy DFA cache limit (transitions, state sets, lookup)
+constexpr size_t REGEX_MAX_NFA_STATES = 100000;   // Reject patterns that expand beyond this
+constexpr size_t REGEX_MAX_REPEAT     = 1000;     // Largest {m,n} bound
+
+constexpr size_t SEARCH_STREAM_LIMIT          = 20;   // Matches printed while a search runs
+constexpr int    SEARCH_POLL_INTERVAL_MS      = 10;   // Keyboard / result polling period
+constexpr int    SEARCH_PROGRESS_INTERVAL_MS  = 200;  // Progress line refresh period
+constexpr size_t SEARCH_STEP_LIMIT            = 32;   // Search result sets kept for refinement
+
+constexpr size_t   ARCHIVE_BLOCK_ROWS = 65536;  // Entries per archive block
+constexpr uint32_t ARCHIVE_VERSION    = 2;      // Bumped on layout changes (2: UTC offset in the header)
+constexpr char     ARCHIVE_MAGIC[]    = "LGAR"; // First and last 4 bytes of an archive
+constexpr unsigned ARCHIVE_LZ_HASH_BITS = 16;     // Match finder table size (64K slots)
+constexpr size_t   ARCHIVE_LZ_MIN_MATCH = 4;      // Shortest back-reference
+constexpr uint64_t ARCHIVE_MAX_COLUMN_BYTES = 1ull << 31; // Sanity limit when decoding
+
+constexpr int64_t ANOMALY_WINDOW_SECONDS   = 60;    // Counting window
+constexpr double  ANOMALY_EWMA_ALPHA       = 0.1;   // Baseline smoothing per window
+constexpr double  ANOMALY_Z_THRESHOLD      = 3.0;   // Flag windows this far above baseline
+constexpr size_t  ANOMALY_MIN_COUNT        = 5;     // Ignore spikes smaller than this
+constexpr size_t  ANOMALY_WARMUP_WINDOWS   = 10;    // Windows before anything is flagged
+constexpr int64_t ANOMALY_MAX_GAP_WINDOWS  = 1440;  // Empty windows replayed across a gap (1 day)
+constexpr size_t  ANOMALY_TOP_TEMPLATES    = 3;     // Contributors listed per incident
+
+constexpr double  LOG_DIFF_Z_THRESHOLD     = 3.0;   // Rate change must be this significant...
+constexpr double  LOG_DIFF_MIN_RATIO       = 2.0;   // ...and at least this large
+constexpr size_t  LOG_DIFF_TOP             = 10;    // Templates listed per diff section
+
+constexpr int64_t JOIN_DEFAULT_WINDOW      = 2;     // Seconds A may precede B
+constexpr size_t  JOIN_PREVIEW_ROWS        = 20;    // B entries (and A entries each) listed
+constexpr size_t  JOIN_TOP_GROUPS          = 10;    // Template pairs listed
+
+constexpr const char* SESSION_DEFAULT_FIELD = "UserID"; // Id field used for sessions
+constexpr int64_t SESSION_DEFAULT_GAP_MINUTES = 30; // Inactivity that ends a session
+constexpr size_t  SESSION_LIST_ROWS        = 10;    // Sessions listed per report section
+constexpr size_t  SESSION_TIMELINE_ROWS    = 50;    // Entries shown per session timeline
+
+constexpr const char* SERVER_DEFAULT_SOCKET = "log_analyzer.sock"; // --serve / --connect socket file
+constexpr size_t  SERVER_MAX_ROWS          = 1000;  // Entries returned per query
+constexpr int     SERVER_POLL_INTERVAL_MS  = 20;    // Event loop wakeup (keypress, finished queries)
+constexpr size_t  SERVER_RECV_BUFFER       = 16384; // Bytes read per recv
+constexpr size_t  SERVER_MAX_BUFFERED      = 1u << 20; // Per-client unsent (or undispatched) bytes before backpressure
+
+constexpr size_t  RESULT_CACHE_BYTES       = 64u << 20; // Memory cap of the search result cache
+constexpr size_t  RESULT_CACHE_BUDGET_SHARE = 8;        // Under --max-memory the cap is at most budget / 8
+
+constexpr size_t  SAMPLE_DEFAULT_LINES     = 20000; // Lines drawn by a sampling estimate
+constexpr size_t  SAMPLE_MIN_LINES         = 100;
+constexpr size_t  SAMPLE_MAX_LINES         = 1000000;
+constexpr size_t  SAMPLE_PROBE_BYTES       = 1024;  // Bytes read at each random offset...
+constexpr size_t  SAMPLE_MAX_LINE_BYTES    = 65536; // ...retried up to this when no full line fits
+constexpr size_t  SAMPLE_STREAM_CHUNK      = 1u << 20; // Read size of reservoir sampling
+constexpr uint64_t SAMPLE_STREAM_BYTES     = 64ull << 20; // Smaller files are streamed through a reservoir
+constexpr double  SAMPLE_Z_95              = 1.96;  // Normal quantile of the 95% intervals
+constexpr size_t  SAMPLE_TOP_TEMPLATES     = 10;    // Templates listed in the estimate
+
+constexpr const char* PROFILE_DEFAULT_FILE = "log_analyzer_profile.json"; // --profile / menu JSON summary
+constexpr const char* TRACE_DEFAULT_FILE   = "log_analyzer_trace.json";   // --trace / menu trace recording
+constexpr size_t      TRACE_RING_EVENTS    = 1 << 15; // Events kept per thread (power of two; oldest overwritten)
+constexpr size_t      MEMORY_SUMMARY_COMPONENTS = 3;  // Structures listed after each load
+
+constexpr unsigned    BENCH_DEFAULT_RUNS   = 5;       // Measured repetitions per benchmark case
+constexpr unsigned    BENCH_DEFAULT_WARMUP = 1;       // Unmeasured repetitions before them
+constexpr unsigned    BENCH_MAX_RUNS       = 1000;
+constexpr size_t      BENCH_PARSE_LINES    = 200000;  // Lines held in memory for the parse case
+constexpr double      BENCH_RANGE_SHARE    = 0.1;     // Middle share of the time span the range query selects
+constexpr const char* BENCH_SEARCH_KEYWORD = "timeout";
+constexpr const char* BENCH_SEARCH_REGEX   = "/timeout after \\d+ms/";
+
+constexpr size_t SORT_MEMORY_BUDGET = 256u << 20;  // Largest in-memory radix sort (keys + scratch)
+constexpr size_t SORT_BUDGET_SHARE  = 4;           // Under --max-memory the sort uses at most budget / 4
+constexpr size_t SORT_MIN_SLICE     = 1 << 16;     // Smallest per-thread slice worth a thread
+constexpr size_t SORT_MERGE_BUFFER  = 4096;        // Pairs buffered per run while merging
+
 // ═══════════════════════════════════════════════════════════════════════════
 // DATA STRUCTURES
 // ═══════════════════════════════════════════════════════════════════════════
 
+/**
+ * How an entry's timestamp is printed back
+ */
+enum TimestampFormat : uint8_t {
+    TIMESTAMP_ISO,  // YYYY-MM-DD HH:MM:SS (formats 1 and 2), rebuilt from epoch
+    TIMESTAMP_US,   // MM/DD/YYYY HH:MM:SS (format 3), rebuilt from epoch
+    TIMESTAMP_RAW   // Text kept in the message pool (did not round-trip)
+};
+
+/**
+ * Fast decoder of the fixed-width log timestamps
+ * 
+ * Reads YYYY-MM-DD HH:MM:SS and MM/DD/YYYY HH:MM:SS digit by digit and
+ * remembers the day number of the last date it saw, so lines from the same
+ * day cost a compare of the date characters plus an add for h:m:s. Only
+ * valid calendar times are accepted (those print back identically through
+ * formatEpoch); anything else returns false for the lenient slow path.
+ * The log's UTC offset (--timezone) is applied explicitly; the TZ
+ * environment is never consulted. Not thread-safe: use one per thread.
+ */
+class TimestampDecoder {
+public:
+    bool decode(string_view text, int64_t& epoch, TimestampFormat& format); // false = not canonical
+
+private:
+    char lastDate[10] = {};                      // Date characters of the cached day
+    int64_t lastDay = 0;                         // Days since 1970-01-01 of that date
+    bool cached = false;
+};
+
 /**
  * Represents a single log entry with timestamp, level, and message
+ * Level and message text live once in the message pool and are referenced
+ * by id; the timestamp is printed from the epoch. In low-memory mode the
+ * message is not pooled and is read from the mapped source file through
+ * offset and length when needed.
  */
 struct LogEntry {
-    string timestamp;  // Format: YYYY-MM-DD HH:MM:SS
-    string level;      // INFO, WARN, ERROR, etc.
-    string message;    // Log message content
+    static constexpr uint32_t LAZY_MESSAGE = 0xFFFFFFFFu;  // messageId of a message left in the file
+    static constexpr uint32_t MAX_LENGTH = (1u << 28) - 1; // Longest message that fits length
+
+    int64_t epoch;           // Timestamp as seconds since 1970-01-01 (all formats)
+    uint64_t offset;         // Byte offset of the message in the source file
+    uint32_t length : 28;    // Message length in bytes
+    uint32_t format : 4;     // TimestampFormat of the original text
+    uint32_t levelId;        // Pool id of INFO, WARN, ERROR, etc.
+    uint32_t messageId;      // Pool id of the log message content, or LAZY_MESSAGE
+    uint32_t timestampId;    // Pool id of the timestamp text (TIMESTAMP_RAW only)
+};
+
+constexpr size_t LOG_STORE_BLOCK_BYTES = LOG_BLOCK_SIZE * sizeof(LogEntry);  // One store block (128 KB)
+
+/**
+ * Skip index for one block of LOG_BLOCK_SIZE consecutive entries
+ * The Bloom filter holds every lowercased 3-character window of the block's
+ * messages and levels, so a substring search can rule out the whole block
+ * when any trigram of the keyword is missing
+ */
+struct LogBlockIndex {
+    int64_t minEpoch;                                        // Earliest timestamp in block
+    int64_t maxEpoch;                                        // Latest timestamp in block
+    std::array<uint64_t, BLOOM_FILTER_BITS / 64> bloom;      // Trigram Bloom filter
+};
+
+/**
+ * Hash functor for string_view keys (wyhash-style 64-bit mixing)
+ */
+struct StringViewHash {
+    size_t operator()(string_view text) const;
+};
+
+/**
+ * Concurrent string interning arena
+ *
+ * Every distinct string is copied once into large arena chunks and addressed
+ * by a 32-bit id. The pool is split into shards picked by the string hash,
+ * each with its own lock, so several threads can intern at the same time.
+ * Ids encode the shard in their low bits and never change until clear().
+ */
+class MessagePool {
+public:
+    static constexpr uint32_t INVALID_ID = 0xFFFFFFFFu;
+
+    uint32_t intern(string_view text);   // Return id for text, storing it if new
+    uint32_t find(string_view text) const; // Return id for text or INVALID_ID
+    string_view view(uint32_t id) const; // Text behind an id (valid until clear())
+    void clear();                        // Drop all strings and release arena memory
+
+    size_t distinctCount() const;        // Number of distinct strings stored
+    size_t idLimit() const;              // Upper bound of all ids (for dense per-id arrays)
+    size_t internCount() const;          // Number of intern() calls since clear()
+    size_t rawBytes() const;             // Text bytes passed to intern() (no dedup)
+    size_t uniqueBytes() const;          // Text bytes of distinct strings
+    size_t arenaBytes() const;           // Bytes allocated for arena chunks
+    size_t indexBytes() const;           // Approximate hash index + id table size
+
+private:
+    struct Shard {
+        mutable std::mutex mutex;
+        vector<std::unique_ptr<char[]>> chunks;          // Arena storage
+        size_t chunkUsed = 0;                            // Bytes used in active chunk
+        size_t chunkCapacity = 0;                        // Size of active chunk
+        vector<string_view> strings;                     // Local id -> text
+        unordered_map<string_view, uint32_t, StringViewHash> index;  // Text -> local id
+        size_t internCalls = 0;
+        size_t rawBytes = 0;
+        size_t uniqueBytes = 0;
+        size_t arenaBytes = 0;
+    };
+
+    Shard shards[MESSAGE_POOL_SHARDS];
+
+    static const char* copyToArena(Shard& shard, string_view text);
+};
+
+/**
+ * Read-only memory mapping of a log file
+ * Backs message text in low-memory mode; the OS pages bytes in on demand
+ * and can drop them again under memory pressure
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile();
+
+    bool open(const string& path);                         // Map the whole file
+    void close();                                          // Unmap and release handles
+    string_view view(uint64_t offset, uint32_t length) const; // Bytes at offset (empty if out of range)
+    bool isOpen() const { return data != nullptr; }
+    uint64_t fileSize() const { return size; }
+
+private:
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+    const char* data = nullptr;
+    uint64_t size = 0;
+};
+
+/**
+ * Append-only entry store with an optional memory budget
+ *
+ * Entries are kept in blocks of LOG_BLOCK_SIZE (the same blocks as the skip
+ * index), so growing never reallocates or copies earlier entries. When the
+ * resident blocks (plus the bytes reserved for other structures) would
+ * exceed the budget, all complete blocks are sealed: their records are
+ * appended to one segment file in the temp directory, which is mapped back
+ * read-only. Indexing and iteration look the same for resident and sealed
+ * blocks, so every query path works unchanged.
+ */
+class LogStore {
+public:
+    class const_iterator {
+    public:
+        const_iterator(const LogStore* store, size_t index) : store(store), index(index) {}
+        const LogEntry& operator*() const { return (*store)[index]; }
+        const LogEntry* operator->() const { return &(*store)[index]; }
+        const_iterator& operator++() { ++index; return *this; }
+        bool operator==(const const_iterator& other) const { return index == other.index; }
+        bool operator!=(const const_iterator& other) const { return index != other.index; }
+    private:
+        const LogStore* store;
+        size_t index;
+    };
+
+    LogStore() = default;
+    LogStore(const LogStore&) = delete;
+    LogStore& operator=(const LogStore&) = delete;
+    ~LogStore();
+
+    void push_back(const LogEntry& entry);           // Append, sealing blocks over budget
+    void clear();                                    // Drop entries and delete segment files
+    void swap(LogStore& other);                      // Exchange contents and budget
+    void setMemoryBudget(size_t bytes) { budget = bytes; } // 0 = unlimited
+    void setReservedBytes(size_t bytes) { reserved = bytes; } // Budget share used outside the store
+
+    const LogEntry& operator[](size_t index) const {
+        return blocks[index / LOG_BLOCK_SIZE].data[index % LOG_BLOCK_SIZE];
+    }
+    const LogEntry& front() const { return (*this)[0]; }
+    const LogEntry& back() const { return (*this)[count - 1]; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, count); }
+
+    size_t memoryBudget() const { return budget; }
+    size_t residentBytes() const { return residentBlocks * LOG_STORE_BLOCK_BYTES; }
+    size_t sealedBytes() const { return sealedBlocks * LOG_STORE_BLOCK_BYTES; }
+    bool spillError() const { return spillFailed; }
+
+private:
+    struct Block {
+        std::unique_ptr<LogEntry[]> resident;  // Owned records (null once sealed)
+        const LogEntry* data = nullptr;        // Resident records or mapped segment
+        uint64_t spillOffset = 0;              // Position in the segment file once sealed
+    };
+
+    vector<Block> blocks;
+    std::unique_ptr<MappedFile> segment;             // Read-only mapping of all sealed blocks
+    string segmentPath;                              // Segment file to delete on clear()
+    size_t count = 0;
+    size_t budget = 0;
+    size_t reserved = 0;
+    size_t residentBlocks = 0;
+    size_t sealedBlocks = 0;
+    bool spillFailed = false;
+
+    void sealResidentBlocks();
+};
+
+/**
+ * Read-only view of selected entries of a LogStore, by index
+ * Result sets (level filters, searches, queries) are shown, counted and
+ * exported through this instead of copying their LogEntry records, so a
+ * result costs 4 bytes per entry and sealed blocks stay on disk.
+ */
+class EntryView {
+public:
+    class const_iterator {
+    public:
+        const_iterator(const EntryView* view, size_t position) : view(view), position(position) {}
+        const LogEntry& operator*() const { return (*view)[position]; }
+        const LogEntry* operator->() const { return &(*view)[position]; }
+        const_iterator& operator++() { ++position; return *this; }
+        bool operator==(const const_iterator& other) const { return position == other.position; }
+        bool operator!=(const const_iterator& other) const { return position != other.position; }
+    private:
+        const EntryView* view;
+        size_t position;
+    };
+
+    EntryView(const LogStore& store, vector<uint32_t> indices) : store(&store), indices(std::move(indices)) {}
+
+    const LogEntry& operator[](size_t position) const { return (*store)[indices[position]]; }
+    size_t size() const { return indices.size(); }
+    bool empty() const { return indices.empty(); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, indices.size()); }
+
+private:
+    const LogStore* store;
+    vector<uint32_t> indices;                        // Ascending positions in store
+};
+
+/**
+ * Linear-time regular expression matcher (always case-insensitive)
+ *
+ * A pattern is parsed and compiled into a Thompson NFA once per query.
+ * Matching walks a DFA that is built lazily: each DFA state is a set of NFA
+ * states, created the first time some byte leads to it and then cached, so
+ * a warm matcher costs one table lookup per input byte. Nothing backtracks,
+ * so every pattern runs in time linear in the text length.
+ *
+ * Syntax: literals, ., [...] and [^...] classes, \d \w \s \D \W \S,
+ * escaped metacharacters, (...) and (?:...) groups, |, *, +, ?,
+ * {m} {m,} {m,n}, ^ and $. The DFA cache is mutable, so use one matcher
+ * per thread.
+ */
+class RegexMatcher {
+public:
+    bool compile(const string& pattern, string& error); // Parse and build the NFA
+    bool matches(string_view text);                     // true if text contains a match
+    const string& requiredLiteral() const;              // Lowercase text every match contains
+
+private:
+    using CharSet = std::bitset<256>;
+
+    // Parse tree
+    enum NodeType { NODE_CHARS, NODE_CONCAT, NODE_ALTERNATE, NODE_STAR, NODE_PLUS,
+                    NODE_QUESTION, NODE_EMPTY, NODE_BEGIN_LINE, NODE_END_LINE };
+    struct Node {
+        NodeType type;
+        CharSet chars;        // NODE_CHARS only
+        vector<int> children;
+    };
+
+    // Thompson NFA
+    enum StateType { STATE_CHARS, STATE_SPLIT, STATE_BEGIN_LINE, STATE_END_LINE, STATE_MATCH };
+    struct NfaState {
+        StateType type;
+        int out = -1;
+        int out1 = -1;        // Second branch of STATE_SPLIT
+        CharSet chars;        // STATE_CHARS only
+    };
+
+    // Lazily built DFA
+    struct DfaState {
+        uint32_t setOffset;     // Sorted NFA state set: dfaSets[setOffset, setOffset + setSize)
+        uint32_t setSize;
+        uint64_t hash;          // Hash of the set (lookup and table growth)
+        bool accepting;         // Contains STATE_MATCH
+        bool acceptsAtEnd;      // Reaches STATE_MATCH through $ at end of text
+    };
+
+    vector<Node> nodes;
+    vector<NfaState> nfa;
+    int nfaStart = -1;
+    string literal;
+
+    vector<DfaState> dfaStates;
+    vector<int32_t> dfaTransitions;       // dfaStates.size() * 256, -1 = not built yet
+    vector<int> dfaSets;                  // NFA state sets of all DFA states, stored once back to back
+    vector<int32_t> dfaSlots;             // Open-addressing table of DFA states by set hash, -1 = empty
+    int dfaStart = -1;
+
+    // Parser state
+    string pattern;
+    size_t pos = 0;
+    string parseError;
+
+    int addNode(NodeType type, vector<int> children = {});
+    int addChars(const CharSet& chars);
+    int parseAlternation();
+    int parseConcat();
+    int parseRepeat();
+    int parseAtom();
+    bool parseClassEscape(char c, CharSet& chars);
+    bool parseBracket(CharSet& chars);
+    int compileNode(int node, int next);
+    string literalOf(int node) const;
+
+    void closure(vector<int>& states, bool atBeginning) const;
+    void clearDfa();
+    size_t dfaBytes() const;
+    int findDfaState(const vector<int>& states, uint64_t hash) const;
+    int internDfaState(const vector<int>& states);
+    int startDfaState();
+    int buildTransition(int state, unsigned char byte);
+};
+
+/**
+ * Aho-Corasick automaton for case-insensitive multi-pattern matching
+ *
+ * All patterns are merged into one trie whose missing edges are filled in
+ * from the failure links, giving a DFA that finds every pattern in a single
+ * left-to-right pass: one table lookup per byte no matter how many patterns
+ * there are. Bytes are mapped to equivalence classes (each byte that occurs
+ * in some pattern, case-folded, plus one class for everything else) to keep
+ * the transition table small for thousands of patterns.
+ */
+class MultiPatternMatcher {
+public:
+    void build(const vector<string>& patterns);              // Build automaton (patterns lowercased)
+    void findAll(string_view text, vector<uint32_t>& hits) const; // Distinct pattern indices in text
+    size_t stateCount() const;                               // Number of automaton states
+    size_t classCount() const;                               // Number of byte classes
+
+private:
+    std::array<uint8_t, 256> byteClass{};    // Byte -> equivalence class
+    size_t classes = 1;                      // Class 0 = byte occurs in no pattern
+    vector<int32_t> transitions;             // state * classes + class -> state
+    vector<vector<uint32_t>> outputs;        // Patterns ending exactly at a state
+    vector<int32_t> outputLink;              // Nearest proper suffix state with outputs (0 = none)
+};
+
+/**
+ * Composite filter query compiled into a predicate pipeline
+ *
+ * Grammar (keywords are case-insensitive):
+ *   query     := or
+ *   or        := and ('or' and)*
+ *   and       := unary ('and' unary)*
+ *   unary     := 'not' unary | '(' or ')' | condition
+ *   condition := 'level' ('=' | '!=') NAME | 'level' 'in' '(' NAME (',' NAME)* ')'
+ *              | 'ts'   ('>=' | '>' | '<=' | '<' | '=') TIME | 'ts' 'between' TIME 'and' TIME
+ *              | 'time' (same operators) "HH:MM[:SS]"      (time of day)
+ *              | 'msg'  ('~' | '!~') TEXT                    (substring, case-insensitive)
+ *              | 'msg'  '=~' TEXT                            (regex)
+ *
+ * Terms of every 'and' are reordered cheapest first: level id checks, then
+ * timestamp comparisons, then substring tests, then regexes. Top-level time
+ * bounds and substrings also feed the block skip index, so one pass over the
+ * surviving blocks evaluates the whole query. Queries made only of level
+ * terms (and those terms of a top-level 'and') are answered from the
+ * per-level entry bitmaps instead.
+ */
+class EntryBitmap;
+
+class FilterQuery {
+public:
+    bool compile(const string& text, string& error);    // Parse and plan the query
+    bool matches(const LogEntry& entry);                // Evaluate against one entry
+    bool matches(const LogEntry& entry, string_view message); // Same, message text held outside the pool
+    bool blockMayMatch(const LogBlockIndex& block) const; // Skip test for a whole block
+    bool candidates(EntryBitmap& out, bool& exact) const; // Entries allowed by the level terms
+    string describePlan() const;                        // Evaluation order of top-level terms
+    string cacheKey() const;                            // Canonical form of the compiled query
+
+private:
+    enum Op { OP_AND, OP_OR, OP_NOT, OP_LEVEL, OP_TIME, OP_TIME_OF_DAY, OP_CONTAINS, OP_REGEX };
+    struct Node {
+        Op op;
+        vector<int> children;       // OP_AND / OP_OR / OP_NOT
+        vector<uint32_t> levelIds;  // OP_LEVEL: accepted level pool ids
+        vector<string> levelNames;  // OP_LEVEL: names as written (for the plan)
+        int64_t low = INT64_MIN;    // OP_TIME / OP_TIME_OF_DAY: inclusive bounds (time of day
+                                    // wraps past midnight when low > high)
+        int64_t high = INT64_MAX;
+        string needle;              // OP_CONTAINS lowercase text, OP_REGEX pattern
+        std::shared_ptr<RegexMatcher> regex;  // OP_REGEX
+        vector<int8_t> verdicts;    // OP_CONTAINS / OP_REGEX: per message id cache
+        int cost = 0;               // Planning cost class
+    };
+    struct Token {
+        enum Kind { WORD, TEXT, SYMBOL, END } kind;
+        string value;
+    };
+
+    vector<Node> nodes;
+    int root = -1;
+    int64_t blockLow = INT64_MIN;   // Intersection of top-level ts bounds
+    int64_t blockHigh = INT64_MAX;
+    vector<uint64_t> probes;        // Bloom probes of top-level substrings
+
+    vector<Token> tokens;
+    size_t current = 0;
+    string parseError;
+
+    bool tokenize(const string& text);
+    bool accept(const string& word);
+    bool expectSymbol(const string& symbol);
+    int parseOr();
+    int parseAnd();
+    int parseUnary();
+    int parseCondition();
+    int parseComparison(Op op, const string& field);
+    bool readTime(Op op, int64_t& value);
+    int addNode(Op op, vector<int> children = {});
+    void plan(int index);
+    bool evaluate(int index, const LogEntry& entry, const string_view* message);
+    bool levelOnly(int index) const;
+    EntryBitmap levelBitmap(int index) const;
+    string describe(int index) const;
+    string canonical(int index) const;
+};
+
+/**
+ * Sort key for ordering entries by time
+ */
+struct SortKey {
+    uint64_t key;    // Epoch relative to the earliest entry
+    uint32_t index;  // Original position in logs
+};
+
+/**
+ * One side entry of a time join
+ */
+struct JoinEntry {
+    int64_t epoch;                  // Copy of entry->epoch for the sweep
+    const LogEntry* entry;          // Loaded entry, or one parsed from the side B file
+    string_view message;            // Message text (pool, mapped file or the join's scratch pool)
+    uint64_t templateKey;           // Template key of the message
+};
+
+/**
+ * Header of one block in a columnar archive (.lga)
+ * Kept in the archive footer so statistics never need the block itself
+ */
+struct ArchiveBlockInfo {
+    uint64_t offset = 0;            // File offset of the encoded block
+    uint64_t bytes = 0;             // Encoded size
+    uint32_t rows = 0;              // Entries in the block
+    int64_t minEpoch = INT64_MAX;   // Earliest valid timestamp
+    int64_t maxEpoch = INT64_MIN;   // Latest valid timestamp
+    vector<uint64_t> levelCounts;   // Entries per archive level
+};
+
+/**
+ * Footer of a columnar archive: level dictionary plus all block headers
+ */
+struct ArchiveDirectory {
+    vector<string> levels;          // Level names shared by all blocks
+    vector<ArchiveBlockInfo> blocks;
+    int64_t utcOffset = 0;          // --timezone the entries were decoded with (header; 0 before version 2)
+};
+
+/**
+ * Maps messages to template keys (hash of the template text, where every
+ * token containing a digit becomes <*>). Keys are cached per message id,
+ * so each distinct message is tokenized once. Not thread-safe.
+ */
+class TemplateIndex {
+public:
+    uint64_t keyOf(const LogEntry& entry);       // Template key of the entry's message
+    uint64_t keyOf(string_view message);         // Template key of any message text (not cached)
+    void clear();                                // Forget cached keys
+
+private:
+    vector<uint64_t> byMessage;                  // Message pool id -> template key (0 = not computed)
+    string scratch;                              // Reused template buffer
+};
+
+/**
+ * How consecutive repeats are shown in log views and exports
+ */
+enum CollapseMode : uint8_t {
+    COLLAPSE_OFF,                                // Every entry on its own line
+    COLLAPSE_MESSAGES,                           // Runs of identical level + message
+    COLLAPSE_TEMPLATES                           // Runs of identical level + template
+};
+
+/**
+ * A run of consecutive equivalent entries
+ */
+struct CollapsedRun {
+    LogEntry first;                              // First entry (printed)
+    LogEntry last;                               // Last entry (end of the time span)
+    uint64_t count = 0;                          // Entries in the run
+};
+
+/**
+ * Folds consecutive equivalent entries into runs while they are rendered
+ * Each entry is reduced to a 64-bit key (message id, message hash in
+ * low-memory mode, or template key) and compared with the open run's key,
+ * so collapsing adds one comparison per entry and no extra pass.
+ */
+class RunCollapser {
+public:
+    explicit RunCollapser(CollapseMode mode) : mode(mode) {}
+    bool push(const LogEntry& entry, CollapsedRun& finished);  // True when entry closed a run
+    bool flush(CollapsedRun& finished);                        // Close the last run
+
+private:
+    CollapseMode mode;
+    CollapsedRun run;
+    uint64_t runKey = 0;
+
+    uint64_t keyOf(const LogEntry& entry);
+};
+
+/**
+ * Template counts of one file, gathered by the diff tool and the sampling
+ * estimate without loading it
+ */
+struct TemplateProfile {
+    struct Template {
+        uint64_t count = 0;
+        double weight = 0.0;                     // Sum of line weights (sampling estimates)
+        string text;                             // "[LEVEL] template" (stored once per template)
+    };
+    unordered_map<uint64_t, Template> templates; // Template key -> count and text
+    unordered_map<uint32_t, uint64_t> levels;    // Level pool id -> entries
+    unordered_map<uint32_t, double> levelWeights; // Level pool id -> sum of line weights
+    uint64_t entries = 0;
+    double entryWeight = 0.0;                    // Sum of line weights of all entries...
+    double entryWeightSquares = 0.0;             // ...and of their squares (effective sample size)
+    uint64_t skipped = 0;                        // Malformed non-empty lines
+    int64_t minEpoch = INT64_MAX;
+    int64_t maxEpoch = INT64_MIN;
+    bool opened = false;
+
+    double hours() const;                        // Covered time span (at least one minute)
+};
+
+/**
+ * Raw lines drawn from a log file (or stream) for a sampling estimate
+ */
+struct LogSample {
+    vector<string> lines;                        // Sampled lines, without line terminators
+    vector<double> weights;                      // Random offsets: file bytes / line bytes (empty when streamed)
+    bool streamed = false;                       // Reservoir over the whole input (else random offsets)
+    uint64_t fileBytes = 0;                      // Size of the sampled file (random offsets)
+    uint64_t streamLines = 0;                    // Lines seen by the reservoir (exact total)
+    uint64_t bytesRead = 0;                      // Bytes actually read
+    size_t missedProbes = 0;                     // Offsets that yielded no complete line
+    unsigned threads = 1;                        // Parallel readers
+    double elapsedMs = 0.0;
+};
+
+/**
+ * One reconstructed session: consecutive entries carrying the same id with
+ * no inactivity gap longer than the configured limit
+ */
+struct Session {
+    string id;                                   // Extracted id value
+    int64_t start = 0;                           // Epoch of the first entry
+    int64_t end = 0;                             // Epoch of the last entry
+    bool endedInError = false;                   // Last entry has an error-class level
+    vector<uint32_t> entries;                    // Indices into logs, in order
+};
+
+/**
+ * Streaming sessionizer: groups entries by an id field (e.g. "UserID: 4844")
+ * 
+ * Open sessions live in a hash map keyed by the id text and hold compact
+ * lists of entry indices. An entry whose id was last seen more than `gap`
+ * seconds earlier closes that session and opens a new one. Each entry is
+ * handled once on arrival, so the same object can follow a growing file.
+ */
+class Sessionizer {
+public:
+    Sessionizer(string field, int64_t gap) : field(std::move(field)), gap(gap) {}
+    void observe(uint32_t index, const LogEntry& entry); // Add one entry (time order assumed)
+    void finish();                               // Close all open sessions
+    const vector<Session>& sessions() const { return closed; }
+    size_t entriesWithId() const { return withId; }
+
+private:
+    string field;                                // Id field name as typed
+    int64_t gap;                                 // Inactivity gap in seconds
+    unordered_map<string, Session> open;         // Id -> open session
+    vector<Session> closed;
+    size_t withId = 0;
+    string key;                                  // Reused lookup buffer
+
+    void close(Session& session);
+};
+
+/**
+ * One connected query client (shared by the event loop and query workers)
+ */
+struct ServerClient {
+    SOCKET socket = INVALID_SOCKET;
+    string inbox;                                // Received bytes not yet dispatched
+    string outbox;                               // Responses not yet sent (guarded by lock)
+    bool busy = false;                           // A query is running (guarded by lock)
+    bool closing = false;                        // Peer hung up; drop once idle
+    std::mutex lock;
+};
+
+/**
+ * One incident found by the anomaly detector (consecutive flagged windows)
+ */
+struct AnomalyWindow {
+    int64_t start = 0;                           // First second of the incident
+    int64_t end = 0;                             // Last second of the incident
+    uint32_t levelId = 0;                        // Level whose rate spiked
+    uint64_t count = 0;                          // Entries of that level in the incident
+    double expected = 0.0;                       // Baseline entries for the same span
+    double maxZ = 0.0;                           // Highest window z-score
+    vector<std::pair<string, double>> topTemplates; // (template, excess count), largest first
+};
+
+/**
+ * Streaming error-rate anomaly detector
+ *
+ * Entries are counted into fixed time windows. When a window closes, the
+ * count of each level is compared against an EWMA baseline (mean and
+ * variance): a per-hour-of-day baseline once that hour has been seen on
+ * at least two days, otherwise the overall one. Error-class windows with a
+ * high z-score are reported with the templates that exceeded their own
+ * lazily decayed EWMA the most. observe() is O(1) amortized per entry.
+ */
+class AnomalyDetector {
+public:
+    void reset();                                // Drop all state and results
+    void observe(const LogEntry& entry);         // Count one entry (time order assumed)
+    void finish();                               // Close the open window
+    const vector<AnomalyWindow>& anomalies() const { return incidents; }
+    size_t windowCount() const { return windowsClosed; }
+
+private:
+    struct Baseline {
+        double mean = 0.0;
+        double variance = 0.0;
+        size_t samples = 0;
+        int64_t lastDay = INT64_MIN;             // For the seasonal "seen on two days" rule
+        size_t days = 0;
+        void update(double value, double alpha);
+    };
+    struct LevelModel {
+        uint32_t levelId = 0;
+        bool errorClass = false;                 // ERROR, FATAL, CRITICAL, ...
+        uint64_t count = 0;                      // Entries in the open window
+        size_t openIncident = SIZE_MAX;          // Incident this level's last window extended (index into incidents)
+        Baseline overall;
+        Baseline hourly[24];
+    };
+    struct TemplateModel {
+        double ewma = 0.0;                       // Errors per window, decayed lazily
+        int64_t lastWindow = 0;
+    };
+    struct TemplateCount {
+        uint32_t count = 0;
+        LogEntry sample;                         // Any entry with this template (for display)
+    };
+
+    vector<LevelModel> levels;
+    uint32_t lastLevelId = MessagePool::INVALID_ID;
+    size_t lastLevel = 0;
+    unordered_map<uint64_t, TemplateCount> windowTemplates; // Error entries per template (open window)
+    unordered_map<uint64_t, TemplateModel> templateModels;
+    vector<AnomalyWindow> incidents;
+    int64_t window = INT64_MIN;                  // Open window number
+    size_t windowsClosed = 0;
+
+    void closeWindow();
+};
+
+/**
+ * Outcome of a background search
+ */
+struct SearchRun {
+    vector<uint32_t> matches;    // Matching entry indices, in file order
+    bool cancelled = false;      // Stopped early by a keypress
+    size_t completedBlocks = 0;  // Blocks fully searched (or skipped)
+    size_t scannedEntries = 0;   // Entries examined (skipped blocks excluded)
+    size_t scannedBytes = 0;     // Message bytes examined
+    double elapsedMs = 0.0;      // Wall-clock time of the scan
+    bool cached = false;         // Answered from the result cache
+};
+
+/**
+ * Compressed set of entry indices (Roaring-style)
+ * 
+ * Indices are split into 65536-wide chunks by their high 16 bits. A chunk
+ * holding at most 4096 indices stores them as a sorted uint16 array
+ * (2 bytes each); a denser chunk switches to a 8 KB bitmap. Sparse and
+ * dense result sets therefore both cost at most about 2 bytes per match.
+ * Bitmaps combine chunk by chunk with AND / OR / ANDNOT, so filters over
+ * per-level bitmaps never touch the entries themselves.
+ */
+class EntryBitmap {
+public:
+    enum Op : uint8_t { AND, OR, ANDNOT };       // ANDNOT: left and not right
+
+    static EntryBitmap fromSorted(const vector<uint32_t>& indices); // Build from ascending indices
+    static EntryBitmap range(uint32_t count);    // Every index in [0, count)
+    static EntryBitmap combine(const EntryBitmap& left, const EntryBitmap& right, Op op); // Set operation
+    void add(uint32_t index);                    // Append one index (ascending order)
+    void appendSorted(const vector<uint32_t>& indices); // Add indices larger than any present
+    void append(EntryBitmap&& tail);             // Concatenate a bitmap of larger indices
+    void shrink();                               // Release spare array capacity
+    vector<uint32_t> toVector() const;           // Ascending indices
+    template <typename Visit>
+    void forEach(Visit&& visit) const;           // Call visit(index) in ascending order
+    size_t size() const { return cardinality; }  // Number of indices
+    size_t bytes() const;                        // Approximate memory use
+
+private:
+    static constexpr size_t ARRAY_LIMIT = 4096;  // Larger chunks become bitmaps
+    struct Chunk {
+        uint16_t high = 0;                       // Upper 16 bits shared by the chunk
+        uint32_t count = 0;
+        vector<uint16_t> array;                  // Sparse: sorted low bits
+        vector<uint64_t> bits;                   // Dense: 1024 words
+    };
+    vector<Chunk> chunks;                        // Ascending by high
+    size_t cardinality = 0;
+
+    static Chunk combineChunks(const Chunk& left, const Chunk& right, Op op);
+    void pushChunk(Chunk&& chunk);               // Append a non-empty chunk
+};
+
+/**
+ * Index of the lowest set bit of a non-zero 64-bit word
+ */
+static inline unsigned lowestBit64(uint64_t word) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(word));
+#endif
+}
+
+template <typename Visit>
+void EntryBitmap::forEach(Visit&& visit) const {
+    for (const Chunk& chunk : chunks) {
+        uint32_t base = static_cast<uint32_t>(chunk.high) << 16;
+        if (chunk.bits.empty()) {
+            for (uint16_t low : chunk.array) visit(base | low);
+            continue;
+        }
+        for (size_t w = 0; w < chunk.bits.size(); ++w) {
+            uint64_t word = chunk.bits[w];
+            while (word) {
+                visit(base | static_cast<uint32_t>(w * 64 + lowestBit64(word)));
+                word &= word - 1;
+            }
+        }
+    }
+}
+
+/**
+ * Entry bitmap per log level, rebuilt with the block index
+ * 
+ * Level filters and the level terms of composite queries are answered by
+ * combining these bitmaps instead of comparing every entry's level.
+ */
+class LevelBitmaps {
+public:
+    void build();                                // Rebuild from logs
+    void clear();
+    const EntryBitmap* find(uint32_t levelId) const; // nullptr if no entry has the level
+    const EntryBitmap& all() const { return everything; } // Every entry index
+    size_t levelCount() const { return levels.size(); }
+    size_t bytes() const;                        // Approximate memory use
+
+private:
+    vector<std::pair<uint32_t, EntryBitmap>> levels; // Level pool id -> entries
+    EntryBitmap everything;
+};
+
+/**
+ * LRU cache of search and query results, keyed by the normalized query
+ * 
+ * Results are stored as immutable shared EntryBitmaps together with the
+ * number of entries that existed when they were computed, so entries
+ * appended later can be scanned and merged instead of repeating the whole
+ * search. A hit hands out the shared bitmap rather than a copy, and merging
+ * replaces it (readers keep the version they were given). The least
+ * recently used results are evicted above the memory cap. Thread-safe
+ * (the query server shares it between workers).
+ */
+class ResultCache {
+public:
+    explicit ResultCache(size_t capacityBytes) : capacity(capacityBytes) {}
+    bool find(const string& key, vector<uint32_t>& matches, size_t& covered); // Hit: indices and coverage
+    std::shared_ptr<const EntryBitmap> find(const string& key, size_t& covered); // Hit: shared bitmap, else null
+    void store(const string& key, const vector<uint32_t>& matches, size_t covered); // Insert or replace
+    void store(const string& key, std::shared_ptr<const EntryBitmap> matches, size_t covered); // Insert or replace a bitmap
+    void extend(const string& key, const vector<uint32_t>& appended, size_t covered); // Merge appended matches
+    void clear();                                // Drop everything (entries were replaced or reordered)
+    void setCapacity(size_t capacityBytes);      // Change the cap, evicting down to it
+
+    size_t hitCount() const { return hits; }
+    size_t missCount() const { return misses; }
+    size_t evictionCount() const { return evictions; }
+    size_t entryCount() const;
+    size_t memoryBytes() const;
+    size_t capacityBytes() const { return capacity; }
+
+private:
+    struct Slot {
+        string key;
+        std::shared_ptr<const EntryBitmap> matches; // Never modified once stored
+        size_t covered = 0;                      // logs.size() when computed
+    };
+    using SlotList = std::list<Slot>;
+
+    size_t capacity;
+    size_t used = 0;
+    SlotList order;                              // Most recently used first
+    unordered_map<string, SlotList::iterator> slots;
+    std::atomic<size_t> hits{0};
+    std::atomic<size_t> misses{0};
+    std::atomic<size_t> evictions{0};
+    mutable std::mutex lock;
+
+    void evict();
+};
+
+/**
+ * A finished search kept for refinement ("+keyword") and for jumping back
+ * from the search history without searching again
+ */
+struct SearchStep {
+    string chain;                // Search and refinements, e.g. "timeout → db"
+    EntryBitmap matches;         // Matching entry indices
+    size_t historyIndex;         // Position of the search in searchHistory
+};
+
+/**
+ * A search prepared once per query: a plain keyword or a /regex/
+ * Verdicts are cached per pool id, so each distinct message is tested once
+ */
+struct SearchQuery {
+    string text;              // Input as typed (shown in headers and history)
+    bool isRegex = false;     // Input was wrapped in /.../
+    string literal;           // Lowercase keyword, or literal every regex match contains
+    RegexMatcher regex;       // Compiled pattern (regex mode only)
+    vector<uint64_t> probes;  // Bloom probes derived from literal
+    vector<int8_t> verdicts;  // Per pool id: -1 unknown, 0 no match, 1 match
+};
+
+/**
+ * Instrumented phases of load, search, statistics and export
+ */
+enum Phase : uint8_t {
+    PHASE_LOAD_VALIDATE,                         // isValidLogPath()
+    PHASE_LOAD_OPEN,                             // Open and size the file
+    PHASE_LOAD_READ,                             // getline() per line
+    PHASE_LOAD_PARSE,                            // Regex parse + interning per line
+    PHASE_LOAD_STORE,                            // push_back + anomaly counting per line
+    PHASE_INDEX,                                 // Skip index and level bitmaps
+    PHASE_SORT,                                  // Sort by time
+    PHASE_SEARCH,                                // Keyword / regex scans
+    PHASE_QUERY,                                 // Filter query evaluation
+    PHASE_STATISTICS,                            // Statistics views
+    PHASE_EXPORT,                                // Writing export files
+    PHASE_COUNT
+};
+
+/**
+ * Instrumentation counters
+ */
+enum Counter : uint8_t {
+    COUNTER_BYTES_READ,                          // Log file bytes consumed by loads
+    COUNTER_LINES,                               // Lines read
+    COUNTER_PARSED,                              // Lines that became entries
+    COUNTER_SKIPPED,                             // Malformed non-empty lines
+    COUNTER_ALLOCATIONS,                         // operator new calls
+    COUNTER_ENTRIES_SCANNED,                     // Entries examined by searches and queries
+    COUNTER_MATCHES,                             // Entries matched by searches and queries
+    COUNTER_EXPORTED,                            // Entries written by exports
+    COUNTER_COUNT
+};
+
+/**
+ * Runtime-switchable phase timers and counters
+ * 
+ * Totals are atomics so worker threads can report directly. When
+ * instrumentation is off every hook costs one relaxed load and a branch;
+ * the tables are zero-initialized, so allocations made during static
+ * initialization can already be counted safely.
+ */
+class Profiler {
+public:
+    bool enabled() const { return active.load(std::memory_order_relaxed); }
+    void setEnabled(bool value) { active.store(value, std::memory_order_relaxed); }
+    void addTime(Phase phase, uint64_t nanoseconds, uint64_t calls = 1, uint64_t longest = 0); // Record timed calls
+    void count(Counter counter, uint64_t amount = 1) {
+        counters[counter].fetch_add(amount, std::memory_order_relaxed);
+    }
+    void reset();                                // Zero all totals
+    void printReport() const;                    // Table of phases and counters
+    bool writeJson(const string& path, string& error) const; // Machine-readable summary
+
+private:
+    struct PhaseTotals {
+        std::atomic<uint64_t> calls{0};
+        std::atomic<uint64_t> nanoseconds{0};
+        std::atomic<uint64_t> longest{0};        // Longest single call
+    };
+    std::atomic<bool> active{false};
+    std::array<PhaseTotals, PHASE_COUNT> phases;
+    std::array<std::atomic<uint64_t>, COUNTER_COUNT> counters{};
+};
+
+/**
+ * Adds the duration of its scope to a phase (does nothing while instrumentation is off)
+ * and records the scope as a trace span while tracing is on
+ */
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Phase phase);
+    ~ScopedTimer() { stop(); }
+    void stop();                                 // End the measurement before the scope ends
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    Phase phase;
+    bool active;
+    bool traced;                                 // Emitted a begin event
+    std::chrono::steady_clock::time_point start;
+};
+
+/**
+ * Splits a hot loop into phases: each lap() charges the time since the
+ * previous lap to a phase. Totals stay local and are reported once when
+ * the object is destroyed, so per-line timing adds no shared writes.
+ */
+class PhaseLaps {
+public:
+    explicit PhaseLaps(bool active);
+    ~PhaseLaps();
+    void lap(Phase phase);
+
+private:
+    bool active;
+    std::chrono::steady_clock::time_point last;
+    std::array<uint64_t, PHASE_COUNT> nanoseconds{};
+    std::array<uint64_t, PHASE_COUNT> calls{};
+    std::array<uint64_t, PHASE_COUNT> longest{};
+};
+
+/**
+ * One begin ('B') or end ('E') event of a trace span
+ */
+struct TraceEvent {
+    uint64_t nanoseconds;                        // Since recording started
+    const char* name;                            // Static string
+    uint32_t thread;                             // Sequential thread number
+    char type;                                   // 'B' or 'E'
+};
+
+/**
+ * Ring of trace events with a single writer
+ * The writer fills a slot, then publishes it by advancing head (release);
+ * a reader copies the last min(head, TRACE_RING_EVENTS) slots. Recording
+ * never blocks, and a full ring overwrites its oldest events.
+ */
+struct TraceRing {
+    std::unique_ptr<TraceEvent[]> events{new TraceEvent[TRACE_RING_EVENTS]};
+    std::atomic<uint64_t> head{0};               // Events ever written
+};
+
+/**
+ * Optional recorder of begin/end events in Chrome trace-event format
+ * 
+ * Each thread appends to its own ring, claimed on its first event and
+ * returned to a pool when the thread exits. Workers are short-lived, so
+ * reusing rings bounds memory by the peak thread count; the registry lock
+ * is taken only on claim and release, never per event. While recording
+ * is off every hook costs one relaxed load and a branch.
+ */
+class TraceRecorder {
+public:
+    bool enabled() const { return active.load(std::memory_order_relaxed); }
+    void start();                                // Drop old events and begin recording
+    void stop() { active.store(false, std::memory_order_relaxed); }
+    void record(const char* name, char type);    // Append to the calling thread's ring
+    void release(TraceRing* ring);               // Return the ring of an exiting thread
+    bool writeJson(const string& path, size_t& written, size_t& dropped, string& error); // For Perfetto / chrome://tracing
+
+private:
+    std::atomic<bool> active{false};
+    std::atomic<int64_t> epoch{0};               // steady_clock nanoseconds at start()
+    std::atomic<uint32_t> nextThread{1};
+    uint32_t mainThread = 0;                     // Thread that started recording
+    std::mutex registry;                         // Guards rings and idle
+    vector<std::unique_ptr<TraceRing>> rings;
+    vector<TraceRing*> idle;                     // Rings of threads that have exited
+};
+
+/**
+ * Records its scope as a named span on the calling thread (while tracing is on)
+ */
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name);
+    ~TraceSpan();
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* name;                            // nullptr while tracing is off
+};
+
+/**
+ * Subsystems that heap allocations are attributed to
+ */
+enum MemoryTag : uint8_t {
+    MEMORY_OTHER,                                // Menus, views and anything untagged
+    MEMORY_LOADER,                               // Parsing, entry store, string pool, anomaly model
+    MEMORY_INDEX,                                // Skip index, level bitmaps, template index
+    MEMORY_CACHE,                                // Result cache and recent search results
+    MEMORY_QUERY,                                // Search, query and statistics working sets
+    MEMORY_TAG_COUNT
+};
+
+/**
+ * Live heap bytes per subsystem, kept by the replaced operator new/delete
+ * 
+ * Every allocation carries a small header with its size and tag, so a
+ * free is charged to the subsystem that allocated the block even when
+ * another one releases it. Totals are relaxed atomics on separate cache
+ * lines and constant-initialized, like the Profiler's. Counting follows
+ * the instrumentation switch; blocks allocated while it is off are never
+ * charged. Headers need a statically linked C++ runtime (see
+ * allocationHeaders()); without one the tracker stays off.
+ */
+class MemoryTracker {
+public:
+    bool enabled() const { return active.load(std::memory_order_relaxed); }
+    void setEnabled(bool value);                 // Ignored without allocation headers
+    void allocated(MemoryTag tag, size_t bytes);
+    void released(MemoryTag tag, size_t bytes) {
+        totals[tag].live.fetch_sub(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+    }
+    size_t liveBytes(MemoryTag tag) const { return static_cast<size_t>(std::max<int64_t>(0, totals[tag].live.load())); }
+    size_t peakBytes(MemoryTag tag) const { return static_cast<size_t>(totals[tag].peak.load()); }
+    uint64_t allocations(MemoryTag tag) const { return totals[tag].allocations.load(); }
+
+private:
+    struct alignas(64) Totals {
+        std::atomic<int64_t> live{0};
+        std::atomic<int64_t> peak{0};
+        std::atomic<uint64_t> allocations{0};
+    };
+    std::atomic<bool> active{false};
+    std::array<Totals, MEMORY_TAG_COUNT> totals;
+};
+
+/**
+ * Attributes the calling thread's allocations to a subsystem for its scope
+ * (scopes nest; worker threads start untagged unless they open their own)
+ */
+class MemoryScope {
+public:
+    explicit MemoryScope(MemoryTag tag);
+    ~MemoryScope();
+    static MemoryTag current();                  // Tag of the calling thread
+    MemoryScope(const MemoryScope&) = delete;
+    MemoryScope& operator=(const MemoryScope&) = delete;
+
+private:
+    MemoryTag previous;
 };
 
 // ═══════════════════════════════════════════════════════════════════════════
 // GLOBAL VARIABLES
 // ═══════════════════════════════════════════════════════════════════════════
 
-vector<LogEntry> logs;              // Stores all loaded log entries
+LogStore logs;                      // Stores all loaded log entries
 vector<string> searchHistory;       // Tracks user search queries
+std::deque<SearchStep> searchSteps; // Result sets of recent searches (refinement levels)
+size_t currentStep = SIZE_MAX;      // Step that "+keyword" refines (index into searchSteps)
+MessagePool messagePool;            // Interned timestamp, level and message strings
+MappedFile sourceFile;              // Source log mapping (low-memory mode only)
+bool lowMemoryMode = false;         // --low-memory: leave message text in the file
+vector<LogBlockIndex> blockIndex;   // Per-block skip index over logs
+TemplateIndex templateIndex;        // Message -> template cache
+AnomalyDetector anomalyDetector;    // Error-rate model built while loading
+CollapseMode collapseMode = COLLAPSE_OFF;  // --collapse: fold repeated lines in views and exports
+ResultCache resultCache(RESULT_CACHE_BYTES); // Recent search/query results as bitmaps
+LevelBitmaps levelBitmaps;          // Entries per level, rebuilt with blockIndex
+Profiler profiler;                  // Phase timers and counters (off unless enabled)
+string profileOutput;               // --profile: JSON summary written at exit
+TraceRecorder tracer;               // Begin/end events per thread (off unless enabled)
+string traceOutput;                 // --trace: Chrome trace file written when recording stops
+MemoryTracker memoryTracker;        // Live heap bytes per subsystem
+int64_t logUtcOffset = 0;           // --timezone: seconds east of UTC of log timestamps (0 = UTC)
 
 // ───────────────────────────────────────────────────────────────────────────
 // Regular Expression Patterns for Log Parsing
@@ -138,50 +1371,168 @@ void displayMenu();                                            // Display main m
 // Core Log Management Functions
 // ───────────────────────────────────────────────────────────────────────────
 void loadLogFile();                                            // Load and parse log file
+bool loadLogPath(const string& filename);                      // Load a file without prompting
 void viewLogs(const string& filter = "");                      // Display logs with optional filter
 void searchLogs();                                             // Search logs by keyword
 void showStatistics();                                         // Display visual statistics
+template <typename Entries>
+void showEntryStatistics(const Entries& entries, const string& title); // Statistics for any entries
 void viewSearchHistory();                                      // Show search history
 void viewLogsByTimeRange();                                    // Filter logs by date/time range
+void multiPatternSearch();                                     // Search many patterns in one pass
+void queryLogs();                                              // Run a composite filter query
+void advancedMenu();                                           // Display advanced tools menu
 
 // ───────────────────────────────────────────────────────────────────────────
 // Export Functions
 // ───────────────────────────────────────────────────────────────────────────
-void exportLogs(const vector<LogEntry>& entries, const string& description); // Export logs to file
+template <typename Entries>
+void exportLogs(const Entries& entries, const string& description); // Export logs to file
+template <typename Entries>
+bool writeExportFile(const Entries& entries, const string& description, const string& path); // Header, stats, lines
 void exportMenu();                                             // Display export menu
-vector<LogEntry> getFilteredLogs(const string& filter);        // Get logs by level filter
+EntryView getFilteredLogs(const string& filter);               // View of logs by level filter
 
 // ───────────────────────────────────────────────────────────────────────────
 // Utility Functions
 // ───────────────────────────────────────────────────────────────────────────
 bool logsEmpty();                                              // Check if logs vector is empty
-string getLevelColor(const string& level);                     // Get ANSI color for log level
+string getLevelColor(string_view level);                       // Get ANSI color for log level
 string toLowerStr(const string& str);                          // Convert string to lowercase
-bool caseInsensitiveSearch(const string& text, const string& keyword); // Case-insensitive search
-bool parseLogLine(const string& line, LogEntry& entry);        // Parse log line to LogEntry
+bool caseInsensitiveSearch(string_view text, const string& keyword); // Case-insensitive search
+bool isErrorLevel(string_view level);                          // ERROR, FATAL, CRITICAL or SEVERE
+bool parseLogLine(const string& line, LogEntry& entry, bool internMessage = true); // Parse log line to LogEntry
 bool isValidLogPath(const string& filename);                   // Validate file path security
+bool parseByteSize(const string& text, size_t& bytes);         // Parse sizes like 512M or 2G
+size_t budgetReservedBytes(size_t entries);                    // --max-memory share outside the entry store
+string formatBytes(size_t bytes);                              // Human-readable byte count
+string_view entryLevel(const LogEntry& entry);                 // Level text of an entry
+string_view entryMessage(const LogEntry& entry);               // Message text of an entry
+string entryTimestamp(const LogEntry& entry);                  // Timestamp text of an entry
+void printLogEntry(const LogEntry& entry);                     // Print one colored log line
+void printLogEntry(const LogEntry& entry, string_view message); // Same, with the message supplied
+void viewEntriesPaginated(const EntryView& entries, const string& title, int pageSize = 20); // Paged viewer
+uint64_t hashBytes(const char* data, size_t length);           // Fast 64-bit string hash
+int64_t timestampToEpoch(const string& timestamp);             // Normalize any format to epoch
+bool parseUtcOffset(const string& text, int64_t& offset);      // utc, local or +HH:MM / -HH:MM
+string formatUtcOffset(int64_t offset);                        // Seconds east of UTC as +HH:MM
+string formatEpoch(int64_t epoch, TimestampFormat format);     // Print epoch in a log format
 
-// ═══════════════════════════════════════════════════════════════════════════
-// IMPLEMENTATION: CONSOLE SETUP
-// ═══════════════════════════════════════════════════════════════════════════
+// ───────────────────────────────────────────────────────────────────────────
+// Block Skip Index Functions
+// ───────────────────────────────────────────────────────────────────────────
+void buildBlockIndex();                                        // Rebuild index for all logs
+vector<uint64_t> bloomProbes(const string& keyword);           // Trigram hashes for a keyword
+bool blockMayContain(const LogBlockIndex& block, const vector<uint64_t>& probes); // Bloom test
+bool blockOverlapsRange(const LogBlockIndex& block, int64_t start, int64_t end);  // Time test
+EntryBitmap scanFilterQuery(FilterQuery& query, size_t& skippedBlocks, size_t& candidateCount,
+                            size_t& evaluatedCount);            // Bitmaps + blocks
 
-/**
- * Configure Windows console to support UTF-8 and ANSI escape sequences
- * Required for displaying colors and special characters correctly
- */
-void setupConsole() {
-    SetConsoleOutputCP(CP_UTF8);  // Set output code page to UTF-8
-    SetConsoleCP(CP_UTF8);        // Set input code page to UTF-8
-    
-    // Enable ANSI escape sequence processing (Windows 10+)
-    HANDLE hOut = GetStdHandle(STD_OUTPUT_HANDLE);
-    DWORD dwMode = 0;
-    GetConsoleMode(hOut, &dwMode);
-    dwMode |= ENABLE_VIRTUAL_TERMINAL_PROCESSING;
-    SetConsoleMode(hOut, dwMode);
-}
+// ───────────────────────────────────────────────────────────────────────────
+// Search Query Functions
+// ───────────────────────────────────────────────────────────────────────────
+bool containsIgnoreCase(string_view text, string_view lowerNeedle); // SIMD substring kernel
+bool compileSearchQuery(const string& input, SearchQuery& query, string& error); // Keyword, /regex/ or \keyword
+bool searchMatches(SearchQuery& query, const LogEntry& entry); // Test entry against query
+SearchRun runBackgroundSearch(const SearchQuery& query, size_t streamLimit); // Parallel, cancellable scan
+void printSearchSummary(const SearchRun& run);                 // Match count, time and throughput
 
-// ═══════════════════════════════════════════════════════════════════════════
+// ───────────────────────────────────────────────────────────────────────────
+// Time Sort Functions
+// ───────────────────────────────────────────────────────────────────────────
+void radixSortKeys(vector<SortKey>& keys);                     // Stable parallel LSD radix sort
+bool externalSortKeys(vector<SortKey>& keys, size_t runCapacity, string& error); // Spill + k-way merge
+void sortLogsByTime();                                         // Reorder logs by timestamp
+
+// ───────────────────────────────────────────────────────────────────────────
+// Archive Functions
+// ───────────────────────────────────────────────────────────────────────────
+bool writeArchive(const string& path, size_t& textBytes, string& error); // Write logs as .lga
+bool readArchiveDirectory(const string& path, ArchiveDirectory& directory, string& error); // Footer only
+void saveArchive();                                            // Prompt and write an archive
+void showArchiveSummary();                                     // Statistics from block headers
+void loadArchive();                                            // Decode blocks that can match
+void archiveMenu();                                            // Display archive menu
+
+// ───────────────────────────────────────────────────────────────────────────
+// Template and Anomaly Functions
+// ───────────────────────────────────────────────────────────────────────────
+string messageTemplate(string_view message);                   // Replace variable tokens with <*>
+void appendTemplate(string_view message, string& result);      // Same, into an existing buffer
+void writeCollapsedRun(std::ostream& out, const CollapsedRun& run, bool color); // One line per run
+void toggleCollapseMode();                                     // Cycle off/messages/templates
+const char* collapseModeName(CollapseMode mode);               // Display name of a mode
+bool addProfileLine(TemplateProfile& profile, const string& line, string& text, double weight = 1.0); // Count one raw line
+void buildTemplateProfile(const string& filename, TemplateProfile& profile); // Stream file into template counts
+void compareLogFiles();                                        // Template diff of two files
+template <typename Emit>
+void temporalJoin(const vector<JoinEntry>& leading, const vector<JoinEntry>& trailing, int64_t window, Emit&& emit); // Sort-merge time join
+void correlateSources();                                       // A within N seconds before B
+bool extractField(string_view message, string_view field, string_view& value); // "Field: value" lookup
+void showSessions();                                           // Sessions by id field
+void showAnomalyReport();                                      // Incidents found while loading
+
+// ───────────────────────────────────────────────────────────────────────────
+// Sampling Functions
+// ───────────────────────────────────────────────────────────────────────────
+bool sampleByOffsets(const string& path, size_t sampleSize, LogSample& sample, string& error); // Parallel positional reads
+void sampleByReservoir(std::istream& input, size_t sampleSize, LogSample& sample); // One pass, uniform lines
+void showSampleEstimate(const LogSample& sample, const string& source); // Levels and templates with 95% CIs
+bool sampleLogSource(const string& path, size_t sampleSize);  // Pick a method, sample and report
+void sampleLogFile();                                          // Prompt for a file and sample it
+
+// ───────────────────────────────────────────────────────────────────────────
+// Instrumentation Functions
+// ───────────────────────────────────────────────────────────────────────────
+void instrumentationMenu();                                    // Toggle, report, JSON, reset, trace, memory
+void writeProfileAtExit();                                     // --profile summary (atexit)
+void startTracing(const string& path);                         // Begin recording a trace
+bool finishTracing();                                          // Stop recording and write the trace
+void writeTraceAtExit();                                       // --trace file (atexit)
+void printMemorySummary();                                     // RSS, per-entry cost, largest consumers
+void showMemoryReport();                                       // Full component and subsystem tables
+
+// ───────────────────────────────────────────────────────────────────────────
+// Benchmark Functions
+// ───────────────────────────────────────────────────────────────────────────
+bool runBenchmark(const string& path, unsigned warmup, unsigned runs); // Time load..export, print percentiles
+
+// ───────────────────────────────────────────────────────────────────────────
+// Query Server Functions
+// ───────────────────────────────────────────────────────────────────────────
+string answerServerQuery(const string& request);               // Evaluate one client request
+bool runQueryServer(const string& socketPath);                 // Event loop + query workers
+bool runQueryClient(const string& socketPath);                 // Interactive thin client
+
+// ───────────────────────────────────────────────────────────────────────────
+// Result Cache Functions
+// ───────────────────────────────────────────────────────────────────────────
+string resultCacheKey(const SearchQuery& query);               // Cache key of a compiled search
+SearchRun cachedSearch(SearchQuery& query, size_t streamLimit); // Search via the result cache
+SearchRun refineSearch(SearchQuery& query, const vector<uint32_t>& candidates, size_t streamLimit); // Search within results
+void recordSearchStep(const string& chain, const vector<uint32_t>& matches, bool makeCurrent); // Keep a result set
+
+// ═══════════════════════════════════════════════════════════════════════════
+// IMPLEMENTATION: CONSOLE SETUP
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Configure Windows console to support UTF-8 and ANSI escape sequences
+ * Required for displaying colors and special characters correctly
+ */
+void setupConsole() {
+    SetConsoleOutputCP(CP_UTF8);  // Set output code page to UTF-8
+    SetConsoleCP(CP_UTF8);        // Set input code page to UTF-8
+    
+    // Enable ANSI escape sequence processing (Windows 10+)
+    HANDLE hOut = GetStdHandle(STD_OUTPUT_HANDLE);
+    DWORD dwMode = 0;
+    GetConsoleMode(hOut, &dwMode);
+    dwMode |= ENABLE_VIRTUAL_TERMINAL_PROCESSING;
+    SetConsoleMode(hOut, dwMode);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
 // IMPLEMENTATION: GRADIENT COLOR GENERATOR
 // ═══════════════════════════════════════════════════════════════════════════
 
@@ -262,10 +1613,11 @@ void displayMenu() {
     cout << "  " << CYAN << "║" << RESET << "  " << BLUE   << "3."  << RESET << " View INFO Logs           " << BRIGHT_MAGENTA << "9."  << RESET << " Export Filtered Logs " << CYAN << "║" << RESET << "\n";
     cout << "  " << CYAN << "║" << RESET << "  " << YELLOW << "4."  << RESET << " View WARN Logs           " << BRIGHT_BLUE    << "10." << RESET << " View Logs by Time    " << CYAN << "║" << RESET << "\n";
     cout << "  " << CYAN << "║" << RESET << "  " << RED    << "5."  << RESET << " View ERROR Logs          " << BRIGHT_RED     << "11." << RESET << " Search & Export      " << CYAN << "║" << RESET << "\n";
-    cout << "  " << CYAN << "║" << RESET << "  " << BLUE   << "6."  << RESET << " Search Logs              " << BRIGHT_GREEN   << "12." << RESET << " Exit                 " << CYAN << "║" << RESET << "\n";
+    cout << "  " << CYAN << "║" << RESET << "  " << BLUE   << "6."  << RESET << " Search Logs              " << BRIGHT_YELLOW  << "12." << RESET << " Advanced Tools       " << CYAN << "║" << RESET << "\n";
+    cout << "  " << CYAN << "║" << RESET << "                              "                               << BRIGHT_GREEN   << "13." << RESET << " Exit                 " << CYAN << "║" << RESET << "\n";
     cout << "  " << CYAN << "║" << RESET << "                                                      " << CYAN << "║" << RESET << "\n";
     cout << "  " << CYAN << "╚══════════════════════════════════════════════════════╝" << RESET << "\n";
-    cout << "\n  " << BRIGHT_CYAN << "Select an option (1-12): " << RESET;
+    cout << "\n  " << BRIGHT_CYAN << "Select an option (1-13): " << RESET;
 }
 
 // ═══════════════════════════════════════════════════════════════════════════
@@ -291,7 +1643,7 @@ bool logsEmpty() {
  * @param level Log level string (INFO, WARN, ERROR)
  * @return      ANSI color code string
  */
-string getLevelColor(const string& level) {
+string getLevelColor(string_view level) {
     if (level == "INFO") return GREEN;
     if (level == "WARN") return YELLOW;
     if (level == "ERROR") return RED;
@@ -326,26 +1678,107 @@ string toLowerStr(const string& str) {
  * @param keyword Keyword to search for
  * @return        true if keyword found (case-insensitive), false otherwise
  */
-bool caseInsensitiveSearch(const string& text, const string& keyword) {
-    string lowerText = toLowerStr(text);
-    string lowerKeyword = toLowerStr(keyword);
-    return lowerText.find(lowerKeyword) != string::npos;
+bool caseInsensitiveSearch(string_view text, const string& keyword) {
+    return containsIgnoreCase(text, toLowerStr(keyword));
+}
+
+/**
+ * Check whether a level counts as an error (any case)
+ * 
+ * @param level Level text
+ * @return      true for ERROR, FATAL, CRITICAL and SEVERE
+ */
+bool isErrorLevel(string_view level) {
+    string name = toLowerStr(string(level));
+    return name == "error" || name == "fatal" || name == "critical" || name == "severe";
 }
 
 /**
  * Filter logs by level
  * 
  * @param filter Log level to filter by (empty string returns all logs)
- * @return       Vector of filtered log entries
+ * @return       View of the matching entries
  */
-vector<LogEntry> getFilteredLogs(const string& filter) {
-    vector<LogEntry> filtered;
-    for(const auto& entry : logs) {
-        if(filter.empty() || entry.level == filter) {
-            filtered.push_back(entry);
-        }
+EntryView getFilteredLogs(const string& filter) {
+    if (filter.empty()) return EntryView(logs, EntryBitmap::range(static_cast<uint32_t>(logs.size())).toVector());
+
+    // Only the level's bitmap is read, no entry is touched
+    const EntryBitmap* level = levelBitmaps.find(messagePool.find(filter));
+    return EntryView(logs, level == nullptr ? vector<uint32_t>() : level->toVector());
+}
+
+/**
+ * Level text of a log entry, resolved through the message pool
+ * 
+ * @param entry Log entry
+ * @return      View of the level string (valid until the pool is cleared)
+ */
+string_view entryLevel(const LogEntry& entry) {
+    return messagePool.view(entry.levelId);
+}
+
+/**
+ * Message text of a log entry, resolved through the message pool
+ * or, in low-memory mode, read from the mapped source file
+ * 
+ * @param entry Log entry
+ * @return      View of the message string (valid until the next load)
+ */
+string_view entryMessage(const LogEntry& entry) {
+    if (entry.messageId == LogEntry::LAZY_MESSAGE) return sourceFile.view(entry.offset, entry.length);
+    return messagePool.view(entry.messageId);
+}
+
+/**
+ * Timestamp text of a log entry exactly as written in the file
+ * 
+ * @param entry Log entry
+ * @return      Timestamp string
+ */
+string entryTimestamp(const LogEntry& entry) {
+    if (entry.format == TIMESTAMP_RAW) return string(messagePool.view(entry.timestampId));
+    return formatEpoch(entry.epoch, static_cast<TimestampFormat>(entry.format));
+}
+
+/**
+ * Print one log entry as a colored console line
+ * 
+ * @param entry Log entry to print
+ */
+void printLogEntry(const LogEntry& entry) {
+    printLogEntry(entry, entryMessage(entry));
+}
+
+/**
+ * Print one log entry whose message text is held by the caller
+ * 
+ * @param entry   Log entry to print (timestamp, level)
+ * @param message Message text
+ */
+void printLogEntry(const LogEntry& entry, string_view message) {
+    string levelColor = getLevelColor(entryLevel(entry));
+    cout << "  " << CYAN << entryTimestamp(entry) << RESET 
+         << " [" << levelColor << entryLevel(entry) << RESET << "] " 
+         << message << "\n";
+}
+
+/**
+ * Format a byte count with a binary unit suffix (B, KB, MB, GB)
+ * 
+ * @param bytes Number of bytes
+ * @return      Formatted string such as "12.4 MB"
+ */
+string formatBytes(size_t bytes) {
+    const char* units[] = {"B", "KB", "MB", "GB", "TB"};
+    double value = static_cast<double>(bytes);
+    int unit = 0;
+    while (value >= 1024.0 && unit < 4) {
+        value /= 1024.0;
+        unit++;
     }
-    return filtered;
+    ostringstream oss;
+    oss << fixed << setprecision(unit == 0 ? 0 : 1) << value << " " << units[unit];
+    return oss.str();
 }
 
 /**
@@ -397,551 +1830,7771 @@ bool isValidLogPath(const string& filename) {
 }
 
 // ═══════════════════════════════════════════════════════════════════════════
-// IMPLEMENTATION: LOAD LOG FILE
+// IMPLEMENTATION: MESSAGE INTERNING ARENA
 // ═══════════════════════════════════════════════════════════════════════════
 
 /**
- * Load and parse a log file
+ * 64x64 -> 128 bit multiply folded back to 64 bits (wyhash "mum" step)
+ */
+static inline uint64_t wyMix(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+    __uint128_t product = static_cast<__uint128_t>(a) * b;
+    return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+#else
+    // Portable fallback: split into 32-bit halves
+    uint64_t aLo = a & 0xFFFFFFFFu, aHi = a >> 32;
+    uint64_t bLo = b & 0xFFFFFFFFu, bHi = b >> 32;
+    uint64_t lolo = aLo * bLo, lohi = aLo * bHi, hilo = aHi * bLo, hihi = aHi * bHi;
+    uint64_t mid = (lolo >> 32) + (lohi & 0xFFFFFFFFu) + (hilo & 0xFFFFFFFFu);
+    uint64_t lo = (lolo & 0xFFFFFFFFu) | (mid << 32);
+    uint64_t hi = hihi + (lohi >> 32) + (hilo >> 32) + (mid >> 32);
+    return lo ^ hi;
+#endif
+}
+
+/**
+ * Hash a byte range with a wyhash-style function
+ * Consumes 8 bytes per step, so hashing a typical log message takes a few
+ * multiplies instead of one operation per character
  * 
- * Features:
- * - Supports 3 different log formats via regex parsing
- * - Security validation to prevent path traversal
- * - Reports number of loaded and skipped entries
- * - Clears existing logs before loading new file
+ * @param data   Pointer to the bytes
+ * @param length Number of bytes
+ * @return       64-bit hash value
  */
-void loadLogFile() {
-    string filename;
-    cout << "\n  " << GREEN << "Enter log file name: " << RESET;
-    cin.ignore(numeric_limits<streamsize>::max(), '\n');
-    getline(cin, filename);
+uint64_t hashBytes(const char* data, size_t length) {
+    constexpr uint64_t P0 = 0xa0761d6478bd642full;
+    constexpr uint64_t P1 = 0xe7037ed1a0b428dbull;
+    constexpr uint64_t P2 = 0x8ebc6af09c88c6e3ull;
+
+    uint64_t seed = P0 ^ length;
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        seed = wyMix(word ^ P1, seed ^ P2);
+    }
 
-    // Validate empty input
-    if (filename.empty()) {
-        cerr << RED << "  ✗ No filename provided.\n" << RESET;
-        return;
+    // Tail: up to 7 remaining bytes packed into one word
+    uint64_t tail = 0;
+    if (i < length) std::memcpy(&tail, data + i, length - i);
+    return wyMix(seed ^ tail ^ P1, length ^ P2);
+}
+
+size_t StringViewHash::operator()(string_view text) const {
+    return static_cast<size_t>(hashBytes(text.data(), text.size()));
+}
+
+/**
+ * Copy text into the shard's arena, starting a new chunk when the current
+ * one is full. Chunk sizes double from 4 KB up to 1 MiB so small files stay
+ * small; strings larger than a chunk get a dedicated allocation.
+ * Caller must hold the shard lock.
+ */
+const char* MessagePool::copyToArena(Shard& shard, string_view text) {
+    if (text.size() > MESSAGE_ARENA_MAX_CHUNK) {
+        // Oversized string: dedicated allocation placed before the active chunk
+        std::unique_ptr<char[]> block(new char[text.size()]);
+        std::memcpy(block.get(), text.data(), text.size());
+        const char* stored = block.get();
+        auto pos = shard.chunks.empty() ? shard.chunks.end() : shard.chunks.end() - 1;
+        shard.chunks.insert(pos, std::move(block));
+        shard.arenaBytes += text.size();
+        return stored;
     }
 
-    // Warn about missing .log extension
-    if (filename.find(".log") == string::npos) {
-        cout << YELLOW << "  ⚠ Warning: File doesn't have .log extension\n" << RESET;
+    if (shard.chunks.empty() || shard.chunkUsed + text.size() > shard.chunkCapacity) {
+        size_t nextSize = std::max(MESSAGE_ARENA_MIN_CHUNK, shard.chunkCapacity * 2);
+        shard.chunkCapacity = std::min(MESSAGE_ARENA_MAX_CHUNK, std::max(nextSize, text.size()));
+        shard.chunks.emplace_back(new char[shard.chunkCapacity]);
+        shard.arenaBytes += shard.chunkCapacity;
+        shard.chunkUsed = 0;
     }
 
-    // Security: Validate file path to prevent directory traversal
-    if (!isValidLogPath(filename)) {
-        cerr << RED << "  ✗ Invalid or unauthorized file path.\n" << RESET;
-        return;
+    char* dest = shard.chunks.back().get() + shard.chunkUsed;
+    std::memcpy(dest, text.data(), text.size());
+    shard.chunkUsed += text.size();
+    return dest;
+}
+
+/**
+ * Intern a string: return the id of an identical stored string, or copy it
+ * into the arena and assign a new id. Safe to call from multiple threads.
+ * 
+ * @param text Text to intern
+ * @return     Stable 32-bit id for the text
+ */
+uint32_t MessagePool::intern(string_view text) {
+    uint64_t hash = hashBytes(text.data(), text.size());
+    unsigned shardIndex = static_cast<unsigned>(hash >> 60) & (MESSAGE_POOL_SHARDS - 1);
+    Shard& shard = shards[shardIndex];
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.internCalls++;
+    shard.rawBytes += text.size();
+
+    auto it = shard.index.find(text);
+    if (it != shard.index.end()) {
+        return (it->second << MESSAGE_POOL_SHARD_BITS) | shardIndex;
     }
 
-    // Attempt to open file
-    ifstream file(filename);
-    if (!file.is_open()) {
-        cerr << RED << "  ✗ Could not open file: " << filename << RESET << "\n";
-        return;
+    const char* stored = copyToArena(shard, text);
+    uint32_t localId = static_cast<uint32_t>(shard.strings.size());
+    string_view storedView(stored, text.size());
+    shard.strings.push_back(storedView);
+    shard.index.emplace(storedView, localId);
+    shard.uniqueBytes += text.size();
+
+    return (localId << MESSAGE_POOL_SHARD_BITS) | shardIndex;
+}
+
+/**
+ * Look up a string without inserting it
+ * 
+ * @param text Text to look up
+ * @return     Id of the stored text, or INVALID_ID if it was never interned
+ */
+uint32_t MessagePool::find(string_view text) const {
+    uint64_t hash = hashBytes(text.data(), text.size());
+    unsigned shardIndex = static_cast<unsigned>(hash >> 60) & (MESSAGE_POOL_SHARDS - 1);
+    const Shard& shard = shards[shardIndex];
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(text);
+    if (it == shard.index.end()) return INVALID_ID;
+    return (it->second << MESSAGE_POOL_SHARD_BITS) | shardIndex;
+}
+
+/**
+ * Resolve an id to its text. Lock-free: ids are only handed out after their
+ * text is stored, and readers run once loading has finished.
+ */
+string_view MessagePool::view(uint32_t id) const {
+    const Shard& shard = shards[id & (MESSAGE_POOL_SHARDS - 1)];
+    return shard.strings[id >> MESSAGE_POOL_SHARD_BITS];
+}
+
+/**
+ * Release every stored string; all previously returned ids become invalid
+ */
+void MessagePool::clear() {
+    for (auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        decltype(shard.index)().swap(shard.index);     // swap() releases capacity too
+        decltype(shard.strings)().swap(shard.strings);
+        decltype(shard.chunks)().swap(shard.chunks);
+        shard.chunkUsed = 0;
+        shard.chunkCapacity = 0;
+        shard.internCalls = 0;
+        shard.rawBytes = 0;
+        shard.uniqueBytes = 0;
+        shard.arenaBytes = 0;
     }
+}
 
-    // Check file size and warn if large
-    file.seekg(0, std::ios::end);
-    size_t fileSize = file.tellg();
-    file.seekg(0, std::ios::beg);
+size_t MessagePool::distinctCount() const {
+    size_t total = 0;
+    for (const auto& shard : shards) total += shard.strings.size();
+    return total;
+}
 
-    if(fileSize > 10 * 1024 * 1024) {  // 10MB threshold
-        double sizeMB = fileSize / (1024.0 * 1024.0);
-        cout << YELLOW << "  ⚠ Large file detected (" 
-             << fixed << setprecision(1) << sizeMB 
-             << "MB). Loading may take time...\n" << RESET;
+size_t MessagePool::idLimit() const {
+    size_t largestShard = 0;
+    for (const auto& shard : shards) largestShard = std::max(largestShard, shard.strings.size());
+    return largestShard << MESSAGE_POOL_SHARD_BITS;
+}
+
+size_t MessagePool::internCount() const {
+    size_t total = 0;
+    for (const auto& shard : shards) total += shard.internCalls;
+    return total;
+}
+
+size_t MessagePool::rawBytes() const {
+    size_t total = 0;
+    for (const auto& shard : shards) total += shard.rawBytes;
+    return total;
+}
+
+size_t MessagePool::uniqueBytes() const {
+    size_t total = 0;
+    for (const auto& shard : shards) total += shard.uniqueBytes;
+    return total;
+}
+
+size_t MessagePool::arenaBytes() const {
+    size_t total = 0;
+    for (const auto& shard : shards) total += shard.arenaBytes;
+    return total;
+}
+
+size_t MessagePool::indexBytes() const {
+    size_t total = 0;
+    for (const auto& shard : shards) {
+        // Buckets plus one node (key, value, next pointer, cached hash) per entry
+        total += shard.index.bucket_count() * sizeof(void*);
+        total += shard.index.size() * (sizeof(string_view) + sizeof(uint32_t) + 2 * sizeof(void*));
+        total += shard.strings.capacity() * sizeof(string_view);
     }
+    return total;
+}
 
-    // Clear existing logs and prepare for new data
-    logs.clear();
-    logs.shrink_to_fit();
-    logs.reserve(1000);  // Pre-allocate for performance
-    
-    string line;
-    smatch match;
-    int skipped = 0;
+// ═══════════════════════════════════════════════════════════════════════════
+// IMPLEMENTATION: MAPPED SOURCE FILE
+// ═══════════════════════════════════════════════════════════════════════════
 
-    // Parse each line of the file
-    while(getline(file, line)) {
-        LogEntry entry;
-        if(parseLogLine(line, entry)) {
-            logs.push_back(entry);
-        } else if(!line.empty()) {
-            skipped++;  // Count malformed non-empty lines
-        }
+MappedFile::~MappedFile() {
+    close();
+}
+
+/**
+ * Map a file read-only into the address space
+ * Pages are only read from disk when a view touches them
+ * 
+ * @param path File to map
+ * @return     true if the whole file is mapped
+ */
+bool MappedFile::open(const string& path) {
+    close();
+
+    // Writers are allowed: the entry store appends to a segment file while it is mapped
+    file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                       OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        close();
+        return false;
     }
+    size = static_cast<uint64_t>(fileSize.QuadPart);
 
-    file.close();
-    
-    // Report results
-    cout << GREEN << "  ✓ Loaded " << logs.size() << " log entries.\n" << RESET;
-    if (skipped > 0) {
-        cout << YELLOW << "  ⚠ Skipped " << skipped << " malformed lines\n" << RESET;
+    mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        close();
+        return false;
+    }
+
+    data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (data == nullptr) {
+        close();
+        return false;
     }
+    return true;
+}
+
+/**
+ * Unmap the file and release its handles
+ */
+void MappedFile::close() {
+    if (data != nullptr) UnmapViewOfFile(data);
+    if (mapping != nullptr) CloseHandle(mapping);
+    if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+    data = nullptr;
+    mapping = nullptr;
+    file = INVALID_HANDLE_VALUE;
+    size = 0;
+}
+
+/**
+ * View a byte range of the mapped file
+ * 
+ * @param offset Byte offset from the start of the file
+ * @param length Number of bytes
+ * @return       View of the bytes (empty if the range lies outside the file)
+ */
+string_view MappedFile::view(uint64_t offset, uint32_t length) const {
+    if (data == nullptr || offset + length > size) return string_view();
+    return string_view(data + offset, length);
 }
 
 // ═══════════════════════════════════════════════════════════════════════════
-// IMPLEMENTATION: VIEW LOGS
+// IMPLEMENTATION: LOG STORE
 // ═══════════════════════════════════════════════════════════════════════════
 
+LogStore::~LogStore() {
+    clear();
+}
+
 /**
- * Display logs with optional level filtering
- * Uses ostringstream for efficient buffered output
+ * Append an entry, opening a new block when the last one is full
+ * Blocks are allocated individually, so growing never copies old entries
  * 
- * @param filter Log level to filter by (empty = show all)
+ * @param entry Entry to append
  */
-void viewLogs(const string& filter) {
-    if (logsEmpty()) return;
+void LogStore::push_back(const LogEntry& entry) {
+    if (count % LOG_BLOCK_SIZE == 0) {
+        // The previous block is complete; spill if resident blocks exceed the budget
+        if (budget > 0 && !spillFailed && (residentBlocks + 1) * LOG_STORE_BLOCK_BYTES + reserved > budget) {
+            sealResidentBlocks();
+        }
+        Block block;
+        block.resident.reset(new LogEntry[LOG_BLOCK_SIZE]);
+        block.data = block.resident.get();
+        blocks.push_back(std::move(block));
+        residentBlocks++;
+    }
+    blocks.back().resident[count % LOG_BLOCK_SIZE] = entry;
+    count++;
+}
 
-    // Display header
-    cout << "\n  " << BRIGHT_CYAN << "════════════════════════════════════════════════════════════" << RESET << "\n";
-    if (filter.empty()) {
-        cout << "  " << BRIGHT_CYAN << "ALL LOGS" << RESET << "\n";
-    } else {
-        cout << "  " << BRIGHT_CYAN << filter << " LOGS" << RESET << "\n";
+/**
+ * Append every complete resident block to the segment file and map it back
+ * Blocks sealed earlier are never rewritten: the grown file is mapped once
+ * more and every sealed block is pointed into the new mapping. On failure
+ * the new blocks simply stay in memory and spilling is disabled.
+ */
+void LogStore::sealResidentBlocks() {
+    namespace fs = std::filesystem;
+
+    vector<size_t> sealable;
+    for (size_t b = 0; b < blocks.size(); ++b) {
+        bool complete = (b + 1) * LOG_BLOCK_SIZE <= count;
+        if (blocks[b].resident && complete) sealable.push_back(b);
     }
-    cout << "  " << BRIGHT_CYAN << "════════════════════════════════════════════════════════════" << RESET << "\n\n";
+    if (sealable.empty()) return;
 
-    int count = 0;
-    ostringstream oss;  // Buffer output for better performance
-    
-    // Iterate through logs and apply filter
-    for (const auto& entry : logs) {
-        if (filter.empty() || entry.level == filter) {
-            string levelColor = getLevelColor(entry.level);
+    if (segmentPath.empty()) {
+        segmentPath = (fs::temp_directory_path() / ("log_analyzer_segment_" +
+            std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + "_" +
+            std::to_string(reinterpret_cast<uintptr_t>(this)) + ".bin")).string();
+    }
 
-            oss << "  " << CYAN << entry.timestamp << RESET 
-                << " [" << levelColor << entry.level << RESET << "] " 
-                << entry.message << "\n";
-            count++;
+    // Writing starts at the end of the sealed blocks, so a failed append never
+    // touches records that are already mapped
+    uint64_t end = sealedBlocks * LOG_STORE_BLOCK_BYTES;
+    std::ofstream out(segmentPath, std::ios::binary | (sealedBlocks > 0 ? std::ios::in : std::ios::trunc));
+    out.seekp(static_cast<std::streamoff>(end));
+    for (size_t b : sealable) {
+        out.write(reinterpret_cast<const char*>(blocks[b].resident.get()), LOG_STORE_BLOCK_BYTES);
+    }
+    out.close();
+
+    auto grown = std::make_unique<MappedFile>();
+    if (!out || !grown->open(segmentPath)) {
+        spillFailed = true;
+        return;
+    }
+
+    // Release the new blocks' memory, then point every sealed block at the new mapping
+    for (size_t i = 0; i < sealable.size(); ++i) {
+        Block& block = blocks[sealable[i]];
+        block.spillOffset = end + i * LOG_STORE_BLOCK_BYTES;
+        block.resident.reset();
+    }
+    for (Block& block : blocks) {
+        if (block.resident) continue;
+        block.data = reinterpret_cast<const LogEntry*>(
+            grown->view(block.spillOffset, static_cast<uint32_t>(LOG_STORE_BLOCK_BYTES)).data());
+    }
+    residentBlocks -= sealable.size();
+    sealedBlocks += sealable.size();
+    segment = std::move(grown);  // Unmaps the previous, shorter mapping
+}
+
+/**
+ * Drop all entries, unmap the segment and delete its file
+ * The memory budget is kept; the reservation belonged to the old contents
+ */
+void LogStore::clear() {
+    namespace fs = std::filesystem;
+
+    decltype(blocks)().swap(blocks);
+    segment.reset();  // Unmap before deleting (Windows keeps mapped files locked)
+    std::error_code ignored;
+    if (!segmentPath.empty()) fs::remove(segmentPath, ignored);
+    segmentPath.clear();
+
+    count = 0;
+    reserved = 0;
+    residentBlocks = 0;
+    sealedBlocks = 0;
+    spillFailed = false;
+}
+
+/**
+ * Exchange contents (entries, segments and budget) with another store
+ * 
+ * @param other Store to swap with
+ */
+void LogStore::swap(LogStore& other) {
+    std::swap(blocks, other.blocks);
+    std::swap(segment, other.segment);
+    std::swap(segmentPath, other.segmentPath);
+    std::swap(count, other.count);
+    std::swap(budget, other.budget);
+    std::swap(reserved, other.reserved);
+    std::swap(residentBlocks, other.residentBlocks);
+    std::swap(sealedBlocks, other.sealedBlocks);
+    std::swap(spillFailed, other.spillFailed);
+}
+
+/**
+ * Parse a byte size with an optional K, M or G suffix (binary units)
+ * 
+ * @param text  Size such as "512M", "2G" or "1048576"
+ * @param bytes Output size in bytes
+ * @return      true if the text is a positive size that fits in size_t
+ */
+bool parseByteSize(const string& text, size_t& bytes) {
+    if (text.empty() || !std::isdigit(static_cast<unsigned char>(text[0]))) return false;  // stoull accepts "-1"
+
+    size_t used = 0;
+    unsigned long long value = 0;
+    try {
+        value = std::stoull(text, &used);
+    } catch (const std::exception&) {
+        return false;
+    }
+
+    int shift = 0;
+    string suffix = toLowerStr(text.substr(used));
+    if (suffix == "k" || suffix == "kb") shift = 10;
+    else if (suffix == "m" || suffix == "mb") shift = 20;
+    else if (suffix == "g" || suffix == "gb") shift = 30;
+    else if (!suffix.empty() && suffix != "b") return false;
+
+    if (value > (numeric_limits<size_t>::max() >> shift)) return false;  // Would overflow
+    bytes = static_cast<size_t>(value) << shift;
+    return bytes > 0;
+}
+
+/**
+ * Part of the --max-memory budget used outside the entry store: the string
+ * pool, the result cache at its cap and the indexes built after loading
+ * (skip index, and level bitmaps at their 2 bytes per entry worst case).
+ * Search history bitmaps are not counted.
+ * 
+ * @param entries Entries loaded so far
+ * @return        Bytes the store must leave free
+ */
+size_t budgetReservedBytes(size_t entries) {
+    size_t blocks = (entries + LOG_BLOCK_SIZE - 1) / LOG_BLOCK_SIZE;
+    return messagePool.arenaBytes() + messagePool.indexBytes() + resultCache.capacityBytes() +
+           blocks * sizeof(LogBlockIndex) + entries * sizeof(uint16_t);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// IMPLEMENTATION: BLOCK SKIP INDEX
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Hash of one lowercased 3-character window
+ */
+static inline uint64_t trigramHash(unsigned char a, unsigned char b, unsigned char c) {
+    uint32_t packed = (static_cast<uint32_t>(std::tolower(a)) << 16) |
+                      (static_cast<uint32_t>(std::tolower(b)) << 8) |
+                      static_cast<uint32_t>(std::tolower(c));
+    return wyMix(packed ^ 0x9E3779B97F4A7C15ull, 0xD6E8FEB86659FD93ull);
+}
+
+/**
+ * Set the Bloom bits for one trigram hash (double hashing: h1 + i*h2)
+ */
+static inline void bloomAdd(LogBlockIndex& block, uint64_t hash) {
+    uint32_t h1 = static_cast<uint32_t>(hash);
+    uint32_t h2 = static_cast<uint32_t>(hash >> 32) | 1;
+    for (int i = 0; i < BLOOM_HASH_COUNT; ++i) {
+        uint32_t bit = (h1 + i * h2) & (BLOOM_FILTER_BITS - 1);
+        block.bloom[bit >> 6] |= 1ull << (bit & 63);
+    }
+}
+
+/**
+ * Test the Bloom bits for one trigram hash
+ */
+static inline bool bloomTest(const LogBlockIndex& block, uint64_t hash) {
+    uint32_t h1 = static_cast<uint32_t>(hash);
+    uint32_t h2 = static_cast<uint32_t>(hash >> 32) | 1;
+    for (int i = 0; i < BLOOM_HASH_COUNT; ++i) {
+        uint32_t bit = (h1 + i * h2) & (BLOOM_FILTER_BITS - 1);
+        if (!(block.bloom[bit >> 6] & (1ull << (bit & 63)))) return false;
+    }
+    return true;
+}
+
+/**
+ * Add every trigram of a string to a block's Bloom filter
+ */
+static void bloomAddText(LogBlockIndex& block, string_view text) {
+    for (size_t i = 0; i + 3 <= text.size(); ++i) {
+        bloomAdd(block, trigramHash(text[i], text[i + 1], text[i + 2]));
+    }
+}
+
+/**
+ * Build the skip index for one block: time bounds plus a trigram Bloom filter
+ * Each distinct message/level id is only hashed once per block
+ * 
+ * @param blockNumber Index of the block to build
+ */
+static void buildBlock(size_t blockNumber) {
+    LogBlockIndex& block = blockIndex[blockNumber];
+    block.minEpoch = INT64_MAX;
+    block.maxEpoch = INT64_MIN;
+    block.bloom.fill(0);
+
+    std::unordered_set<uint32_t> seenIds;
+    size_t blockEnd = std::min(logs.size(), (blockNumber + 1) * LOG_BLOCK_SIZE);
+    for (size_t i = blockNumber * LOG_BLOCK_SIZE; i < blockEnd; ++i) {
+        const LogEntry& entry = logs[i];
+        if (entry.epoch != INVALID_EPOCH) {
+            block.minEpoch = std::min(block.minEpoch, entry.epoch);
+            block.maxEpoch = std::max(block.maxEpoch, entry.epoch);
+        }
+        if (entry.messageId == LogEntry::LAZY_MESSAGE || seenIds.insert(entry.messageId).second) {
+            bloomAddText(block, entryMessage(entry));
+        }
+        if (seenIds.insert(entry.levelId).second) bloomAddText(block, entryLevel(entry));
+    }
+}
+
+/**
+ * Rebuild the block skip index and the level bitmaps for the currently loaded logs
+ * Blocks are independent, so worker threads claim them from a shared counter
+ */
+void buildBlockIndex() {
+    ScopedTimer timer(PHASE_INDEX);
+    MemoryScope memory(MEMORY_INDEX);
+    size_t blockCount = (logs.size() + LOG_BLOCK_SIZE - 1) / LOG_BLOCK_SIZE;
+    blockIndex.assign(blockCount, LogBlockIndex{});
+
+    unsigned workerCount = std::max(1u, std::thread::hardware_concurrency());
+    workerCount = static_cast<unsigned>(std::min<size_t>(workerCount, blockCount));
+
+    std::atomic<size_t> nextBlock{0};
+    auto worker = [&nextBlock, blockCount]() {
+        TraceSpan span("index.worker");
+        MemoryScope memory(MEMORY_INDEX);
+        for (size_t b = nextBlock++; b < blockCount; b = nextBlock++) {
+            TraceSpan blockSpan("index.block");
+            buildBlock(b);
+        }
+    };
+
+    vector<std::thread> workers;
+    for (unsigned i = 1; i < workerCount; ++i) workers.emplace_back(worker);
+    if (workerCount > 0) worker();  // Calling thread takes part too
+    for (auto& t : workers) t.join();
+
+    levelBitmaps.build();
+}
+
+/**
+ * Compute the trigram hashes a block must contain to possibly match a keyword
+ * Keywords shorter than 3 characters produce no probes (no block is skipped)
+ * 
+ * @param keyword Search keyword (case-insensitive)
+ * @return        Trigram hashes of the keyword
+ */
+vector<uint64_t> bloomProbes(const string& keyword) {
+    vector<uint64_t> probes;
+    for (size_t i = 0; i + 3 <= keyword.size(); ++i) {
+        probes.push_back(trigramHash(keyword[i], keyword[i + 1], keyword[i + 2]));
+    }
+    return probes;
+}
+
+/**
+ * Check whether a block can contain a keyword
+ * 
+ * @param block  Block skip index
+ * @param probes Trigram hashes from bloomProbes()
+ * @return       false if the keyword is definitely absent from the block
+ */
+bool blockMayContain(const LogBlockIndex& block, const vector<uint64_t>& probes) {
+    for (uint64_t probe : probes) {
+        if (!bloomTest(block, probe)) return false;
+    }
+    return true;
+}
+
+/**
+ * Check whether a block's time bounds overlap a time range
+ * 
+ * @param block Block skip index
+ * @param start Range start (epoch seconds, inclusive)
+ * @param end   Range end (epoch seconds, inclusive)
+ * @return      false if no entry in the block can fall inside the range
+ */
+bool blockOverlapsRange(const LogBlockIndex& block, int64_t start, int64_t end) {
+    return block.maxEpoch >= start && block.minEpoch <= end;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// IMPLEMENTATION: SUBSTRING KERNEL
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * ASCII lowercase of one byte (locale-independent)
+ */
+static inline unsigned char asciiLower(unsigned char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<unsigned char>(c + 32) : c;
+}
+
+/**
+ * Compare n bytes of text against an already lowercase needle, ignoring case
+ */
+static inline bool equalsIgnoreCase(const char* text, const char* lowerNeedle, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        if (asciiLower(static_cast<unsigned char>(text[i])) != static_cast<unsigned char>(lowerNeedle[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#ifdef LOG_ANALYZER_SSE2
+/**
+ * Index of the lowest set bit of a non-zero mask
+ */
+static inline unsigned lowestBit(unsigned mask) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+#endif
+
+/**
+ * Case-insensitive substring test without allocating lowercase copies
+ * With SSE2, 16 candidate start positions are checked at once by comparing
+ * the needle's first and last byte (in both cases); only positions where
+ * both agree are verified byte by byte.
+ * 
+ * @param text        Text to search in
+ * @param lowerNeedle Needle, already lowercase
+ * @return            true if the needle occurs in text
+ */
+bool containsIgnoreCase(string_view text, string_view lowerNeedle) {
+    const size_t n = lowerNeedle.size();
+    if (n == 0) return true;
+    if (text.size() < n) return false;
+
+    const char* data = text.data();
+    const size_t lastStart = text.size() - n;
+    size_t i = 0;
+
+#ifdef LOG_ANALYZER_SSE2
+    const unsigned char first = static_cast<unsigned char>(lowerNeedle[0]);
+    const unsigned char last = static_cast<unsigned char>(lowerNeedle[n - 1]);
+    const __m128i firstLower = _mm_set1_epi8(static_cast<char>(first));
+    const __m128i firstUpper = _mm_set1_epi8(static_cast<char>(std::toupper(first)));
+    const __m128i lastLower = _mm_set1_epi8(static_cast<char>(last));
+    const __m128i lastUpper = _mm_set1_epi8(static_cast<char>(std::toupper(last)));
+
+    for (; i + 16 <= lastStart + 1; i += 16) {
+        __m128i headBytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i tailBytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + n - 1));
+        __m128i headHit = _mm_or_si128(_mm_cmpeq_epi8(headBytes, firstLower), _mm_cmpeq_epi8(headBytes, firstUpper));
+        __m128i tailHit = _mm_or_si128(_mm_cmpeq_epi8(tailBytes, lastLower), _mm_cmpeq_epi8(tailBytes, lastUpper));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(headHit, tailHit)));
+
+        while (mask != 0) {
+            unsigned offset = lowestBit(mask);
+            if (n <= 2 || equalsIgnoreCase(data + i + offset + 1, lowerNeedle.data() + 1, n - 2)) {
+                return true;
+            }
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    // Scalar tail (or whole text without SSE2)
+    for (; i <= lastStart; ++i) {
+        if (equalsIgnoreCase(data + i, lowerNeedle.data(), n)) return true;
+    }
+    return false;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// IMPLEMENTATION: LINEAR-TIME REGEX ENGINE
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Make a character set case-insensitive by adding the other case of each letter
+ */
+static void foldCase(std::bitset<256>& chars) {
+    for (int c = 'a'; c <= 'z'; ++c) {
+        if (chars[c] || chars[c - 32]) {
+            chars.set(c);
+            chars.set(c - 32);
+        }
+    }
+}
+
+/**
+ * Translate the character after a backslash into the byte it stands for
+ */
+static unsigned char escapedByte(char c) {
+    switch (c) {
+        case 'n': return '\n';
+        case 't': return '\t';
+        case 'r': return '\r';
+        default:  return static_cast<unsigned char>(c);
+    }
+}
+
+/**
+ * If a (case-folded) set stands for exactly one character, return it lowercase
+ */
+static bool singleCharOf(const std::bitset<256>& chars, char& out) {
+    size_t count = chars.count();
+    if (count != 1 && count != 2) return false;
+    for (int c = 0; c < 256; ++c) {
+        if (!chars[c]) continue;
+        if (count == 2 && !(c >= 'A' && c <= 'Z' && chars[c + 32])) return false;
+        out = static_cast<char>(asciiLower(static_cast<unsigned char>(c)));
+        return true;
+    }
+    return false;
+}
+
+int RegexMatcher::addNode(NodeType type, vector<int> children) {
+    Node node;
+    node.type = type;
+    node.children = std::move(children);
+    nodes.push_back(std::move(node));
+    return static_cast<int>(nodes.size() - 1);
+}
+
+int RegexMatcher::addChars(const CharSet& chars) {
+    int index = addNode(NODE_CHARS);
+    nodes[index].chars = chars;
+    foldCase(nodes[index].chars);
+    return index;
+}
+
+/**
+ * alternation := concat ('|' concat)*
+ */
+int RegexMatcher::parseAlternation() {
+    vector<int> branches{parseConcat()};
+    while (parseError.empty() && pos < pattern.size() && pattern[pos] == '|') {
+        pos++;
+        branches.push_back(parseConcat());
+    }
+    return branches.size() == 1 ? branches[0] : addNode(NODE_ALTERNATE, branches);
+}
+
+/**
+ * concat := repeat*
+ */
+int RegexMatcher::parseConcat() {
+    vector<int> items;
+    while (parseError.empty() && pos < pattern.size() && pattern[pos] != '|' && pattern[pos] != ')') {
+        items.push_back(parseRepeat());
+    }
+    if (items.empty()) return addNode(NODE_EMPTY);
+    return items.size() == 1 ? items[0] : addNode(NODE_CONCAT, items);
+}
+
+/**
+ * repeat := atom ('*' | '+' | '?' | '{m}' | '{m,}' | '{m,n}')*
+ * Counted repetition is expanded into copies of the atom; a lazy '?' suffix
+ * is accepted and ignored because only match/no-match is reported
+ */
+int RegexMatcher::parseRepeat() {
+    int atom = parseAtom();
+    while (parseError.empty() && pos < pattern.size()) {
+        char c = pattern[pos];
+        if (c == '*') {
+            atom = addNode(NODE_STAR, {atom});
+        } else if (c == '+') {
+            atom = addNode(NODE_PLUS, {atom});
+        } else if (c == '?') {
+            atom = addNode(NODE_QUESTION, {atom});
+        } else if (c == '{') {
+            // Parse {m}, {m,} or {m,n}; anything else leaves '{' as a literal.
+            // Counts saturate just above REGEX_MAX_REPEAT so every digit is consumed
+            size_t scan = pos + 1;
+            size_t minCount = 0, maxCount = 0;
+            bool haveMin = false, unbounded = false;
+            while (scan < pattern.size() && std::isdigit(static_cast<unsigned char>(pattern[scan]))) {
+                minCount = std::min(minCount * 10 + (pattern[scan++] - '0'), REGEX_MAX_REPEAT + 1);
+                haveMin = true;
+            }
+            maxCount = minCount;
+            if (haveMin && scan < pattern.size() && pattern[scan] == ',') {
+                scan++;
+                if (scan < pattern.size() && pattern[scan] == '}') {
+                    unbounded = true;
+                } else {
+                    maxCount = 0;
+                    bool haveMax = false;
+                    while (scan < pattern.size() && std::isdigit(static_cast<unsigned char>(pattern[scan]))) {
+                        maxCount = std::min(maxCount * 10 + (pattern[scan++] - '0'), REGEX_MAX_REPEAT + 1);
+                        haveMax = true;
+                    }
+                    if (!haveMax) haveMin = false;
+                }
+            }
+            if (!haveMin || scan >= pattern.size() || pattern[scan] != '}') break;
+
+            if (minCount > REGEX_MAX_REPEAT || maxCount > REGEX_MAX_REPEAT) {
+                parseError = "repetition count too large";
+                break;
+            }
+            if (!unbounded && maxCount < minCount) {
+                parseError = "invalid repetition range";
+                break;
+            }
+
+            vector<int> parts(minCount, atom);
+            if (unbounded) {
+                parts.push_back(addNode(NODE_STAR, {atom}));
+            } else {
+                for (size_t i = minCount; i < maxCount; ++i) parts.push_back(addNode(NODE_QUESTION, {atom}));
+            }
+            atom = parts.empty() ? addNode(NODE_EMPTY) : addNode(NODE_CONCAT, parts);
+            pos = scan;  // Points at '}', consumed below
+        } else {
+            break;
+        }
+        pos++;
+        if (pos < pattern.size() && pattern[pos] == '?') pos++;
+    }
+    return atom;
+}
+
+/**
+ * Fill a set for \d \w \s and their negations; false for any other letter
+ */
+bool RegexMatcher::parseClassEscape(char c, CharSet& chars) {
+    CharSet cls;
+    switch (std::tolower(static_cast<unsigned char>(c))) {
+        case 'd':
+            for (int ch = '0'; ch <= '9'; ++ch) cls.set(ch);
+            break;
+        case 'w':
+            for (int ch = 0; ch < 256; ++ch) {
+                if (std::isalnum(ch) || ch == '_') cls.set(ch);
+            }
+            break;
+        case 's':
+            for (char ch : string(" \t\r\n\f\v")) cls.set(static_cast<unsigned char>(ch));
+            break;
+        default:
+            return false;
+    }
+    if (std::isupper(static_cast<unsigned char>(c))) cls.flip();
+    chars |= cls;
+    return true;
+}
+
+/**
+ * Parse a bracket expression after its opening '['
+ */
+bool RegexMatcher::parseBracket(CharSet& chars) {
+    bool negate = false;
+    if (pos < pattern.size() && pattern[pos] == '^') {
+        negate = true;
+        pos++;
+    }
+
+    bool first = true;
+    while (true) {
+        if (pos >= pattern.size()) {
+            parseError = "missing ']'";
+            return false;
+        }
+        char c = pattern[pos++];
+        if (c == ']' && !first) break;
+        first = false;
+
+        unsigned char low = static_cast<unsigned char>(c);
+        if (c == '\\') {
+            if (pos >= pattern.size()) {
+                parseError = "pattern ends with '\\'";
+                return false;
+            }
+            char escaped = pattern[pos++];
+            if (parseClassEscape(escaped, chars)) continue;
+            low = escapedByte(escaped);
+        }
+
+        // Range such as a-z (a '-' right before ']' is a literal)
+        if (pos + 1 < pattern.size() && pattern[pos] == '-' && pattern[pos + 1] != ']') {
+            pos++;
+            unsigned char high = static_cast<unsigned char>(pattern[pos++]);
+            if (high == '\\') {
+                if (pos >= pattern.size()) {
+                    parseError = "pattern ends with '\\'";
+                    return false;
+                }
+                high = escapedByte(pattern[pos++]);
+            }
+            if (high < low) {
+                parseError = "invalid range in character class";
+                return false;
+            }
+            for (int ch = low; ch <= high; ++ch) chars.set(ch);
+        } else {
+            chars.set(low);
+        }
+    }
+
+    // Fold before negating so [^a] excludes both 'a' and 'A'
+    foldCase(chars);
+    if (negate) chars.flip();
+    return true;
+}
+
+/**
+ * atom := '(' alternation ')' | '[' class ']' | '.' | '^' | '$' | '\' escape | literal
+ */
+int RegexMatcher::parseAtom() {
+    char c = pattern[pos++];
+    switch (c) {
+        case '(': {
+            if (pattern.compare(pos, 2, "?:") == 0) pos += 2;
+            int inner = parseAlternation();
+            if (pos >= pattern.size() || pattern[pos] != ')') {
+                if (parseError.empty()) parseError = "missing ')'";
+                return inner;
+            }
+            pos++;
+            return inner;
+        }
+        case '[': {
+            CharSet chars;
+            if (!parseBracket(chars)) return addNode(NODE_EMPTY);
+            return addChars(chars);
+        }
+        case '.': {
+            CharSet chars;
+            chars.set();
+            chars.reset('\n');
+            return addChars(chars);
+        }
+        case '^':
+            return addNode(NODE_BEGIN_LINE);
+        case '$':
+            return addNode(NODE_END_LINE);
+        case '*':
+        case '+':
+        case '?':
+            parseError = string("nothing to repeat before '") + c + "'";
+            return addNode(NODE_EMPTY);
+        case '\\': {
+            if (pos >= pattern.size()) {
+                parseError = "pattern ends with '\\'";
+                return addNode(NODE_EMPTY);
+            }
+            char escaped = pattern[pos++];
+            CharSet chars;
+            if (!parseClassEscape(escaped, chars)) chars.set(escapedByte(escaped));
+            return addChars(chars);
+        }
+        default: {
+            CharSet chars;
+            chars.set(static_cast<unsigned char>(c));
+            return addChars(chars);
+        }
+    }
+}
+
+/**
+ * Compile a parse tree node into NFA states that continue at `next`
+ * Built back to front, so each fragment's exit is known when it is created
+ * 
+ * @param index Parse tree node
+ * @param next  NFA state to continue with after this node matches
+ * @return      Entry state of the compiled fragment
+ */
+int RegexMatcher::compileNode(int index, int next) {
+    if (nfa.size() > REGEX_MAX_NFA_STATES) {
+        parseError = "pattern too large";
+        return next;
+    }
+
+    const Node& node = nodes[index];
+    auto addState = [this](StateType type, int out, int out1) {
+        NfaState state;
+        state.type = type;
+        state.out = out;
+        state.out1 = out1;
+        nfa.push_back(state);
+        return static_cast<int>(nfa.size() - 1);
+    };
+
+    switch (node.type) {
+        case NODE_CHARS: {
+            int state = addState(STATE_CHARS, next, -1);
+            nfa[state].chars = node.chars;
+            return state;
+        }
+        case NODE_CONCAT: {
+            int start = next;
+            for (auto it = node.children.rbegin(); it != node.children.rend(); ++it) {
+                start = compileNode(*it, start);
+            }
+            return start;
+        }
+        case NODE_ALTERNATE: {
+            int start = compileNode(node.children.back(), next);
+            for (size_t i = node.children.size() - 1; i-- > 0;) {
+                int branch = compileNode(node.children[i], next);
+                start = addState(STATE_SPLIT, branch, start);
+            }
+            return start;
+        }
+        case NODE_STAR: {
+            int split = addState(STATE_SPLIT, -1, next);
+            nfa[split].out = compileNode(node.children[0], split);
+            return split;
+        }
+        case NODE_PLUS: {
+            int split = addState(STATE_SPLIT, -1, next);
+            int body = compileNode(node.children[0], split);
+            nfa[split].out = body;
+            return body;
+        }
+        case NODE_QUESTION:
+            return addState(STATE_SPLIT, compileNode(node.children[0], next), next);
+        case NODE_BEGIN_LINE:
+            return addState(STATE_BEGIN_LINE, next, -1);
+        case NODE_END_LINE:
+            return addState(STATE_END_LINE, next, -1);
+        case NODE_EMPTY:
+        default:
+            return next;
+    }
+}
+
+/**
+ * Longest lowercase literal that every match of a node must contain
+ * Used to prefilter lines with the substring kernel before running the DFA
+ */
+string RegexMatcher::literalOf(int index) const {
+    const Node& node = nodes[index];
+    char c;
+    switch (node.type) {
+        case NODE_CHARS:
+            return singleCharOf(node.chars, c) ? string(1, c) : string();
+        case NODE_PLUS:
+            return literalOf(node.children[0]);
+        case NODE_CONCAT: {
+            string best, run;
+            for (int child : node.children) {
+                const Node& childNode = nodes[child];
+                if (childNode.type == NODE_CHARS && singleCharOf(childNode.chars, c)) {
+                    run += c;
+                    continue;
+                }
+                if (childNode.type == NODE_BEGIN_LINE || childNode.type == NODE_END_LINE) continue;
+                if (run.size() > best.size()) best = run;
+                run.clear();
+                string inner = literalOf(child);
+                if (inner.size() > best.size()) best = inner;
+            }
+            if (run.size() > best.size()) best = run;
+            return best;
+        }
+        default:
+            return string();
+    }
+}
+
+/**
+ * Compile a pattern; must be called once before matches()
+ * 
+ * @param source Pattern text
+ * @param error  Receives a description of the problem on failure
+ * @return       true if the pattern compiled
+ */
+bool RegexMatcher::compile(const string& source, string& error) {
+    nodes.clear();
+    nfa.clear();
+    clearDfa();
+    literal.clear();
+
+    pattern = source;
+    pos = 0;
+    parseError.clear();
+
+    int root = parseAlternation();
+    if (parseError.empty() && pos < pattern.size()) parseError = "unmatched ')'";
+
+    if (parseError.empty()) {
+        NfaState match;
+        match.type = STATE_MATCH;
+        nfa.push_back(match);
+        nfaStart = compileNode(root, 0);
+    }
+
+    if (!parseError.empty()) {
+        error = parseError;
+        nfa.clear();
+        return false;
+    }
+
+    literal = literalOf(root);
+    nodes.clear();  // Parse tree is no longer needed
+    return true;
+}
+
+const string& RegexMatcher::requiredLiteral() const {
+    return literal;
+}
+
+/**
+ * Expand a set of NFA states through epsilon edges (splits and, at the start
+ * of the text, '^'). Keeps only states that consume input, '$' and match.
+ */
+void RegexMatcher::closure(vector<int>& states, bool atBeginning) const {
+    vector<char> visited(nfa.size(), 0);
+    vector<int> stack(states.begin(), states.end());
+    vector<int> result;
+
+    while (!stack.empty()) {
+        int s = stack.back();
+        stack.pop_back();
+        if (s < 0 || visited[s]) continue;
+        visited[s] = 1;
+
+        const NfaState& state = nfa[s];
+        if (state.type == STATE_SPLIT) {
+            stack.push_back(state.out);
+            stack.push_back(state.out1);
+        } else if (state.type == STATE_BEGIN_LINE) {
+            if (atBeginning) stack.push_back(state.out);
+        } else {
+            result.push_back(s);
+        }
+    }
+
+    std::sort(result.begin(), result.end());
+    states.swap(result);
+}
+
+/**
+ * Drop every cached DFA state (the NFA is kept)
+ */
+void RegexMatcher::clearDfa() {
+    dfaStates.clear();
+    dfaTransitions.clear();
+    dfaSets.clear();
+    dfaSlots.clear();
+    dfaStart = -1;
+}
+
+/**
+ * Bytes held by the DFA cache: transitions, state sets, states and lookup table
+ */
+size_t RegexMatcher::dfaBytes() const {
+    return (dfaTransitions.size() + dfaSets.size() + dfaSlots.size()) * sizeof(int32_t) +
+           dfaStates.size() * sizeof(DfaState);
+}
+
+/**
+ * Look up the DFA state of a closed NFA state set
+ * 
+ * @param states Sorted NFA state set
+ * @param hash   Hash of the set
+ * @return       DFA state index, or -1 if not cached
+ */
+int RegexMatcher::findDfaState(const vector<int>& states, uint64_t hash) const {
+    if (dfaSlots.empty()) return -1;
+    size_t mask = dfaSlots.size() - 1;
+    for (size_t slot = hash & mask; dfaSlots[slot] >= 0; slot = (slot + 1) & mask) {
+        const DfaState& dfa = dfaStates[dfaSlots[slot]];
+        if (dfa.hash == hash && dfa.setSize == states.size() &&
+            std::equal(states.begin(), states.end(), dfaSets.begin() + dfa.setOffset)) {
+            return dfaSlots[slot];
+        }
+    }
+    return -1;
+}
+
+/**
+ * Find or create the DFA state for a closed NFA state set
+ */
+int RegexMatcher::internDfaState(const vector<int>& states) {
+    uint64_t hash = hashBytes(reinterpret_cast<const char*>(states.data()), states.size() * sizeof(int));
+    int found = findDfaState(states, hash);
+    if (found >= 0) return found;
+
+    DfaState dfa;
+    dfa.accepting = false;
+    bool reachesEnd = false;
+
+    // A '$' state leads to a match only at the end of the text
+    vector<char> visited(nfa.size(), 0);
+    vector<int> stack;
+    for (int s : states) {
+        if (nfa[s].type == STATE_MATCH) dfa.accepting = true;
+        if (nfa[s].type == STATE_END_LINE) stack.push_back(nfa[s].out);
+    }
+    while (!stack.empty() && !reachesEnd) {
+        int s = stack.back();
+        stack.pop_back();
+        if (s < 0 || visited[s]) continue;
+        visited[s] = 1;
+        const NfaState& state = nfa[s];
+        if (state.type == STATE_MATCH) reachesEnd = true;
+        else if (state.type == STATE_SPLIT) {
+            stack.push_back(state.out);
+            stack.push_back(state.out1);
+        } else if (state.type == STATE_END_LINE) {
+            stack.push_back(state.out);
+        }
+    }
+    dfa.acceptsAtEnd = dfa.accepting || reachesEnd;
+    dfa.setOffset = static_cast<uint32_t>(dfaSets.size());
+    dfa.setSize = static_cast<uint32_t>(states.size());
+    dfa.hash = hash;
+    dfaSets.insert(dfaSets.end(), states.begin(), states.end());
+
+    int index = static_cast<int>(dfaStates.size());
+    dfaStates.push_back(dfa);
+    dfaTransitions.resize(dfaTransitions.size() + 256, -1);
+
+    // Keep the table at most half full; growing re-inserts by the stored hashes
+    if (dfaStates.size() * 2 > dfaSlots.size()) {
+        dfaSlots.assign(std::max<size_t>(64, dfaSlots.size() * 2), -1);
+        size_t mask = dfaSlots.size() - 1;
+        for (size_t d = 0; d < dfaStates.size(); ++d) {
+            size_t slot = dfaStates[d].hash & mask;
+            while (dfaSlots[slot] >= 0) slot = (slot + 1) & mask;
+            dfaSlots[slot] = static_cast<int32_t>(d);
+        }
+    } else {
+        size_t mask = dfaSlots.size() - 1;
+        size_t slot = hash & mask;
+        while (dfaSlots[slot] >= 0) slot = (slot + 1) & mask;
+        dfaSlots[slot] = index;
+    }
+    return index;
+}
+
+int RegexMatcher::startDfaState() {
+    if (dfaStart < 0) {
+        vector<int> start{nfaStart};
+        closure(start, true);
+        dfaStart = internDfaState(start);
+    }
+    return dfaStart;
+}
+
+/**
+ * Compute and cache the DFA transition for one byte
+ * The start state is re-added after every byte, which makes the search
+ * unanchored without restarting at each position. When a new state would
+ * take the cache past REGEX_MAX_DFA_BYTES it is flushed instead of growing
+ * without bound.
+ */
+int RegexMatcher::buildTransition(int state, unsigned char byte) {
+    vector<int> next;
+    const DfaState& current = dfaStates[state];
+    for (uint32_t i = 0; i < current.setSize; ++i) {
+        const NfaState& nfaState = nfa[dfaSets[current.setOffset + i]];
+        if (nfaState.type == STATE_CHARS && nfaState.chars[byte]) next.push_back(nfaState.out);
+    }
+    next.push_back(nfaStart);
+    closure(next, false);
+
+    size_t newStateBytes = (256 + next.size()) * sizeof(int32_t) + sizeof(DfaState);
+    if (dfaBytes() + newStateBytes > REGEX_MAX_DFA_BYTES) {
+        uint64_t hash = hashBytes(reinterpret_cast<const char*>(next.data()), next.size() * sizeof(int));
+        if (findDfaState(next, hash) < 0) {
+            clearDfa();
+            return internDfaState(next);
+        }
+    }
+
+    int target = internDfaState(next);
+    dfaTransitions[static_cast<size_t>(state) * 256 + byte] = target;
+    return target;
+}
+
+/**
+ * Check whether the text contains a match (case-insensitive)
+ * 
+ * @param text Text to search
+ * @return     true if some substring of text matches the pattern
+ */
+bool RegexMatcher::matches(string_view text) {
+    if (nfa.empty()) return false;
+
+    int state = startDfaState();
+    if (dfaStates[state].accepting) return true;
+
+    for (unsigned char byte : text) {
+        int next = dfaTransitions[static_cast<size_t>(state) * 256 + byte];
+        if (next < 0) next = buildTransition(state, byte);
+        state = next;
+        if (dfaStates[state].accepting) return true;
+    }
+    return dfaStates[state].acceptsAtEnd;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// IMPLEMENTATION: SEARCH QUERIES
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Prepare a search from user input
+ * Input wrapped in slashes (/pattern/) is compiled as a regular expression,
+ * anything else is a case-insensitive keyword. A leading backslash makes
+ * the rest a keyword as written, so "\/api/" finds the text "/api/".
+ * Runs once per query.
+ * 
+ * @param input User input
+ * @param query Query to fill
+ * @param error Receives the reason if the regex does not compile
+ * @return      true if the query is ready to use
+ */
+bool compileSearchQuery(const string& input, SearchQuery& query, string& error) {
+    query.text = input;
+    bool escaped = !input.empty() && input.front() == '\\';
+    query.isRegex = !escaped && input.size() >= 2 && input.front() == '/' && input.back() == '/';
+
+    if (query.isRegex) {
+        if (!query.regex.compile(input.substr(1, input.size() - 2), error)) return false;
+        query.literal = query.regex.requiredLiteral();
+    } else {
+        query.literal = toLowerStr(escaped ? input.substr(1) : input);
+    }
+
+    query.probes = bloomProbes(query.literal);
+    query.verdicts.assign(messagePool.idLimit(), -1);
+    return true;
+}
+
+/**
+ * Test one string against the query: literal prefilter, then regex if any
+ */
+static bool textMatches(SearchQuery& query, string_view text) {
+    bool hit = containsIgnoreCase(text, query.literal);
+    if (hit && query.isRegex) hit = query.regex.matches(text);
+    return hit;
+}
+
+/**
+ * Decide whether one pooled string matches, caching the answer per id so
+ * every distinct message is examined only once per query
+ */
+static bool pooledTextMatches(SearchQuery& query, uint32_t id) {
+    int8_t& verdict = query.verdicts[id];
+    if (verdict < 0) verdict = textMatches(query, messagePool.view(id)) ? 1 : 0;
+    return verdict == 1;
+}
+
+/**
+ * Check whether a log entry matches a compiled query (message or level)
+ * 
+ * @param query Query prepared by compileSearchQuery()
+ * @param entry Log entry to test
+ * @return      true if the entry matches
+ */
+bool searchMatches(SearchQuery& query, const LogEntry& entry) {
+    // Messages left in the file (low-memory mode) have no id to cache under
+    bool messageHit = entry.messageId == LogEntry::LAZY_MESSAGE
+        ? textMatches(query, entryMessage(entry))
+        : pooledTextMatches(query, entry.messageId);
+    return messageHit || pooledTextMatches(query, entry.levelId);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// IMPLEMENTATION: LOAD LOG FILE
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Load and parse a log file
+ * 
+ * Features:
+ * - Supports 3 different log formats via regex parsing
+ * - Security validation to prevent path traversal
+ * - Reports number of loaded and skipped entries
+ * - Clears existing logs before loading new file
+ * - Low-memory mode (--low-memory, or files above 1 GB) keeps only a compact
+ *   record per entry and maps the file to read messages on demand
+ */
+void loadLogFile() {
+    string filename;
+    cout << "\n  " << GREEN << "Enter log file name: " << RESET;
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    getline(cin, filename);
+
+    // Validate empty input
+    if (filename.empty()) {
+        cerr << RED << "  ✗ No filename provided.\n" << RESET;
+        return;
+    }
+
+    loadLogPath(filename);
+}
+
+/**
+ * Load and parse the log file at a path (shared by the menu and --serve)
+ * 
+ * @param filename Path of the log file
+ * @return         true if the file was opened and parsed
+ */
+bool loadLogPath(const string& filename) {
+    TraceSpan span("loadLogFile");
+    MemoryScope memory(MEMORY_LOADER);
+
+    // Warn about missing .log extension
+    if (filename.find(".log") == string::npos) {
+        cout << YELLOW << "  ⚠ Warning: File doesn't have .log extension\n" << RESET;
+    }
+
+    // Security: Validate file path to prevent directory traversal
+    bool validPath;
+    {
+        ScopedTimer timer(PHASE_LOAD_VALIDATE);
+        validPath = isValidLogPath(filename);
+    }
+    if (!validPath) {
+        cerr << RED << "  ✗ Invalid or unauthorized file path.\n" << RESET;
+        return false;
+    }
+
+    // Attempt to open file (binary, so byte offsets match the file on disk)
+    ScopedTimer openTimer(PHASE_LOAD_OPEN);
+    ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        cerr << RED << "  ✗ Could not open file: " << filename << RESET << "\n";
+        return false;
+    }
+
+    // Check file size and warn if large
+    file.seekg(0, std::ios::end);
+    size_t fileSize = file.tellg();
+    file.seekg(0, std::ios::beg);
+    openTimer.stop();
+
+    if(fileSize > 10 * 1024 * 1024) {  // 10MB threshold
+        double sizeMB = fileSize / (1024.0 * 1024.0);
+        cout << YELLOW << "  ⚠ Large file detected (" 
+             << fixed << setprecision(1) << sizeMB 
+             << "MB). Loading may take time...\n" << RESET;
+    }
+
+    // Clear existing logs (and their spill segments) and prepare for new data
+    logs.clear();
+    messagePool.clear(); // Old ids are meaningless for the new file
+    resultCache.clear();
+    searchSteps.clear();
+    currentStep = SIZE_MAX;
+    templateIndex.clear();
+    anomalyDetector.reset();
+    sourceFile.close();
+
+    // Low-memory mode: messages stay in the file and are read through a mapping.
+    // With a memory budget smaller than the file, message text could not fit anyway.
+    size_t budget = logs.memoryBudget();
+    bool lazyMessages = lowMemoryMode || fileSize > LOW_MEMORY_AUTO_BYTES || (budget > 0 && fileSize > budget);
+    if (lazyMessages && !sourceFile.open(filename)) {
+        cout << YELLOW << "  ⚠ Could not map file; loading messages into memory instead.\n" << RESET;
+        lazyMessages = false;
+    }
+    
+    string line;
+    uint64_t lineOffset = 0;
+    uint64_t lineCount = 0;
+    int skipped = 0;
+
+    // Parse each line of the file (laps split the time into read / parse / store)
+    {
+        TraceSpan linesSpan("load.lines");  // Per-line phases are too fine-grained to trace
+        PhaseLaps laps(profiler.enabled());
+        while(getline(file, line)) {
+            laps.lap(PHASE_LOAD_READ);
+            lineCount++;
+            uint64_t nextOffset = lineOffset + line.size() + 1;
+            if (!line.empty() && line.back() == '\r') line.pop_back();  // Windows line endings
+
+            LogEntry entry;
+            bool parsed = parseLogLine(line, entry, !lazyMessages);
+            laps.lap(PHASE_LOAD_PARSE);
+            if(parsed) {
+                entry.offset += lineOffset;
+                if (budget > 0 && logs.size() % LOG_BLOCK_SIZE == 0) logs.setReservedBytes(budgetReservedBytes(logs.size()));
+                logs.push_back(entry);
+                anomalyDetector.observe(entry);  // O(1) per entry
+                laps.lap(PHASE_LOAD_STORE);
+            } else if(!line.empty()) {
+                skipped++;  // Count malformed non-empty lines
+            }
+            lineOffset = nextOffset;
+        }
+    }
+    if (profiler.enabled()) {
+        profiler.count(COUNTER_BYTES_READ, std::min<uint64_t>(lineOffset, fileSize));
+        profiler.count(COUNTER_LINES, lineCount);
+        profiler.count(COUNTER_PARSED, logs.size());
+        profiler.count(COUNTER_SKIPPED, skipped);
+    }
+
+    file.close();
+    anomalyDetector.finish();
+
+    // Build per-block Bloom filters and time bounds used to skip searches
+    buildBlockIndex();
+    
+    // Report results
+    cout << GREEN << "  ✓ Loaded " << logs.size() << " log entries.\n" << RESET;
+    if (skipped > 0) {
+        cout << YELLOW << "  ⚠ Skipped " << skipped << " malformed lines\n" << RESET;
+    }
+
+    if (lazyMessages) {
+        cout << CYAN << "  ℹ Low-memory mode: messages stay in the mapped file ("
+             << formatBytes(sourceFile.fileSize()) << "); entry records use "
+             << formatBytes(logs.size() * sizeof(LogEntry)) << "\n" << RESET;
+    }
+    if (logs.sealedBytes() > 0) {
+        cout << CYAN << "  ℹ Spill: " << formatBytes(logs.sealedBytes()) << " of entries sealed in the segment file; "
+             << formatBytes(logs.residentBytes()) << " resident (budget " << formatBytes(budget)
+             << "; pool, indexes and cache reserve " << formatBytes(budgetReservedBytes(logs.size())) << ")\n" << RESET;
+    }
+    if (!anomalyDetector.anomalies().empty()) {
+        cout << YELLOW << "  ⚠ " << anomalyDetector.anomalies().size()
+             << " error-rate anomalies detected (Advanced Tools → Anomaly Report)\n" << RESET;
+    }
+    if (logs.spillError()) {
+        cout << YELLOW << "  ⚠ Could not write a spill segment; remaining entries were kept in memory.\n" << RESET;
+    }
+
+    // Report how much the message pool saved through deduplication
+    if (!logs.empty()) {
+        size_t distinct = messagePool.distinctCount();
+        double dedupRatio = distinct > 0 ? messagePool.internCount() / static_cast<double>(distinct) : 0.0;
+        size_t poolBytes = messagePool.arenaBytes() + messagePool.indexBytes();
+
+        cout << CYAN << "  ℹ Strings: " << distinct << " distinct of " << messagePool.internCount()
+             << " (dedup ratio " << fixed << setprecision(1) << dedupRatio << ":1)\n" << RESET;
+        cout << CYAN << "  ℹ Text: " << formatBytes(messagePool.rawBytes()) << " raw, "
+             << formatBytes(messagePool.uniqueBytes()) << " unique, pool uses "
+             << formatBytes(poolBytes) << " (arena + index)\n" << RESET;
+        cout << CYAN << "  ℹ Skip index: " << blockIndex.size() << " blocks of " << LOG_BLOCK_SIZE
+             << " entries (" << formatBytes(blockIndex.size() * sizeof(LogBlockIndex)) << ")\n" << RESET;
+        cout << CYAN << "  ℹ Level bitmaps: " << levelBitmaps.levelCount() << " levels ("
+             << formatBytes(levelBitmaps.bytes()) << ")\n" << RESET;
+        printMemorySummary();
+    }
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// IMPLEMENTATION: VIEW LOGS
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Display logs with optional level filtering
+ * Uses ostringstream for efficient buffered output
+ * 
+ * @param filter Log level to filter by (empty = show all)
+ */
+void viewLogs(const string& filter) {
+    if (logsEmpty()) return;
+
+    // Display header
+    cout << "\n  " << BRIGHT_CYAN << "════════════════════════════════════════════════════════════" << RESET << "\n";
+    if (filter.empty()) {
+        cout << "  " << BRIGHT_CYAN << "ALL LOGS" << RESET << "\n";
+    } else {
+        cout << "  " << BRIGHT_CYAN << filter << " LOGS" << RESET << "\n";
+    }
+    cout << "  " << BRIGHT_CYAN << "════════════════════════════════════════════════════════════" << RESET << "\n\n";
+
+    int count = 0;
+    size_t lines = 0;
+    ostringstream oss;  // Buffer output for better performance
+    RunCollapser collapser(collapseMode);
+    CollapsedRun run;
+
+    auto show = [&](const LogEntry& entry) {
+        count++;
+        if (collapseMode != COLLAPSE_OFF) {
+            // Repeats are folded as they stream past; a run prints when it ends
+            if (collapser.push(entry, run)) {
+                writeCollapsedRun(oss, run, true);
+                lines++;
+            }
+            return;
+        }
+        string levelColor = getLevelColor(entryLevel(entry));
+
+        oss << "  " << CYAN << entryTimestamp(entry) << RESET 
+            << " [" << levelColor << entryLevel(entry) << RESET << "] " 
+            << entryMessage(entry) << "\n";
+    };
+
+    // Iterate through all logs, or only the entries in the level's bitmap
+    if (filter.empty()) {
+        for (const auto& entry : logs) show(entry);
+    } else if (const EntryBitmap* level = levelBitmaps.find(messagePool.find(filter))) {
+        level->forEach([&show](uint32_t index) { show(logs[index]); });
+    }
+    if (collapser.flush(run)) {
+        writeCollapsedRun(oss, run, true);
+        lines++;
+    }
+    
+    // Display buffered output and footer
+    cout << oss.str();
+    cout << "  " << BRIGHT_CYAN << "─────────────────────────────────────────────────────────────" << RESET << "\n";
+    cout << "  " << BRIGHT_CYAN << "Total: " << count << " entries";
+    if (collapseMode != COLLAPSE_OFF) cout << " (" << lines << " lines, repeats collapsed)";
+    cout << RESET << "\n\n";
+}
+
+/**
+ * Display logs with pagination (unused placeholder function)
+ * 
+ * @param filter   Log level filter
+ * @param pageSize Number of entries per page
+ */
+void viewLogsPaginated(const string& filter, int pageSize = 20) {
+    if(logsEmpty()) return;
+
+    EntryView filtered = getFilteredLogs(filter);
+    if(filtered.empty()) {
+        cout << RED << "\n  ✗ No logs match the filter.\n" << RESET;
+        return;
+    }
+
+    viewEntriesPaginated(filtered, filter.empty() ? "ALL LOGS" : filter + " LOGS", pageSize);
+}
+
+/**
+ * Page through any list of entries
+ * 
+ * @param entries  Entries to display
+ * @param title    Header text (page info is appended)
+ * @param pageSize Number of entries per page
+ */
+void viewEntriesPaginated(const EntryView& entries, const string& title, int pageSize) {
+    if(entries.empty()) return;
+
+    size_t totalPages = (entries.size() + pageSize - 1) / pageSize;
+    size_t currentPage = 0;
+
+    // Pagination loop
+    while(true) {
+        cout << "\033[H\033[2J";  // Clear screen
+        
+        // Display header with page info
+        cout << "\n  " << BRIGHT_CYAN << "════════════════════════════════════════════════════════════" << RESET << "\n";
+        cout << "  " << BRIGHT_CYAN << title << " (Page " << (currentPage + 1) << "/" << totalPages << ")" << RESET << "\n";
+        cout << "  " << BRIGHT_CYAN << "════════════════════════════════════════════════════════════" << RESET << "\n\n";
+
+        // Calculate page range
+        size_t start = currentPage * pageSize;
+        size_t end = std::min(start + pageSize, entries.size());
+
+        // Display logs for current page
+        for(size_t i = start; i < end; ++i) {
+            printLogEntry(entries[i]);
+        }
+
+        // Display navigation footer
+        cout << "\n  " << BRIGHT_CYAN << "─────────────────────────────────────────────────────────────" << RESET << "\n";
+        cout << "  " << BRIGHT_CYAN << "Showing " << (start + 1) << "-" << end << " of " << entries.size() << " entries" << RESET << "\n";
+        cout << "  [N]ext  [P]revious  [Q]uit: ";
+
+        // Handle user input
+        char input;
+        cin >> input;
+        if(cin.fail()) {
+            cin.clear();
+            break;
+        }
+        input = std::tolower(input);
+
+        if(input == 'n' && currentPage < totalPages - 1) {
+            currentPage++;
+        } else if(input == 'p' && currentPage > 0) {
+            currentPage--;
+        } else if(input == 'q') {
+            break;
+        }
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// IMPLEMENTATION: BACKGROUND SEARCH
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Run a search on worker threads while the calling thread streams results
+ * 
+ * Workers claim blocks from a shared counter, so a thread that finishes a
+ * cheap (skipped) block immediately takes the next one and no core sits idle
+ * behind a slow partition. Each worker copies the query for a private
+ * verdict cache and regex DFA. The calling thread prints the first
+ * streamLimit matches in file order as soon as their block is finished,
+ * shows progress, and cancels the scan cooperatively on any keypress.
+ * 
+ * @param query       Compiled query
+ * @param streamLimit Number of matches to print while scanning
+ * @return            Matches from all completed blocks plus timing figures
+ */
+SearchRun runBackgroundSearch(const SearchQuery& query, size_t streamLimit) {
+    ScopedTimer timer(PHASE_SEARCH);
+    MemoryScope memory(MEMORY_QUERY);
+    SearchRun run;
+    auto startTime = std::chrono::steady_clock::now();
+
+    const size_t blockCount = blockIndex.size();
+    vector<vector<uint32_t>> blockMatches(blockCount);
+    std::unique_ptr<std::atomic<bool>[]> blockDone(new std::atomic<bool>[blockCount]);
+    for (size_t b = 0; b < blockCount; ++b) blockDone[b].store(false);
+
+    std::atomic<size_t> nextBlock{0};
+    std::atomic<bool> cancel{false};
+    std::atomic<size_t> scannedEntries{0};
+    std::atomic<size_t> scannedBytes{0};
+
+    unsigned workerCount = std::max(1u, std::thread::hardware_concurrency());
+    workerCount = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(workerCount, blockCount)));
+    std::atomic<unsigned> runningWorkers{workerCount};
+
+    auto worker = [&]() {
+        TraceSpan span("search.worker");
+        MemoryScope memory(MEMORY_QUERY);
+        SearchQuery local = query;  // Private caches: no sharing between threads
+        size_t entries = 0, bytes = 0;
+        for (size_t b = nextBlock++; b < blockCount && !cancel.load(std::memory_order_relaxed); b = nextBlock++) {
+            if (blockMayContain(blockIndex[b], local.probes)) {
+                TraceSpan blockSpan("search.block");
+                size_t blockEnd = std::min(logs.size(), (b + 1) * LOG_BLOCK_SIZE);
+                for (size_t i = b * LOG_BLOCK_SIZE; i < blockEnd; ++i) {
+                    entries++;
+                    bytes += entryMessage(logs[i]).size();
+                    if (searchMatches(local, logs[i])) blockMatches[b].push_back(static_cast<uint32_t>(i));
+                }
+            }
+            blockDone[b].store(true, std::memory_order_release);
+        }
+        scannedEntries += entries;
+        scannedBytes += bytes;
+        runningWorkers--;
+    };
+
+    vector<std::thread> workers;
+    for (unsigned i = 0; i < workerCount; ++i) workers.emplace_back(worker);
+
+    // Stream matches in file order and watch the keyboard until workers finish
+    size_t streamed = 0;
+    size_t reportedBlocks = 0;
+    bool progressShown = false;
+    auto lastProgress = startTime;
+
+    while (true) {
+        bool finished = runningWorkers.load() == 0;
+
+        while (reportedBlocks < blockCount && blockDone[reportedBlocks].load(std::memory_order_acquire)) {
+            for (uint32_t index : blockMatches[reportedBlocks]) {
+                if (streamed >= streamLimit) break;
+                if (progressShown) {
+                    cout << "\r\033[K";
+                    progressShown = false;
+                }
+                printLogEntry(logs[index]);
+                streamed++;
+            }
+            reportedBlocks++;
+        }
+        if (finished) break;
+
+        // Any keypress cancels; workers stop after their current block
+        if (!cancel && _kbhit()) {
+            _getch();
+            cancel = true;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastProgress >= std::chrono::milliseconds(SEARCH_PROGRESS_INTERVAL_MS)) {
+            size_t claimed = std::min(nextBlock.load(), blockCount);
+            cout << "\r\033[K  " << CYAN << "Searching... " << (claimed * 100 / std::max<size_t>(1, blockCount))
+                 << "% • " << streamed << (streamed >= streamLimit ? "+" : "")
+                 << " matches • press any key to cancel" << RESET << flush;
+            progressShown = true;
+            lastProgress = now;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(SEARCH_POLL_INTERVAL_MS));
+    }
+    if (progressShown) cout << "\r\033[K" << flush;
+
+    for (auto& t : workers) t.join();
+
+    // Collect matches from every completed block, in file order
+    for (size_t b = 0; b < blockCount; ++b) {
+        if (blockDone[b].load()) {
+            run.matches.insert(run.matches.end(), blockMatches[b].begin(), blockMatches[b].end());
+            run.completedBlocks++;
+        }
+    }
+    run.cancelled = cancel.load();
+    run.scannedEntries = scannedEntries.load();
+    run.scannedBytes = scannedBytes.load();
+    run.elapsedMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - startTime).count();
+    if (profiler.enabled()) {
+        profiler.count(COUNTER_ENTRIES_SCANNED, run.scannedEntries);
+        profiler.count(COUNTER_MATCHES, run.matches.size());
+    }
+    return run;
+}
+
+/**
+ * Print the match count, elapsed time and throughput of a background search
+ * 
+ * @param run Finished search
+ */
+void printSearchSummary(const SearchRun& run) {
+    double seconds = std::max(run.elapsedMs / 1000.0, 1e-6);
+    double megabytes = run.scannedBytes / (1024.0 * 1024.0);
+
+    cout << "  " << BRIGHT_CYAN << "Found: " << run.matches.size() << " matching entries" << RESET << "\n";
+    if (run.cached) {
+        cout << "  " << CYAN << "From result cache in " << fixed << setprecision(2) << run.elapsedMs << " ms" << RESET << "\n";
+        return;
+    }
+    cout << "  " << CYAN << "Scanned " << run.scannedEntries << " entries (" << formatBytes(run.scannedBytes)
+         << ") in " << fixed << setprecision(1) << run.elapsedMs << " ms • "
+         << setprecision(1) << (megabytes / seconds) << " MB/s • "
+         << setprecision(0) << (run.scannedEntries / seconds) << " entries/s" << RESET << "\n";
+    if (run.cancelled) {
+        cout << "  " << YELLOW << "⚠ Search cancelled after " << run.completedBlocks << " of "
+             << blockIndex.size() << " blocks; results are partial.\n" << RESET;
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// IMPLEMENTATION: SEARCH LOGS
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Search logs for keyword (case-insensitive)
+ * Searches both message content and log level
+ * Input wrapped in slashes (/pattern/) is treated as a regular expression
+ * Input starting with '+' searches only within the current result set
+ * ("\+1" searches for the text "+1")
+ * Automatically adds search to history
+ */
+void searchLogs() {
+    if (logsEmpty()) return;
+    MemoryScope memory(MEMORY_QUERY);  // Result sets and their views
+
+    // Get search keyword from user
+    string keyword;
+    cout << "\n  " << YELLOW << "Enter search keyword (or /regex/";
+    if (currentStep < searchSteps.size()) {
+        cout << ", +keyword to search within the last " << searchSteps[currentStep].matches.size() << " results";
+    }
+    cout << "; \\ in front searches for the text as written";
+    cout << "): " << RESET;
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    getline(cin, keyword);
+
+    // Refinement: "+keyword" re-checks only the current result set ("\+..." is a plain keyword)
+    bool refine = !keyword.empty() && keyword[0] == '+';
+    string text = keyword;
+    if (refine) {
+        text.erase(0, 1);
+        text.erase(0, text.find_first_not_of(' '));
+    }
+    if (refine && currentStep >= searchSteps.size()) {
+        cerr << RED << "  ✗ No earlier search to refine.\n" << RESET;
+        return;
+    }
+
+    // Validate input
+    if (text.empty()) {
+        cerr << RED << "  ✗ No search keyword provided.\n" << RESET;
+        return;
+    }
+
+    // Compile the query once (keyword or regex)
+    SearchQuery query;
+    string error;
+    if (!compileSearchQuery(text, query, error)) {
+        cerr << RED << "  ✗ Invalid regex: " << error << "\n" << RESET;
+        return;
+    }
+
+    // Track search in history
+    searchHistory.push_back(keyword);
+    string chain = refine ? searchSteps[currentStep].chain + " → " + text : text;
+
+    // Display search header
+    cout << "\n  " << BRIGHT_CYAN << "════════════════════════════════════════════════════════════" << RESET << "\n";
+    if (refine) {
+        cout << "  " << BRIGHT_CYAN << "REFINED RESULTS FOR: " << chain << " (within "
+             << searchSteps[currentStep].matches.size() << " results)" << RESET << "\n";
+    } else if (query.isRegex) {
+        cout << "  " << BRIGHT_CYAN << "SEARCH RESULTS FOR: " << keyword << " (regex, case-insensitive)" << RESET << "\n";
+    } else {
+        cout << "  " << BRIGHT_CYAN << "SEARCH RESULTS FOR: \"" << keyword << "\" (case-insensitive)" << RESET << "\n";
+    }
+    cout << "  " << BRIGHT_CYAN << "════════════════════════════════════════════════════════════" << RESET << "\n\n";
+
+    // Scan on worker threads (the first page of matches streams in as found),
+    // or re-check just the previous results when refining
+    SearchRun run = refine ? refineSearch(query, searchSteps[currentStep].matches.toVector(), SEARCH_STREAM_LIMIT)
+                           : cachedSearch(query, SEARCH_STREAM_LIMIT);
+    if (!run.cancelled) recordSearchStep(chain, run.matches, !run.matches.empty());
+
+    // Display results or no-match message
+    if (!run.matches.empty()) {
+        if (run.matches.size() > SEARCH_STREAM_LIMIT) {
+            cout << "  " << YELLOW << "... and " << (run.matches.size() - SEARCH_STREAM_LIMIT)
+                 << " more matches\n" << RESET;
+        }
+        cout << "\n  " << BRIGHT_CYAN << "─────────────────────────────────────────────────────────────" << RESET << "\n";
+        printSearchSummary(run);
+
+        // Offer the paged viewer for the full result set
+        if (run.matches.size() > SEARCH_STREAM_LIMIT) {
+            cout << "\n  View all " << run.matches.size() << " results page by page? (y/n): ";
+            char choice;
+            cin >> choice;
+            if (choice == 'y' || choice == 'Y') {
+                viewEntriesPaginated(EntryView(logs, std::move(run.matches)), "SEARCH RESULTS FOR: " + chain);
+            }
+        }
+    } else {
+        cout << "  " << RED << "✗ No matching logs found.\n" << RESET;
+        printSearchSummary(run);
+    }
+    cout << "\n";
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// IMPLEMENTATION: SEARCH AND EXPORT
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Search logs and optionally export results
+ * Combines search functionality with immediate export option
+ * Displays preview of first 10 results before export confirmation
+ */
+void searchAndExport() {
+    if(logsEmpty()) return;
+
+    // Get search keyword
+    string keyword;
+    cout << "\n  " << YELLOW << "Enter search keyword (or /regex/): " << RESET;
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    getline(cin, keyword);
+
+    // Validate input
+    if(keyword.empty()) {
+        cerr << RED << "  ✗ No search keyword provided.\n" << RESET;
+        return;
+    }
+
+    // Compile the query once (keyword or regex)
+    SearchQuery query;
+    string error;
+    if(!compileSearchQuery(keyword, query, error)) {
+        cerr << RED << "  ✗ Invalid regex: " << error << "\n" << RESET;
+        return;
+    }
+
+    // Add to search history
+    searchHistory.push_back(keyword);
+
+    // Display search results header
+    cout << "\n  " << BRIGHT_CYAN << "════════════════════════════════════════════════════════════" << RESET << "\n";
+    cout << "  " << BRIGHT_CYAN << "SEARCH RESULTS FOR: \"" << keyword << "\"" << RESET << "\n";
+    cout << "  " << BRIGHT_CYAN << "════════════════════════════════════════════════════════════" << RESET << "\n\n";
+
+    // Search in the background; the first 10 results stream in as a preview
+    SearchRun run = cachedSearch(query, 10);
+
+    // Check if any matches found
+    if(run.matches.empty()) {
+        cout << RED << "  ✗ No matching logs found.\n" << RESET;
+        printSearchSummary(run);
+        return;
+    }
+
+    // Show count of additional results
+    if(run.matches.size() > 10) {
+        cout << "  " << YELLOW << "... and " << (run.matches.size() - 10) 
+             << " more matches\n" << RESET;
+    }
+    cout << "\n";
+    printSearchSummary(run);
+
+    // Prompt for export
+    cout << "\n  Do you want to export these results? (y/n): ";
+
+    char choice;
+    cin >> choice;
+
+    if(choice == 'y' || choice == 'Y') {
+        ostringstream desc;
+        desc << "Search results for: \"" << keyword << "\"";
+        exportLogs(EntryView(logs, std::move(run.matches)), desc.str());
+    } else {
+        cout << YELLOW << "  Export cancelled.\n" << RESET;
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// IMPLEMENTATION: MULTI-PATTERN SEARCH (AHO-CORASICK)
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Build the automaton for a set of patterns (matching ignores case)
+ * 
+ * @param patterns Patterns to match; empty patterns are ignored
+ */
+void MultiPatternMatcher::build(const vector<string>& patterns) {
+    // Assign one class per distinct (lowercased) byte used by any pattern
+    byteClass.fill(0);
+    classes = 1;
+    for (const auto& pattern : patterns) {
+        for (unsigned char c : pattern) {
+            unsigned char lower = asciiLower(c);
+            if (byteClass[lower] == 0 && classes < 256) {
+                byteClass[lower] = static_cast<uint8_t>(classes++);
+            }
+        }
+    }
+    for (int c = 'A'; c <= 'Z'; ++c) byteClass[c] = byteClass[c + 32];
+
+    // Trie of all patterns; -1 marks a missing edge
+    transitions.assign(classes, -1);
+    outputs.assign(1, {});
+    for (uint32_t index = 0; index < patterns.size(); ++index) {
+        if (patterns[index].empty()) continue;
+        int32_t state = 0;
+        for (unsigned char c : patterns[index]) {
+            size_t edge = static_cast<size_t>(state) * classes + byteClass[c];
+            if (transitions[edge] < 0) {
+                transitions[edge] = static_cast<int32_t>(outputs.size());
+                transitions.resize(transitions.size() + classes, -1);
+                outputs.emplace_back();
+            }
+            state = transitions[edge];
+        }
+        outputs[state].push_back(index);
+    }
+
+    // Breadth-first pass: failure links, output links and the full DFA
+    vector<int32_t> failure(outputs.size(), 0);
+    outputLink.assign(outputs.size(), 0);
+    vector<int32_t> queue;
+    for (size_t c = 0; c < classes; ++c) {
+        int32_t& next = transitions[c];
+        if (next < 0) {
+            next = 0;
+        } else {
+            queue.push_back(next);
+        }
+    }
+
+    for (size_t head = 0; head < queue.size(); ++head) {
+        int32_t state = queue[head];
+        int32_t fail = failure[state];
+        outputLink[state] = outputs[fail].empty() ? outputLink[fail] : fail;
+
+        for (size_t c = 0; c < classes; ++c) {
+            int32_t& next = transitions[static_cast<size_t>(state) * classes + c];
+            int32_t fallback = transitions[static_cast<size_t>(fail) * classes + c];
+            if (next < 0) {
+                next = fallback;
+            } else {
+                failure[next] = fallback;
+                queue.push_back(next);
+            }
+        }
+    }
+}
+
+/**
+ * Find every pattern occurring in a text
+ * 
+ * @param text Text to scan
+ * @param hits Receives the sorted, distinct indices of patterns found
+ */
+void MultiPatternMatcher::findAll(string_view text, vector<uint32_t>& hits) const {
+    hits.clear();
+    int32_t state = 0;
+    for (unsigned char c : text) {
+        state = transitions[static_cast<size_t>(state) * classes + byteClass[c]];
+        for (int32_t s = outputs[state].empty() ? outputLink[state] : state; s > 0; s = outputLink[s]) {
+            hits.insert(hits.end(), outputs[s].begin(), outputs[s].end());
+        }
+    }
+    if (hits.size() > 1) {
+        std::sort(hits.begin(), hits.end());
+        hits.erase(std::unique(hits.begin(), hits.end()), hits.end());
+    }
+}
+
+size_t MultiPatternMatcher::stateCount() const {
+    return outputs.size();
+}
+
+size_t MultiPatternMatcher::classCount() const {
+    return classes;
+}
+
+/**
+ * Read search patterns from a file: one per line, blank lines and lines
+ * starting with '#' are skipped
+ * 
+ * @param filename Pattern file path
+ * @param patterns Receives the patterns
+ * @return         true if the file could be read
+ */
+static bool readPatternFile(const string& filename, vector<string>& patterns) {
+    ifstream file(filename);
+    if (!file.is_open()) return false;
+
+    string line;
+    while (getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();  // Windows line endings
+        if (line.empty() || line[0] == '#') continue;
+        patterns.push_back(line);
+    }
+    return true;
+}
+
+/**
+ * Search for many patterns at once (e.g. a list of known error signatures)
+ * 
+ * Features:
+ * - Loads patterns from a file and builds one Aho-Corasick automaton
+ * - Scans each distinct message once, regardless of the pattern count
+ * - Reports per-pattern hit counts (entries containing the pattern)
+ * - Previews matching entries and offers to export them
+ */
+void multiPatternSearch() {
+    if (logsEmpty()) return;
+
+    string filename;
+    cout << "\n  " << YELLOW << "Enter pattern file (one pattern per line): " << RESET;
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    getline(cin, filename);
+
+    if (filename.empty()) {
+        cerr << RED << "  ✗ No filename provided.\n" << RESET;
+        return;
+    }
+    if (!isValidLogPath(filename)) {
+        cerr << RED << "  ✗ Invalid or unauthorized file path.\n" << RESET;
+        return;
+    }
+
+    vector<string> patterns;
+    if (!readPatternFile(filename, patterns)) {
+        cerr << RED << "  ✗ Could not open file: " << filename << RESET << "\n";
+        return;
+    }
+    if (patterns.empty()) {
+        cerr << RED << "  ✗ Pattern file contains no patterns.\n" << RESET;
+        return;
+    }
+
+    searchHistory.push_back("[patterns] " + filename);
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    MultiPatternMatcher matcher;
+    matcher.build(patterns);
+
+    // Scan every distinct message once; entries then just look up their id
+    vector<int8_t> scanned(messagePool.idLimit(), 0);
+    vector<vector<uint32_t>> hitsById(messagePool.idLimit());
+    vector<size_t> hitCounts(patterns.size(), 0);
+    vector<uint32_t> matched;
+    vector<uint32_t> hits;
+
+    for (size_t i = 0; i < logs.size(); ++i) {
+        const LogEntry& entry = logs[i];
+        uint32_t id = entry.messageId;
+        if (id == LogEntry::LAZY_MESSAGE) {
+            matcher.findAll(entryMessage(entry), hits);  // Not pooled: scan every line
+        } else if (!scanned[id]) {
+            matcher.findAll(entryMessage(entry), hits);
+            hitsById[id] = hits;
+            scanned[id] = 1;
+        }
+        const vector<uint32_t>& entryHits = id == LogEntry::LAZY_MESSAGE ? hits : hitsById[id];
+        if (entryHits.empty()) continue;
+
+        for (uint32_t pattern : entryHits) hitCounts[pattern]++;
+        matched.push_back(static_cast<uint32_t>(i));
+    }
+    EntryView results(logs, std::move(matched));
+
+    auto elapsedMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - startTime).count();
+
+    // Display header
+    cout << "\n  " << BRIGHT_CYAN << "════════════════════════════════════════════════════════════" << RESET << "\n";
+    cout << "  " << BRIGHT_CYAN << "MULTI-PATTERN SEARCH: " << patterns.size() << " patterns from " << filename << RESET << "\n";
+    cout << "  " << BRIGHT_CYAN << "════════════════════════════════════════════════════════════" << RESET << "\n\n";
+    cout << "  " << CYAN << "Automaton: " << RESET << matcher.stateCount() << " states, "
+         << matcher.classCount() << " byte classes\n\n";
+
+    // Per-pattern hit counts, most frequent first
+    vector<size_t> order(patterns.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(),
+        [&hitCounts](size_t a, size_t b) { return hitCounts[a] > hitCounts[b]; });
+
+    size_t withoutHits = 0;
+    for (size_t index : order) {
+        if (hitCounts[index] == 0) {
+            withoutHits++;
+            continue;
+        }
+        cout << "  " << YELLOW << std::right << std::setw(8) << hitCounts[index] << RESET
+             << "  " << patterns[index] << "\n";
+    }
+    cout << std::left;
+    if (withoutHits > 0) {
+        cout << "  " << CYAN << withoutHits << " pattern(s) had no hits" << RESET << "\n";
+    }
+
+    if (results.empty()) {
+        cout << RED << "\n  ✗ No matching logs found.\n" << RESET;
+        return;
+    }
+
+    // Preview matching entries
+    cout << "\n";
+    size_t displayCount = std::min<size_t>(10, results.size());
+    for (size_t i = 0; i < displayCount; ++i) {
+        const auto& entry = results[i];
+        string levelColor = getLevelColor(entryLevel(entry));
+        cout << "  " << CYAN << entryTimestamp(entry) << RESET 
+             << " [" << levelColor << entryLevel(entry) << RESET << "] " 
+             << entryMessage(entry) << "\n";
+    }
+    if (results.size() > displayCount) {
+        cout << "  " << YELLOW << "... and " << (results.size() - displayCount) << " more matches\n" << RESET;
+    }
+
+    cout << "\n  " << GREEN << "✓ Found " << results.size() << " matching entries in "
+         << fixed << setprecision(1) << elapsedMs << " ms.\n" << RESET;
+    cout << "  Do you want to export these results? (y/n): ";
+
+    char choice;
+    cin >> choice;
+    if (choice == 'y' || choice == 'Y') {
+        exportLogs(results, "Multi-pattern search: " + filename);
+    } else {
+        cout << YELLOW << "  Export cancelled.\n" << RESET;
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// IMPLEMENTATION: FILTER QUERY LANGUAGE
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Split query text into words, quoted strings and operator symbols
+ */
+bool FilterQuery::tokenize(const string& text) {
+    tokens.clear();
+    size_t i = 0;
+    while (i < text.size()) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (std::isspace(c)) {
+            i++;
+        } else if (c == '"' || c == '\'') {
+            // Quoted string; backslash escapes the next character
+            string value;
+            size_t j = i + 1;
+            while (j < text.size() && text[j] != static_cast<char>(c)) {
+                if (text[j] == '\\' && j + 1 < text.size()) j++;
+                value += text[j++];
+            }
+            if (j >= text.size()) {
+                parseError = "unterminated string";
+                return false;
+            }
+            tokens.push_back({Token::TEXT, value});
+            i = j + 1;
+        } else if (std::isalnum(c) || c == '_' || c == '-' || c == ':' || c == '/' || c == '.') {
+            // Bare word (keywords, level names, unquoted times)
+            size_t j = i;
+            while (j < text.size()) {
+                unsigned char w = static_cast<unsigned char>(text[j]);
+                if (!(std::isalnum(w) || w == '_' || w == '-' || w == ':' || w == '/' || w == '.')) break;
+                j++;
+            }
+            tokens.push_back({Token::WORD, text.substr(i, j - i)});
+            i = j;
+        } else {
+            // Operators: two-character forms first
+            static const char* symbols[] = {">=", "<=", "!=", "=~", "!~", ">", "<", "=", "~", "(", ")", ","};
+            bool found = false;
+            for (const char* symbol : symbols) {
+                size_t length = std::strlen(symbol);
+                if (text.compare(i, length, symbol) == 0) {
+                    tokens.push_back({Token::SYMBOL, symbol});
+                    i += length;
+                    found = true;
+                    break;
+                }
+            }
+            if (!found) {
+                parseError = string("unexpected character '") + text[i] + "'";
+                return false;
+            }
+        }
+    }
+    tokens.push_back({Token::END, ""});
+    return true;
+}
+
+/**
+ * Consume the next token if it is the given keyword (case-insensitive)
+ */
+bool FilterQuery::accept(const string& word) {
+    const Token& token = tokens[current];
+    if (token.kind == Token::WORD && toLowerStr(token.value) == word) {
+        current++;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Consume the given symbol or record a parse error
+ */
+bool FilterQuery::expectSymbol(const string& symbol) {
+    if (tokens[current].kind == Token::SYMBOL && tokens[current].value == symbol) {
+        current++;
+        return true;
+    }
+    if (parseError.empty()) parseError = "expected '" + symbol + "'";
+    return false;
+}
+
+int FilterQuery::addNode(Op op, vector<int> children) {
+    Node node;
+    node.op = op;
+    node.children = std::move(children);
+    nodes.push_back(std::move(node));
+    return static_cast<int>(nodes.size() - 1);
+}
+
+int FilterQuery::parseOr() {
+    vector<int> terms{parseAnd()};
+    while (parseError.empty() && accept("or")) terms.push_back(parseAnd());
+    return terms.size() == 1 ? terms[0] : addNode(OP_OR, terms);
+}
+
+int FilterQuery::parseAnd() {
+    vector<int> terms{parseUnary()};
+    while (parseError.empty() && accept("and")) terms.push_back(parseUnary());
+    return terms.size() == 1 ? terms[0] : addNode(OP_AND, terms);
+}
+
+int FilterQuery::parseUnary() {
+    if (accept("not")) return addNode(OP_NOT, {parseUnary()});
+    if (tokens[current].kind == Token::SYMBOL && tokens[current].value == "(") {
+        current++;
+        int inner = parseOr();
+        expectSymbol(")");
+        return inner;
+    }
+    return parseCondition();
+}
+
+/**
+ * Read a time operand: a full timestamp for 'ts', HH:MM[:SS] for 'time'
+ */
+bool FilterQuery::readTime(Op op, int64_t& value) {
+    const Token& token = tokens[current];
+    if (token.kind != Token::TEXT && token.kind != Token::WORD) {
+        parseError = "expected a time value";
+        return false;
+    }
+    current++;
+
+    if (op == OP_TIME) {
+        value = timestampToEpoch(token.value);
+        if (value == INVALID_EPOCH) {
+            parseError = "invalid timestamp \"" + token.value + "\" (use YYYY-MM-DD HH:MM:SS)";
+            return false;
+        }
+        return true;
+    }
+
+    int hours = 0, minutes = 0, seconds = 0;
+    int fields = std::sscanf(token.value.c_str(), "%d:%d:%d", &hours, &minutes, &seconds);
+    if (fields < 2 || hours < 0 || hours > 23 || minutes < 0 || minutes > 59 || seconds < 0 || seconds > 59) {
+        parseError = "invalid time of day \"" + token.value + "\" (use HH:MM or HH:MM:SS)";
+        return false;
+    }
+    value = hours * 3600 + minutes * 60 + seconds;
+    return true;
+}
+
+/**
+ * Parse the operator and operand(s) of a 'ts' or 'time' condition
+ */
+int FilterQuery::parseComparison(Op op, const string& field) {
+    int index = addNode(op);
+    int64_t a = 0, b = 0;
+
+    if (accept("between")) {
+        if (!readTime(op, a) || !accept("and") || !readTime(op, b)) {
+            if (parseError.empty()) parseError = "expected '" + field + " between <from> and <to>'";
+            return index;
+        }
+        // Timestamps are an interval either way round; 23:00 to 01:00 crosses midnight
+        nodes[index].low = op == OP_TIME ? std::min(a, b) : a;
+        nodes[index].high = op == OP_TIME ? std::max(a, b) : b;
+        return index;
+    }
+
+    const Token& symbol = tokens[current];
+    if (symbol.kind != Token::SYMBOL) {
+        parseError = "expected comparison after '" + field + "'";
+        return index;
+    }
+    current++;
+    if (!readTime(op, a)) return index;
+
+    if (symbol.value == ">=") nodes[index].low = a;
+    else if (symbol.value == ">") nodes[index].low = a + 1;
+    else if (symbol.value == "<=") nodes[index].high = a;
+    else if (symbol.value == "<") nodes[index].high = a - 1;
+    else if (symbol.value == "=") nodes[index].low = nodes[index].high = a;
+    else parseError = "unsupported operator '" + symbol.value + "' for " + field;
+    return index;
+}
+
+int FilterQuery::parseCondition() {
+    const Token& token = tokens[current];
+    if (token.kind != Token::WORD) {
+        parseError = token.kind == Token::END ? "unexpected end of query" : "expected level, ts, time or msg";
+        return addNode(OP_AND);
+    }
+
+    string field = toLowerStr(token.value);
+    current++;
+
+    if (field == "level") {
+        int index = addNode(OP_LEVEL);
+        bool negate = false;
+        vector<string> names;
+
+        if (accept("in")) {
+            if (!expectSymbol("(")) return index;
+            do {
+                const Token& name = tokens[current];
+                if (name.kind != Token::WORD && name.kind != Token::TEXT) {
+                    parseError = "expected level name";
+                    return index;
+                }
+                names.push_back(name.value);
+                current++;
+            } while (tokens[current].kind == Token::SYMBOL && tokens[current].value == "," && ++current);
+            if (!expectSymbol(")")) return index;
+        } else if (tokens[current].kind == Token::SYMBOL &&
+                   (tokens[current].value == "=" || tokens[current].value == "!=")) {
+            negate = tokens[current].value == "!=";
+            current++;
+            const Token& name = tokens[current];
+            if (name.kind != Token::WORD && name.kind != Token::TEXT) {
+                parseError = "expected level name";
+                return index;
+            }
+            names.push_back(name.value);
+            current++;
+        } else {
+            parseError = "expected '=', '!=' or 'in' after 'level'";
+            return index;
+        }
+
+        // Resolve names to pool ids once; unknown levels simply never match
+        for (auto& name : names) {
+            transform(name.begin(), name.end(), name.begin(),
+                [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+            uint32_t id = messagePool.find(name);
+            if (id != MessagePool::INVALID_ID) nodes[index].levelIds.push_back(id);
+        }
+        nodes[index].levelNames = names;
+        return negate ? addNode(OP_NOT, {index}) : index;
+    }
+
+    if (field == "ts") return parseComparison(OP_TIME, field);
+    if (field == "time") return parseComparison(OP_TIME_OF_DAY, field);
+
+    if (field == "msg") {
+        const Token& symbol = tokens[current];
+        if (symbol.kind != Token::SYMBOL || (symbol.value != "~" && symbol.value != "!~" && symbol.value != "=~")) {
+            parseError = "expected '~', '!~' or '=~' after 'msg'";
+            return addNode(OP_AND);
+        }
+        string op = symbol.value;
+        current++;
+
+        const Token& operand = tokens[current];
+        if (operand.kind != Token::TEXT && operand.kind != Token::WORD) {
+            parseError = "expected quoted text after 'msg " + op + "'";
+            return addNode(OP_AND);
+        }
+        current++;
+
+        if (op == "=~") {
+            int index = addNode(OP_REGEX);
+            nodes[index].needle = operand.value;
+            nodes[index].regex = std::make_shared<RegexMatcher>();
+            string error;
+            if (!nodes[index].regex->compile(operand.value, error)) parseError = "invalid regex: " + error;
+            return index;
+        }
+
+        int index = addNode(OP_CONTAINS);
+        nodes[index].needle = toLowerStr(operand.value);
+        return op == "!~" ? addNode(OP_NOT, {index}) : index;
+    }
+
+    parseError = "unknown field '" + token.value + "' (use level, ts, time or msg)";
+    return addNode(OP_AND);
+}
+
+/**
+ * Assign cost classes bottom-up and sort every 'and' cheapest first
+ */
+void FilterQuery::plan(int index) {
+    Node& node = nodes[index];
+    switch (node.op) {
+        case OP_LEVEL:        node.cost = 1; break;
+        case OP_TIME:
+        case OP_TIME_OF_DAY:  node.cost = 2; break;
+        case OP_CONTAINS:     node.cost = 3; break;
+        case OP_REGEX:        node.cost = 4; break;
+        case OP_NOT:
+        case OP_AND:
+        case OP_OR: {
+            int cost = 0;
+            for (int child : node.children) {
+                plan(child);
+                cost = std::max(cost, nodes[child].cost);
+            }
+            nodes[index].cost = cost;
+            if (nodes[index].op == OP_AND) {
+                vector<int>& children = nodes[index].children;
+                std::stable_sort(children.begin(), children.end(),
+                    [this](int a, int b) { return nodes[a].cost < nodes[b].cost; });
+            }
+            break;
+        }
+    }
+    if (nodes[index].op == OP_CONTAINS || nodes[index].op == OP_REGEX) {
+        nodes[index].verdicts.assign(messagePool.idLimit(), -1);
+    }
+}
+
+/**
+ * Compile query text into an evaluation plan
+ * 
+ * @param text  Query text
+ * @param error Receives the reason when the query is invalid
+ * @return      true if the query is ready to evaluate
+ */
+bool FilterQuery::compile(const string& text, string& error) {
+    nodes.clear();
+    parseError.clear();
+    current = 0;
+    blockLow = INT64_MIN;
+    blockHigh = INT64_MAX;
+    probes.clear();
+
+    if (tokenize(text)) {
+        root = parseOr();
+        if (parseError.empty() && tokens[current].kind != Token::END) {
+            parseError = "unexpected '" + tokens[current].value + "'";
+        }
+    }
+    if (!parseError.empty()) {
+        error = parseError;
+        return false;
+    }
+
+    plan(root);
+
+    // Conditions that must hold for every match also bound which blocks to read
+    vector<int> required = nodes[root].op == OP_AND ? nodes[root].children : vector<int>{root};
+    for (int index : required) {
+        const Node& node = nodes[index];
+        if (node.op == OP_TIME) {
+            blockLow = std::max(blockLow, node.low);
+            blockHigh = std::min(blockHigh, node.high);
+        } else if (node.op == OP_CONTAINS) {
+            vector<uint64_t> more = bloomProbes(node.needle);
+            probes.insert(probes.end(), more.begin(), more.end());
+        } else if (node.op == OP_REGEX) {
+            vector<uint64_t> more = bloomProbes(node.regex->requiredLiteral());
+            probes.insert(probes.end(), more.begin(), more.end());
+        }
+    }
+    return true;
+}
+
+bool FilterQuery::evaluate(int index, const LogEntry& entry, const string_view* message) {
+    Node& node = nodes[index];
+    switch (node.op) {
+        case OP_AND:
+            for (int child : node.children) {
+                if (!evaluate(child, entry, message)) return false;
+            }
+            return true;
+        case OP_OR:
+            for (int child : node.children) {
+                if (evaluate(child, entry, message)) return true;
+            }
+            return false;
+        case OP_NOT:
+            return !evaluate(node.children[0], entry, message);
+        case OP_LEVEL:
+            return std::find(node.levelIds.begin(), node.levelIds.end(), entry.levelId) != node.levelIds.end();
+        case OP_TIME:
+            return entry.epoch != INVALID_EPOCH && entry.epoch >= node.low && entry.epoch <= node.high;
+        case OP_TIME_OF_DAY: {
+            if (entry.epoch == INVALID_EPOCH) return false;
+            int64_t wallClock = entry.epoch + logUtcOffset;
+            int64_t secondOfDay = ((wallClock % 86400) + 86400) % 86400;
+            if (node.low > node.high) return secondOfDay >= node.low || secondOfDay <= node.high;
+            return secondOfDay >= node.low && secondOfDay <= node.high;
+        }
+        case OP_CONTAINS:
+        case OP_REGEX: {
+            auto test = [&node](string_view text) {
+                return node.op == OP_CONTAINS
+                    ? containsIgnoreCase(text, node.needle)
+                    : (containsIgnoreCase(text, node.regex->requiredLiteral()) && node.regex->matches(text));
+            };
+            if (message != nullptr) return test(*message);
+            if (entry.messageId == LogEntry::LAZY_MESSAGE) return test(entryMessage(entry));
+
+            int8_t& verdict = node.verdicts[entry.messageId];
+            if (verdict < 0) verdict = test(entryMessage(entry)) ? 1 : 0;
+            return verdict == 1;
+        }
+    }
+    return false;
+}
+
+/**
+ * Evaluate the query against one entry
+ */
+bool FilterQuery::matches(const LogEntry& entry) {
+    return evaluate(root, entry, nullptr);
+}
+
+/**
+ * Evaluate the query against an entry whose message is not in the pool
+ * (levels still resolve through the pool; no per-message verdicts are cached)
+ * 
+ * @param entry   Log entry (level, timestamp)
+ * @param message Message text of the entry
+ */
+bool FilterQuery::matches(const LogEntry& entry, string_view message) {
+    return evaluate(root, entry, &message);
+}
+
+/**
+ * Check whether any entry of a block can satisfy the query
+ */
+bool FilterQuery::blockMayMatch(const LogBlockIndex& block) const {
+    return blockOverlapsRange(block, blockLow, blockHigh) && blockMayContain(block, probes);
+}
+
+/**
+ * Check whether a subtree only tests levels
+ */
+bool FilterQuery::levelOnly(int index) const {
+    const Node& node = nodes[index];
+    if (node.op == OP_LEVEL) return true;
+    if (node.op != OP_AND && node.op != OP_OR && node.op != OP_NOT) return false;
+    for (int child : node.children) {
+        if (!levelOnly(child)) return false;
+    }
+    return true;
+}
+
+/**
+ * Entries satisfying a level-only subtree, combined from the level bitmaps
+ */
+EntryBitmap FilterQuery::levelBitmap(int index) const {
+    const Node& node = nodes[index];
+    if (node.op == OP_LEVEL) {
+        EntryBitmap result;
+        for (uint32_t levelId : node.levelIds) {
+            if (const EntryBitmap* level = levelBitmaps.find(levelId)) {
+                result = EntryBitmap::combine(result, *level, EntryBitmap::OR);
+            }
+        }
+        return result;
+    }
+    if (node.op == OP_NOT) {
+        return EntryBitmap::combine(levelBitmaps.all(), levelBitmap(node.children[0]), EntryBitmap::ANDNOT);
+    }
+
+    EntryBitmap result = levelBitmap(node.children[0]);
+    for (size_t i = 1; i < node.children.size(); ++i) {
+        result = EntryBitmap::combine(result, levelBitmap(node.children[i]),
+                                      node.op == OP_AND ? EntryBitmap::AND : EntryBitmap::OR);
+    }
+    return result;
+}
+
+/**
+ * Entries allowed by the level terms of the query
+ * 
+ * @param out   Receives the candidate entries
+ * @param exact Set to true if every candidate matches (the query only tests levels)
+ * @return      false if the query has no level terms at the top level
+ */
+bool FilterQuery::candidates(EntryBitmap& out, bool& exact) const {
+    if (levelOnly(root)) {
+        out = levelBitmap(root);
+        exact = true;
+        return true;
+    }
+    if (nodes[root].op != OP_AND) return false;
+
+    bool found = false;
+    for (int child : nodes[root].children) {
+        if (!levelOnly(child)) continue;
+        out = found ? EntryBitmap::combine(out, levelBitmap(child), EntryBitmap::AND) : levelBitmap(child);
+        found = true;
+    }
+    exact = false;
+    return found;
+}
+
+string FilterQuery::describe(int index) const {
+    const Node& node = nodes[index];
+    ostringstream out;
+    switch (node.op) {
+        case OP_AND:
+        case OP_OR:
+            out << "(";
+            for (size_t i = 0; i < node.children.size(); ++i) {
+                if (i > 0) out << (node.op == OP_AND ? " and " : " or ");
+                out << describe(node.children[i]);
+            }
+            out << ")";
+            break;
+        case OP_NOT:
+            out << "not " << describe(node.children[0]);
+            break;
+        case OP_LEVEL:
+            out << "level in {";
+            for (size_t i = 0; i < node.levelNames.size(); ++i) out << (i ? "," : "") << node.levelNames[i];
+            out << "}";
+            break;
+        case OP_TIME:
+        case OP_TIME_OF_DAY:
+            out << (node.op == OP_TIME ? "ts" : "time") << " in range";
+            if (node.op == OP_TIME_OF_DAY && node.low > node.high) out << " (across midnight)";
+            break;
+        case OP_CONTAINS:
+            out << "msg ~ \"" << node.needle << "\"";
+            break;
+        case OP_REGEX:
+            out << "msg =~ /" << node.needle << "/";
+            break;
+    }
+    return out.str();
+}
+
+/**
+ * Human-readable evaluation order of the top-level terms
+ */
+string FilterQuery::describePlan() const {
+    const Node& node = nodes[root];
+    if (node.op != OP_AND) return describe(root);
+
+    string plan;
+    for (size_t i = 0; i < node.children.size(); ++i) {
+        if (i > 0) plan += "  →  ";
+        plan += describe(node.children[i]);
+    }
+    return plan;
+}
+
+/**
+ * Exact form of a subtree: operators and level names normalized, operands
+ * as compiled (time bounds as epochs, substrings lowercased, regex patterns
+ * verbatim). Text operands carry their length so no operand can imitate syntax.
+ */
+string FilterQuery::canonical(int index) const {
+    const Node& node = nodes[index];
+    string out;
+    switch (node.op) {
+        case OP_AND:
+        case OP_OR:
+            out = node.op == OP_AND ? "and(" : "or(";
+            for (size_t i = 0; i < node.children.size(); ++i) {
+                if (i > 0) out += ",";
+                out += canonical(node.children[i]);
+            }
+            out += ")";
+            break;
+        case OP_NOT:
+            out = "not(" + canonical(node.children[0]) + ")";
+            break;
+        case OP_LEVEL:
+            out = "level(";
+            for (size_t i = 0; i < node.levelNames.size(); ++i) {
+                out += (i ? "," : "") + std::to_string(node.levelNames[i].size()) + ":" + node.levelNames[i];
+            }
+            out += ")";
+            break;
+        case OP_TIME:
+        case OP_TIME_OF_DAY:
+            out = string(node.op == OP_TIME ? "ts[" : node.low > node.high ? "time-wrap[" : "time[") +
+                  std::to_string(node.low) + "," + std::to_string(node.high) + "]";
+            break;
+        case OP_CONTAINS:
+        case OP_REGEX:
+            out = string(node.op == OP_CONTAINS ? "msg~" : "msg=~") + std::to_string(node.needle.size()) + ":" +
+                  node.needle;
+            break;
+    }
+    return out;
+}
+
+/**
+ * Result cache key of the compiled query
+ * Queries that differ only in spacing or keyword case share a key; quoted
+ * text and regex patterns are compared exactly as they are matched.
+ */
+string FilterQuery::cacheKey() const {
+    return "query:" + canonical(root);
+}
+
+/**
+ * Find the entries matching a compiled query
+ * 
+ * Level terms are answered from the level bitmaps first: a level-only
+ * query needs nothing else, otherwise only the candidates are evaluated
+ * (still skipping blocks the skip index rules out). Queries without
+ * top-level level terms scan the surviving blocks.
+ * 
+ * @param query          Compiled query
+ * @param skippedBlocks  Receives the number of blocks ruled out by the skip index
+ * @param candidateCount Receives the bitmap candidate count (SIZE_MAX if unused)
+ * @param evaluatedCount Receives the number of entries the query was evaluated on
+ * @return               Matching entries; size() is the count, and a level-only
+ *                       query returns the combined level bitmap as is
+ */
+EntryBitmap scanFilterQuery(FilterQuery& query, size_t& skippedBlocks, size_t& candidateCount,
+                            size_t& evaluatedCount) {
+    ScopedTimer timer(PHASE_QUERY);
+    MemoryScope memory(MEMORY_QUERY);
+    EntryBitmap matches;
+    evaluatedCount = 0;
+    auto report = [&]() {
+        if (!profiler.enabled()) return;
+        profiler.count(COUNTER_ENTRIES_SCANNED, evaluatedCount);
+        profiler.count(COUNTER_MATCHES, matches.size());
+    };
+    skippedBlocks = 0;
+    candidateCount = SIZE_MAX;
+
+    EntryBitmap allowed;
+    bool exact = false;
+    if (query.candidates(allowed, exact)) {
+        candidateCount = allowed.size();
+        if (exact) {
+            matches = std::move(allowed);
+            report();
+            return matches;
+        }
+
+        vector<int8_t> blockVerdicts(blockIndex.size(), -1);
+        allowed.forEach([&](uint32_t index) {
+            int8_t& verdict = blockVerdicts[index / LOG_BLOCK_SIZE];
+            if (verdict < 0) {
+                verdict = query.blockMayMatch(blockIndex[index / LOG_BLOCK_SIZE]) ? 1 : 0;
+                if (verdict == 0) skippedBlocks++;
+            }
+            if (verdict == 0) return;
+            evaluatedCount++;
+            if (query.matches(logs[index])) matches.add(index);
+        });
+        report();
+        return matches;
+    }
+
+    for (size_t block = 0; block < blockIndex.size(); ++block) {
+        if (!query.blockMayMatch(blockIndex[block])) {
+            skippedBlocks++;
+            continue;
+        }
+        size_t blockEnd = std::min(logs.size(), (block + 1) * LOG_BLOCK_SIZE);
+        evaluatedCount += blockEnd - block * LOG_BLOCK_SIZE;
+        for (size_t i = block * LOG_BLOCK_SIZE; i < blockEnd; ++i) {
+            if (query.matches(logs[i])) matches.add(static_cast<uint32_t>(i));
+        }
+    }
+    matches.shrink();
+    report();
+    return matches;
+}
+
+/**
+ * Run a composite filter query and let the user view, summarize or export
+ * the results
+ * 
+ * Example: level in (ERROR,WARN) and time between 02:00 and 02:15
+ *          and msg ~ "timeout" and not msg ~ "retry"
+ */
+void queryLogs() {
+    if (logsEmpty()) return;
+    MemoryScope memory(MEMORY_QUERY);  // Result sets and their views
+
+    cout << "\n  " << CYAN << "Fields: level, ts (full timestamp), time (HH:MM[:SS]), msg" << RESET << "\n";
+    cout << "  " << CYAN << "Example: level in (ERROR,WARN) and time between 02:00 and 02:15 and msg ~ \"timeout\"" << RESET << "\n";
+    cout << "\n  " << YELLOW << "Enter query: " << RESET;
+
+    string text;
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    getline(cin, text);
+
+    if (text.empty()) {
+        cerr << RED << "  ✗ No query provided.\n" << RESET;
+        return;
+    }
+
+    FilterQuery query;
+    string error;
+    if (!query.compile(text, error)) {
+        cerr << RED << "  ✗ Invalid query: " << error << "\n" << RESET;
+        return;
+    }
+
+    searchHistory.push_back("[query] " + text);
+
+    // Level bitmaps, then one pass over the surviving blocks (unless cached)
+    auto startTime = std::chrono::steady_clock::now();
+    string key = query.cacheKey();
+    size_t covered = 0;
+    size_t skippedBlocks = 0;
+    size_t candidateCount = SIZE_MAX;
+    size_t evaluated = 0;
+    std::shared_ptr<const EntryBitmap> matches = resultCache.find(key, covered);
+    bool cached = matches != nullptr;
+    if (!cached) {
+        matches = std::make_shared<const EntryBitmap>(
+            scanFilterQuery(query, skippedBlocks, candidateCount, evaluated));
+        resultCache.store(key, matches, logs.size());
+    }
+    EntryView results(logs, matches->toVector());
+    auto elapsedMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - startTime).count();
+
+    cout << "\n  " << CYAN << "Plan: " << RESET << query.describePlan() << "\n";
+    if (cached) {
+        cout << "  " << CYAN << "From result cache" << RESET << "\n";
+    } else {
+        if (candidateCount != SIZE_MAX) {
+            cout << "  " << CYAN << "Level bitmaps: " << RESET << candidateCount << " candidate entries\n";
+        }
+        cout << "  " << CYAN << "Blocks skipped: " << RESET << skippedBlocks << " of " << blockIndex.size()
+             << " (" << evaluated << " entries evaluated)\n";
+    }
+    cout << "  " << GREEN << "✓ " << results.size() << " matching entries in "
+         << fixed << setprecision(1) << elapsedMs << " ms.\n" << RESET;
+
+    if (results.empty()) return;
+
+    // Results feed the regular view, statistics and export
+    while (true) {
+        cout << "\n  " << BRIGHT_CYAN << "QUERY RESULTS" << RESET << "\n";
+        cout << "  1. View Results\n";
+        cout << "  2. Show Statistics\n";
+        cout << "  3. Export Results\n";
+        cout << "  4. Done\n";
+        cout << "\n  " << BRIGHT_CYAN << "Select option (1-4): " << RESET;
+
+        int choice;
+        cin >> choice;
+        if (cin.fail()) {
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            cout << RED << "\n  ✗ Invalid input.\n" << RESET;
+            continue;
+        }
+
+        switch (choice) {
+            case 1: {
+                ostringstream oss;
+                for (const auto& entry : results) {
+                    string levelColor = getLevelColor(entryLevel(entry));
+                    oss << "  " << CYAN << entryTimestamp(entry) << RESET 
+                        << " [" << levelColor << entryLevel(entry) << RESET << "] " 
+                        << entryMessage(entry) << "\n";
+                }
+                cout << "\n" << oss.str();
+                cout << "  " << BRIGHT_CYAN << "─────────────────────────────────────────────────────────────" << RESET << "\n";
+                cout << "  " << BRIGHT_CYAN << "Total: " << results.size() << " entries" << RESET << "\n";
+                break;
+            }
+            case 2: showEntryStatistics(results, "QUERY STATISTICS"); break;
+            case 3: exportLogs(results, "Query: " + text); break;
+            case 4: return;
+            default: cout << RED << "\n  ✗ Invalid option.\n" << RESET; break;
+        }
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// IMPLEMENTATION: STATISTICS DISPLAY
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Display comprehensive log statistics with visual bar charts
+ * 
+ * Features:
+ * - Total entry count
+ * - Bar charts for each log level (max 50 chars wide)
+ * - Percentage calculations
+ * - Time range information (first and last entry timestamps)
+ * - Support for custom/unknown log levels
+ */
+void showStatistics() {
+    if (logsEmpty()) return;
+    showEntryStatistics(logs, "LOG STATISTICS");
+}
+
+/**
+ * Display level statistics and time range for any set of entries
+ * Shared by the main statistics view and query results
+ * 
+ * @param entries Entries to summarize (an EntryView or the LogStore)
+ * @param title   Header text
+ */
+template <typename Entries>
+void showEntryStatistics(const Entries& entries, const string& title) {
+    ScopedTimer timer(PHASE_STATISTICS);
+    MemoryScope memory(MEMORY_QUERY);
+
+    // Count occurrences of each log level by interned id, then resolve each id once;
+    // the same pass finds the earliest and latest timestamps (entries may be unsorted)
+    unordered_map<uint32_t, int> idCount;
+    LogEntry earliest{}, latest{};
+    bool timed = false;
+    for(const auto& entry : entries) {
+        idCount[entry.levelId]++;
+        if (entry.epoch == INVALID_EPOCH) continue;
+        if (!timed || entry.epoch < earliest.epoch) earliest = entry;
+        if (!timed || entry.epoch >= latest.epoch) latest = entry;
+        timed = true;
+    }
+
+    unordered_map<string, int> countMap;
+    int maxCount = 0;
+    for(const auto& pair : idCount) {
+        countMap[string(messagePool.view(pair.first))] = pair.second;
+        maxCount = std::max(maxCount, pair.second);
+    }
+
+    // Display header
+    cout << "\n  " << BRIGHT_CYAN << "════════════════════════════════════════════════════════════" << RESET << "\n";
+    cout << "  " << BRIGHT_CYAN << title << RESET << "\n";
+    cout << "  " << BRIGHT_CYAN << "════════════════════════════════════════════════════════════" << RESET << "\n\n";
+    cout << "  " << BRIGHT_CYAN << "Total Entries: " << entries.size() << RESET << "\n\n";
+
+    // Standard log levels to display first
+    vector<string> levels = {"INFO", "WARN", "ERROR"};
+
+    // Display statistics for standard levels
+    for(const auto& level : levels) {
+        if(countMap.find(level) == countMap.end()) continue;
+        
+        int count = countMap[level];
+        string levelColor = getLevelColor(level);
+        double percentage = entries.empty() ? 0.0 : (count * 100.0 / entries.size());
+
+        // Create visual bar chart (proportional to count, max 50 chars)
+        int barLength = maxCount > 0 ? (count * 50) / maxCount : 0;
+        string bar;
+        for(int i = 0; i < barLength; ++i) bar += "█";
+
+        cout << "  " << levelColor << std::left << std::setw(8) << level << RESET 
+             << " " << levelColor << bar << RESET 
+             << " " << count << " (" << fixed << setprecision(1) << percentage << "%)\n";
+    }
+
+    // Display any custom/unknown log levels
+    for(const auto& pair : countMap) {
+        if (std::find(levels.begin(), levels.end(), pair.first) == levels.end()) {
+            double percentage = entries.empty() ? 0.0 : (pair.second * 100.0 / entries.size());
+            int barLength = maxCount > 0 ? (pair.second * 50) / maxCount : 0;
+            string bar;
+            for(int i = 0; i < barLength; ++i) bar += "█";
+
+            cout << "  " << CYAN << std::left << std::setw(8) << pair.first << RESET 
+                 << " " << CYAN << bar << RESET 
+                 << " " << pair.second << " (" << fixed << setprecision(1) << percentage << "%)\n";
+        } 
+    }
+
+    // Display time range information
+    if (timed) {
+        cout << "\n  " << BRIGHT_CYAN << "─────────────────────────────────────────────────────────────" << RESET << "\n";
+        cout << "  " << CYAN << "First Entry: " << RESET << entryTimestamp(earliest) << "\n";
+        cout << "  " << CYAN << "Last Entry:  " << RESET << entryTimestamp(latest) << "\n";
+    }
+    
+    cout << "\n";
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// IMPLEMENTATION: VIEW SEARCH HISTORY
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Display all previous search queries
+ * Shows numbered list of all searches performed in current session
+ */
+void viewSearchHistory() {
+    if (searchHistory.empty()) {
+        cout << YELLOW << "\n  ⚠ No search history available.\n" << RESET;
+        return;
+    }
+
+    cout << "\n  " << BRIGHT_CYAN << "════════════════════════════════════════════════════════════" << RESET << "\n";
+    cout << "  " << BRIGHT_CYAN << "SEARCH HISTORY" << RESET << "\n";
+    cout << "  " << BRIGHT_CYAN << "════════════════════════════════════════════════════════════" << RESET << "\n\n";
+
+    // Display each search with index number
+    // Searches whose results are still kept show their refinement chain and size
+    unordered_map<size_t, const SearchStep*> stored;
+    for (const SearchStep& step : searchSteps) stored[step.historyIndex] = &step;
+    const SearchStep* current = currentStep < searchSteps.size() ? &searchSteps[currentStep] : nullptr;
+    for (size_t i = 0; i < searchHistory.size(); ++i) {
+        cout << "  " << CYAN << (i + 1) << ". " << RESET << searchHistory[i];
+        auto step = stored.find(i);
+        if (step != stored.end()) {
+            cout << CYAN << "  [" << step->second->chain << ": " << step->second->matches.size() << " results"
+                 << (step->second == current ? ", current" : "")
+                 << "]" << RESET;
+        }
+        cout << "\n";
+    }
+
+    // Result cache effectiveness
+    size_t lookups = resultCache.hitCount() + resultCache.missCount();
+    cout << "\n  " << CYAN << "ℹ Result cache: " << resultCache.entryCount() << " results, "
+         << formatBytes(resultCache.memoryBytes()) << " of " << formatBytes(resultCache.capacityBytes()) << ", "
+         << resultCache.hitCount() << " hits / " << resultCache.missCount() << " misses";
+    if (lookups > 0) {
+        cout << " (" << fixed << setprecision(1) << (resultCache.hitCount() * 100.0 / lookups) << "% hit rate)";
+    }
+    cout << ", " << resultCache.evictionCount() << " evicted" << RESET << "\n";
+
+    // Jump back to an earlier search or refinement level; its results are kept, not recomputed
+    if (searchSteps.empty()) {
+        cout << "\n";
+        return;
+    }
+    string choice;
+    cout << "\n  " << GREEN << "Reopen search results by number (blank = back): " << RESET;
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    getline(cin, choice);
+    if (choice.empty()) return;
+
+    size_t number = 0;
+    try {
+        number = std::stoul(choice);
+    } catch (...) {
+        number = 0;
+    }
+    auto step = std::find_if(searchSteps.begin(), searchSteps.end(),
+                             [number](const SearchStep& item) { return item.historyIndex + 1 == number; });
+    if (step == searchSteps.end()) {
+        cerr << RED << "  ✗ No stored results for entry " << choice << " (only keyword searches are kept).\n" << RESET;
+        return;
+    }
+
+    currentStep = static_cast<size_t>(step - searchSteps.begin());
+    vector<uint32_t> matches = step->matches.toVector();
+    cout << "\n  " << BRIGHT_CYAN << "RESULTS FOR: " << step->chain << RESET << "\n\n";
+    for (size_t i = 0; i < matches.size() && i < SEARCH_STREAM_LIMIT; ++i) printLogEntry(logs[matches[i]]);
+    if (matches.size() > SEARCH_STREAM_LIMIT) {
+        cout << "  " << YELLOW << "... and " << (matches.size() - SEARCH_STREAM_LIMIT) << " more matches\n" << RESET;
+    }
+    cout << "\n  " << GREEN << "✓ " << matches.size() << " results restored; the next +keyword search refines them.\n\n" << RESET;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// IMPLEMENTATION: EXPORT LOGS TO FILE
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Write entries to an export file: header, level statistics, time range
+ * and one line per entry (or per run while collapse is on)
+ * 
+ * @param entries     Entries to write
+ * @param description Filter description for the header
+ * @param path        Output file
+ * @return            false if the file could not be created or written
+ */
+template <typename Entries>
+bool writeExportFile(const Entries& entries, const string& description, const string& path) {
+    std::ofstream outFile(path);
+    if (!outFile.is_open()) return false;
+    auto time_t_now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+
+    // Write file header
+    outFile << "========================================\n";
+    outFile << "LOG ANALYZER EXPORT\n";
+    outFile << description << "\n";
+    outFile << "Exported: " 
+            << std::put_time(std::localtime(&time_t_now), "%Y-%m-%d %H:%M:%S") 
+            << "\n";
+    outFile << "Total Entries: " << entries.size() << "\n";
+    outFile << "========================================\n\n";
+
+    // Calculate statistics and the earliest/latest timestamps for export
+    unordered_map<uint32_t, int> levelCount;
+    LogEntry earliest{}, latest{};
+    bool timed = false;
+    for(const auto& entry : entries) {
+        levelCount[entry.levelId]++;
+        if (entry.epoch == INVALID_EPOCH) continue;
+        if (!timed || entry.epoch < earliest.epoch) earliest = entry;
+        if (!timed || entry.epoch >= latest.epoch) latest = entry;
+        timed = true;
+    }
+
+    // Write statistics section
+    outFile << "\n--- Statistics ---\n";
+    for (const auto& pair : levelCount) {
+        double percentage = (pair.second * 100.0) / entries.size();
+        outFile << messagePool.view(pair.first) << ": " << pair.second 
+                << " (" << fixed << setprecision(1) << percentage << "%)\n";
+    }
+
+    // Write time range if any entry has a valid timestamp
+    if(timed) {
+        outFile << "\nTime Range:\n";
+        outFile << "  First: " << entryTimestamp(earliest) << "\n";
+        outFile << "  Last:  " << entryTimestamp(latest) << "\n";
+    }
+    outFile << "========================================\n\n";
+
+    // Write all log entries (repeats folded into one line per run when collapse is on)
+    RunCollapser collapser(collapseMode);
+    CollapsedRun run;
+    for(const auto& entry : entries) {
+        if (collapseMode != COLLAPSE_OFF) {
+            if (collapser.push(entry, run)) writeCollapsedRun(outFile, run, false);
+            continue;
+        }
+        outFile << entryTimestamp(entry) << " [" << entryLevel(entry) << "] " 
+                << entryMessage(entry) << "\n";
+    }
+    if (collapser.flush(run)) writeCollapsedRun(outFile, run, false);
+
+    outFile.close();
+    return !outFile.fail();
+}
+
+/**
+ * Export log entries to a timestamped text file
+ * 
+ * Features:
+ * - Automatically adds timestamp to filename (YYYYMMDD_HHMMSS format)
+ * - Includes comprehensive header with metadata
+ * - Shows export description and entry count
+ * - Creates file in current working directory
+ * 
+ * @param entries     Log entries to export (an EntryView or the LogStore)
+ * @param description Description of the filter/search used
+ */
+template <typename Entries>
+void exportLogs(const Entries& entries, const string& description) {
+    if(entries.empty()) {
+        cout << RED << "\n  ✗ No logs to export.\n" << RESET;
+        return;
+    }
+
+    // Get filename from user
+    string filename;
+    cout << "\n  " << GREEN << "Enter export filename (without extension): " << RESET;
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    getline(cin, filename);
+
+    // Validate filename
+    if(filename.empty()) {
+        cerr << RED << "  ✗ No filename provided.\n" << RESET;
+        return;
+    }
+
+    ScopedTimer timer(PHASE_EXPORT);
+
+    // Generate timestamped filename to avoid overwriting
+    auto now = std::chrono::system_clock::now();
+    auto time_t_now = std::chrono::system_clock::to_time_t(now);
+    ostringstream oss;
+    oss << filename << "_" 
+        << std::put_time(std::localtime(&time_t_now), "%Y%m%d_%H%M%S") 
+        << ".txt";
+    string fullFilename = oss.str();
+
+    if (!writeExportFile(entries, description, fullFilename)) {
+        cerr << RED << "  ✗ Could not create export file.\n" << RESET;
+        return;
+    }
+    timer.stop();
+    if (profiler.enabled()) profiler.count(COUNTER_EXPORTED, entries.size());
+    
+    // Confirm successful export
+    cout << GREEN << "  ✓ Exported " << entries.size() 
+         << " entries to " << fullFilename << "\n" << RESET;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// IMPLEMENTATION: EXPORT MENU
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Display export menu and handle user selection
+ * Allows exporting logs filtered by level or all logs
+ */
+void exportMenu() {
+    if(logsEmpty()) return;
+
+    // Display export options
+    cout << "\n  " << BRIGHT_CYAN << "EXPORT OPTIONS" << RESET << "\n";
+    cout << "  1. Export All Logs\n";
+    cout << "  2. Export INFO Logs\n";
+    cout << "  3. Export WARN Logs\n";
+    cout << "  4. Export ERROR Logs\n";
+    cout << "  5. Cancel\n";
+    cout << "\n  " << BRIGHT_CYAN << "Select option (1-5): " << RESET;
+
+    int choice;
+    cin >> choice;
+
+    // Handle invalid input
+    if(cin.fail()) {
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        cout << RED << "\n  ✗ Invalid input.\n" << RESET;
+        return;
+    }
+
+    // Execute export based on user choice
+    switch (choice) {
+        case 1: exportLogs(logs, "Filter: ALL"); break;
+        case 2: exportLogs(getFilteredLogs("INFO"), "Filter: INFO"); break;
+        case 3: exportLogs(getFilteredLogs("WARN"), "Filter: WARN"); break;
+        case 4: exportLogs(getFilteredLogs("ERROR"), "Filter: ERROR"); break;
+        case 5: cout << YELLOW << "  Export cancelled.\n" << RESET; break;
+        default: cout << RED << "\n  ✗ Invalid option.\n" << RESET; break;
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// IMPLEMENTATION: TIME SORT
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Run a task on several threads and wait for all of them
+ * The calling thread runs worker 0 itself; workers inherit its memory tag
+ * 
+ * @param workerCount Number of workers (at least 1)
+ * @param traceName   Span name of each worker in traces
+ * @param task        Callable taking the worker number
+ */
+template <typename Task>
+static void runOnWorkers(unsigned workerCount, const char* traceName, const Task& task) {
+    auto traced = [traceName, tag = MemoryScope::current(), &task](unsigned w) {
+        TraceSpan span(traceName);
+        MemoryScope memory(tag);
+        task(w);
+    };
+    vector<std::thread> workers;
+    for (unsigned w = 1; w < workerCount; ++w) workers.emplace_back(traced, w);
+    traced(0u);
+    for (auto& t : workers) t.join();
+}
+
+/**
+ * Stable parallel LSD radix sort of (key, entry index) pairs
+ * 
+ * Each pass sorts on one byte: workers histogram their own slice, the
+ * counts are turned into per-worker output offsets (digit-major, then
+ * worker order, which keeps equal keys in input order), and every worker
+ * scatters its slice independently. Only the bytes needed to represent
+ * the largest key are processed, so a day of timestamps (relative to the
+ * minimum) sorts in three passes.
+ * 
+ * @param keys Pairs to sort in place
+ */
+void radixSortKeys(vector<SortKey>& keys) {
+    const size_t count = keys.size();
+    if (count < 2) return;
+
+    uint64_t maxKey = 0;
+    for (const SortKey& k : keys) maxKey = std::max(maxKey, k.key);
+
+    unsigned workerCount = std::max(1u, std::thread::hardware_concurrency());
+    workerCount = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(workerCount, count / SORT_MIN_SLICE)));
+
+    vector<SortKey> buffer(count);
+    vector<std::array<size_t, 256>> offsets(workerCount);
+    auto sliceBegin = [&](unsigned w) { return count * w / workerCount; };
+
+    for (unsigned shift = 0; shift < 64 && (maxKey >> shift) != 0; shift += 8) {
+        // Per-worker histograms of this byte
+        runOnWorkers(workerCount, "sort.histogram", [&](unsigned w) {
+            auto& histogram = offsets[w];
+            histogram.fill(0);
+            for (size_t i = sliceBegin(w); i < sliceBegin(w + 1); ++i) {
+                histogram[(keys[i].key >> shift) & 0xFF]++;
+            }
+        });
+
+        // Exclusive prefix sum in (digit, worker) order
+        size_t position = 0;
+        for (size_t digit = 0; digit < 256; ++digit) {
+            for (unsigned w = 0; w < workerCount; ++w) {
+                size_t bucketCount = offsets[w][digit];
+                offsets[w][digit] = position;
+                position += bucketCount;
+            }
+        }
+
+        // Scatter each slice into its reserved ranges
+        runOnWorkers(workerCount, "sort.scatter", [&](unsigned w) {
+            auto& next = offsets[w];
+            for (size_t i = sliceBegin(w); i < sliceBegin(w + 1); ++i) {
+                buffer[next[(keys[i].key >> shift) & 0xFF]++] = keys[i];
+            }
+        });
+        keys.swap(buffer);
+    }
+}
+
+/**
+ * Stable external merge sort for key sets larger than the memory budget
+ * 
+ * Sorts runs of runCapacity pairs with the radix sort, spills each run to a
+ * temporary file, then k-way merges the runs back into keys. The merge ties
+ * on run number, so equal keys keep their input order. Extra memory stays
+ * at one run plus a small read buffer per run, instead of a full copy.
+ * 
+ * @param keys        Pairs to sort in place
+ * @param runCapacity Pairs per in-memory run
+ * @param error       Output message on failure
+ * @return            true if sorted, false on an I/O error
+ */
+bool externalSortKeys(vector<SortKey>& keys, size_t runCapacity, string& error) {
+    namespace fs = std::filesystem;
+    const size_t count = keys.size();
+    const size_t runCount = (count + runCapacity - 1) / runCapacity;
+    const string stamp = std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+
+    vector<fs::path> runFiles;
+    auto removeRuns = [&runFiles]() {
+        std::error_code ignored;
+        for (const auto& path : runFiles) fs::remove(path, ignored);
+    };
+
+    // Phase 1: sort and spill runs
+    for (size_t r = 0; r < runCount; ++r) {
+        size_t begin = r * runCapacity;
+        size_t end = std::min(count, begin + runCapacity);
+        vector<SortKey> run(keys.begin() + begin, keys.begin() + end);
+        radixSortKeys(run);
+
+        fs::path path = fs::temp_directory_path() / ("log_analyzer_sort_" + stamp + "_" + std::to_string(r) + ".tmp");
+        runFiles.push_back(path);
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(run.data()), static_cast<std::streamsize>(run.size() * sizeof(SortKey)));
+        if (!out) {
+            error = "Could not write sort run " + path.string();
+            removeRuns();
+            return false;
+        }
+    }
+
+    // Phase 2: k-way merge with buffered run readers
+    struct RunReader {
+        ifstream in;
+        vector<SortKey> buffer;
+        size_t position = 0;
+        size_t remaining = 0;  // Pairs not yet read from the file
+
+        bool refill() {
+            size_t take = std::min(remaining, buffer.capacity());
+            buffer.resize(take);
+            in.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(take * sizeof(SortKey)));
+            remaining -= take;
+            position = 0;
+            return take > 0 && in;
+        }
+    };
+
+    vector<RunReader> readers(runCount);
+    using HeapItem = std::pair<uint64_t, size_t>;  // (key, run number)
+    std::priority_queue<HeapItem, vector<HeapItem>, std::greater<HeapItem>> heap;
+
+    for (size_t r = 0; r < runCount; ++r) {
+        readers[r].in.open(runFiles[r], std::ios::binary);
+        readers[r].buffer.reserve(SORT_MERGE_BUFFER);
+        readers[r].remaining = std::min(count, (r + 1) * runCapacity) - r * runCapacity;
+        if (!readers[r].refill()) {
+            error = "Could not read sort run " + runFiles[r].string();
+            removeRuns();
+            return false;
+        }
+        heap.push({readers[r].buffer[0].key, r});
+    }
+
+    size_t output = 0;
+    while (!heap.empty()) {
+        size_t r = heap.top().second;
+        heap.pop();
+
+        RunReader& reader = readers[r];
+        keys[output++] = reader.buffer[reader.position++];
+        if (reader.position == reader.buffer.size() && reader.remaining > 0 && !reader.refill()) {
+            error = "Could not read sort run " + runFiles[r].string();
+            removeRuns();
+            return false;
+        }
+        if (reader.position < reader.buffer.size()) heap.push({reader.buffer[reader.position].key, r});
+    }
+
+    removeRuns();
+    return true;
+}
+
+/**
+ * Reorder the loaded logs by normalized timestamp
+ * 
+ * Entries with the same second keep their file order, and entries whose
+ * timestamp could not be parsed move to the end. Key sets within the
+ * sort budget (SORT_MEMORY_BUDGET, or a share of --max-memory) use the
+ * parallel radix sort; larger ones use the external merge sort. The skip index is rebuilt afterwards, which also tightens
+ * the per-block time bounds for time-range views.
+ */
+void sortLogsByTime() {
+    if (logsEmpty()) return;
+    ScopedTimer timer(PHASE_SORT);
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    // Check whether the file is already in time order; entries without a
+    // timestamp only force a sort when a valid entry follows them
+    int64_t previous = INT64_MIN;
+    bool sawInvalid = false;
+    bool invalidInside = false;
+    size_t outOfOrder = 0;
+    int64_t minEpoch = INT64_MAX;
+    for (const LogEntry& entry : logs) {
+        if (entry.epoch == INVALID_EPOCH) {
+            sawInvalid = true;
+            continue;
+        }
+        if (entry.epoch < previous) outOfOrder++;
+        invalidInside = invalidInside || sawInvalid;
+        previous = std::max(previous, entry.epoch);
+        minEpoch = std::min(minEpoch, entry.epoch);
+    }
+    if (outOfOrder == 0 && !invalidInside) {
+        cout << GREEN << "\n  ✓ Logs are already in time order.\n" << RESET;
+        return;
+    }
+
+    // Keys are relative to the earliest entry so fewer radix passes are needed
+    vector<SortKey> keys;
+    vector<uint32_t> invalid;
+    keys.reserve(logs.size());
+    for (size_t i = 0; i < logs.size(); ++i) {
+        if (logs[i].epoch == INVALID_EPOCH) {
+            invalid.push_back(static_cast<uint32_t>(i));
+        } else {
+            keys.push_back({static_cast<uint64_t>(logs[i].epoch - minEpoch), static_cast<uint32_t>(i)});
+        }
+    }
+
+    // Radix sort needs a second key array; fall back to runs if that exceeds the budget
+    size_t sortBudget = SORT_MEMORY_BUDGET;
+    if (logs.memoryBudget() > 0) sortBudget = std::min(sortBudget, logs.memoryBudget() / SORT_BUDGET_SHARE);
+    size_t runCapacity = std::max(sortBudget / (2 * sizeof(SortKey)), SORT_MIN_SLICE);
+    bool external = keys.size() > runCapacity;
+    if (external) {
+        string error;
+        if (!externalSortKeys(keys, runCapacity, error)) {
+            cerr << RED << "  ✗ Sort failed: " << error << "\n" << RESET;
+            return;
+        }
+    } else {
+        radixSortKeys(keys);
+    }
+
+    // Apply the permutation into a fresh store under the same memory budget
+    // (the old store and the keys are still resident while it fills)
+    LogStore sorted;
+    sorted.setMemoryBudget(logs.memoryBudget());
+    sorted.setReservedBytes(budgetReservedBytes(logs.size()) + logs.residentBytes() + keys.capacity() * sizeof(SortKey));
+    for (const SortKey& k : keys) sorted.push_back(logs[k.index]);
+    for (uint32_t index : invalid) sorted.push_back(logs[index]);
+    logs.swap(sorted);
+    logs.setReservedBytes(budgetReservedBytes(logs.size()));
+    resultCache.clear();  // Cached indices refer to the old order
+    searchSteps.clear();
+    currentStep = SIZE_MAX;
+    sorted.clear();
+    buildBlockIndex();
+
+    double elapsedMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - startTime).count();
+
+    cout << GREEN << "\n  ✓ Sorted " << logs.size() << " entries by time in " 
+         << fixed << setprecision(1) << elapsedMs << " ms" 
+         << (external ? " (external merge)" : " (parallel radix)") << ".\n" << RESET;
+    cout << CYAN << "  ℹ " << outOfOrder << " entries were out of order";
+    if (!invalid.empty()) cout << "; " << invalid.size() << " without a valid timestamp moved to the end";
+    cout << ".\n" << RESET;
+    cout << CYAN << "  ℹ Time range: " << entryTimestamp(logs.front()) << " → " 
+         << entryTimestamp(logs[keys.size() - 1]) << "\n" << RESET;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// IMPLEMENTATION: COLUMNAR ARCHIVE
+// ═══════════════════════════════════════════════════════════════════════════
+
+/*
+ * Archive layout (.lga), all integers LEB128 varints unless noted:
+ *   "LGAR" u32 version
+ *   block payloads, each: rows, then five columns stored as
+ *   (method, raw size, stored size, bytes) where method 1 is the LZ coder
+ *     time     zigzag epoch deltas (first delta is from the block minimum)
+ *     format   RLE runs of (TimestampFormat, count)
+ *     level    RLE runs of (level dictionary index, count)
+ *     message  block dictionary (count, then length + bytes per string)
+ *              followed by one dictionary index per row
+ *     rawTime  length + bytes for each TIMESTAMP_RAW row
+ *   footer: level dictionary, then per block offset, bytes, rows,
+ *           zigzag min/max epoch and one count per level
+ *   u64 footer offset (little endian) "LGAR"
+ */
+
+static void putVarint(string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+static bool getVarint(const char*& cursor, const char* end, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && cursor < end; shift += 7) {
+        uint8_t byte = static_cast<uint8_t>(*cursor++);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;  // Truncated or over-long
+}
+
+static uint64_t zigzag(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+static int64_t unzigzag(uint64_t value) {
+    return static_cast<int64_t>((value >> 1) ^ (~(value & 1) + 1));
+}
+
+static void putBytes(string& out, string_view text) {
+    putVarint(out, text.size());
+    out.append(text.data(), text.size());
+}
+
+static bool getBytes(const char*& cursor, const char* end, string_view& text) {
+    uint64_t length;
+    if (!getVarint(cursor, end, length) || length > static_cast<uint64_t>(end - cursor)) return false;
+    text = string_view(cursor, static_cast<size_t>(length));
+    cursor += length;
+    return true;
+}
+
+static void putLzLength(string& out, size_t length) {
+    while (length >= 255) {
+        out.push_back(static_cast<char>(255));
+        length -= 255;
+    }
+    out.push_back(static_cast<char>(length));
+}
+
+/**
+ * Compress bytes with a greedy LZ77 coder using LZ4-style sequences
+ * 
+ * Each sequence is a token (literal length, match length - 4 in two
+ * nibbles, 15 meaning "more length bytes follow"), the literals, and a
+ * 2-byte offset into the previous 64 KB. The final sequence has literals
+ * only. Matches are found through a hash of the next 4 bytes, so one pass
+ * over the input is enough.
+ * 
+ * @param input Bytes to compress
+ * @return      Compressed bytes
+ */
+static string lzCompress(string_view input) {
+    const char* src = input.data();
+    const size_t size = input.size();
+    string out;
+    out.reserve(size / 2 + 16);
+
+    vector<int64_t> table(size_t(1) << ARCHIVE_LZ_HASH_BITS, -1);
+    size_t anchor = 0;
+    auto emit = [&](size_t literalEnd, size_t matchLength, size_t offset) {
+        size_t literalLength = literalEnd - anchor;
+        size_t matchCode = matchLength > 0 ? matchLength - ARCHIVE_LZ_MIN_MATCH : 0;
+        out.push_back(static_cast<char>((std::min<size_t>(literalLength, 15) << 4) | std::min<size_t>(matchCode, 15)));
+        if (literalLength >= 15) putLzLength(out, literalLength - 15);
+        out.append(src + anchor, literalLength);
+        if (matchLength > 0) {
+            out.push_back(static_cast<char>(offset & 0xFF));
+            out.push_back(static_cast<char>(offset >> 8));
+            if (matchCode >= 15) putLzLength(out, matchCode - 15);
+        }
+    };
+
+    size_t i = 0;
+    while (i + ARCHIVE_LZ_MIN_MATCH <= size) {
+        uint32_t sequence;
+        std::memcpy(&sequence, src + i, sizeof(sequence));
+        uint32_t slot = (sequence * 2654435761u) >> (32 - ARCHIVE_LZ_HASH_BITS);
+        int64_t candidate = table[slot];
+        table[slot] = static_cast<int64_t>(i);
+
+        if (candidate >= 0 && i - candidate <= 0xFFFF && std::memcmp(src + candidate, src + i, ARCHIVE_LZ_MIN_MATCH) == 0) {
+            size_t length = ARCHIVE_LZ_MIN_MATCH;
+            while (i + length < size && src[candidate + length] == src[i + length]) length++;
+            emit(i, length, i - static_cast<size_t>(candidate));
+            i += length;
+            anchor = i;
+        } else {
+            i++;
+        }
+    }
+    emit(size, 0, 0);
+    return out;
+}
+
+/**
+ * Decompress the output of lzCompress()
+ * 
+ * @param input   Compressed bytes
+ * @param rawSize Expected decompressed size
+ * @param out     Output bytes
+ * @return        false if the input is corrupt
+ */
+static bool lzDecompress(string_view input, size_t rawSize, string& out) {
+    out.clear();
+    out.reserve(rawSize);
+    const uint8_t* cursor = reinterpret_cast<const uint8_t*>(input.data());
+    const uint8_t* end = cursor + input.size();
+
+    auto readLength = [&cursor, end](size_t& length) {
+        uint8_t byte;
+        do {
+            if (cursor >= end) return false;
+            byte = *cursor++;
+            length += byte;
+        } while (byte == 255);
+        return true;
+    };
+
+    while (cursor < end) {
+        uint8_t token = *cursor++;
+        size_t literalLength = token >> 4;
+        if (literalLength == 15 && !readLength(literalLength)) return false;
+        if (literalLength > static_cast<size_t>(end - cursor) || out.size() + literalLength > rawSize) return false;
+        out.append(reinterpret_cast<const char*>(cursor), literalLength);
+        cursor += literalLength;
+        if (cursor == end) break;  // Final sequence: literals only
+
+        if (end - cursor < 2) return false;
+        size_t offset = cursor[0] | (static_cast<size_t>(cursor[1]) << 8);
+        cursor += 2;
+        size_t matchLength = token & 0x0F;
+        if (matchLength == 15 && !readLength(matchLength)) return false;
+        matchLength += ARCHIVE_LZ_MIN_MATCH;
+        if (offset == 0 || offset > out.size() || out.size() + matchLength > rawSize) return false;
+
+        size_t from = out.size() - offset;
+        for (size_t k = 0; k < matchLength; ++k) out.push_back(out[from + k]);  // May overlap itself
+    }
+    return out.size() == rawSize;
+}
+
+/**
+ * Append a column, LZ-compressed when that makes it smaller
+ */
+static void putColumn(string& out, const string& column) {
+    string compressed = lzCompress(column);
+    bool useLz = compressed.size() < column.size();
+    const string& stored = useLz ? compressed : column;
+    putVarint(out, useLz ? 1 : 0);
+    putVarint(out, column.size());
+    putBytes(out, stored);
+}
+
+/**
+ * Read a column written by putColumn()
+ */
+static bool getColumn(const char*& cursor, const char* end, string& column) {
+    uint64_t method, rawSize;
+    string_view stored;
+    if (!getVarint(cursor, end, method) || !getVarint(cursor, end, rawSize) || !getBytes(cursor, end, stored)) {
+        return false;
+    }
+    if (method == 0) {
+        column.assign(stored.data(), stored.size());
+        return stored.size() == rawSize;
+    }
+    return method == 1 && rawSize <= ARCHIVE_MAX_COLUMN_BYTES && lzDecompress(stored, static_cast<size_t>(rawSize), column);
+}
+
+/**
+ * Append a run-length encoded column of small integers
+ */
+template <typename ValueOf>
+static void putRuns(string& out, size_t begin, size_t end, const ValueOf& valueOf) {
+    size_t i = begin;
+    while (i < end) {
+        uint64_t value = valueOf(i);
+        size_t run = 1;
+        while (i + run < end && valueOf(i + run) == value) run++;
+        putVarint(out, value);
+        putVarint(out, run);
+        i += run;
+    }
+}
+
+/**
+ * Encode entries [begin, end) of the loaded logs as one archive block
+ * 
+ * @param begin      First entry
+ * @param end        One past the last entry
+ * @param levelIndex Pool level id -> archive level index
+ * @param info       Output block header (offset is filled by the caller)
+ * @return           Encoded payload
+ */
+static string encodeArchiveBlock(size_t begin, size_t end, const unordered_map<uint32_t, uint32_t>& levelIndex,
+                                 ArchiveBlockInfo& info) {
+    info.rows = static_cast<uint32_t>(end - begin);
+    for (size_t i = begin; i < end; ++i) {
+        const LogEntry& entry = logs[i];
+        info.levelCounts[levelIndex.at(entry.levelId)]++;
+        if (entry.epoch != INVALID_EPOCH) {
+            info.minEpoch = std::min(info.minEpoch, entry.epoch);
+            info.maxEpoch = std::max(info.maxEpoch, entry.epoch);
+        }
+    }
+
+    // Timestamps: deltas from the previous row (wrapping, so INVALID_EPOCH round-trips)
+    string timeColumn;
+    uint64_t previous = static_cast<uint64_t>(info.minEpoch == INT64_MAX ? 0 : info.minEpoch);
+    for (size_t i = begin; i < end; ++i) {
+        uint64_t epoch = static_cast<uint64_t>(logs[i].epoch);
+        putVarint(timeColumn, zigzag(static_cast<int64_t>(epoch - previous)));
+        previous = epoch;
+    }
+
+    string formatColumn, levelColumn;
+    putRuns(formatColumn, begin, end, [](size_t i) { return static_cast<uint64_t>(logs[i].format); });
+    putRuns(levelColumn, begin, end, [&levelIndex](size_t i) { return static_cast<uint64_t>(levelIndex.at(logs[i].levelId)); });
+
+    // Messages: block dictionary in first-appearance order, then one index per row
+    unordered_map<string_view, uint32_t, StringViewHash> dictionary;
+    vector<string_view> words;
+    string indexBytes, rawTimeColumn;
+    for (size_t i = begin; i < end; ++i) {
+        string_view message = entryMessage(logs[i]);
+        auto inserted = dictionary.emplace(message, static_cast<uint32_t>(words.size()));
+        if (inserted.second) words.push_back(message);
+        putVarint(indexBytes, inserted.first->second);
+        if (logs[i].format == TIMESTAMP_RAW) putBytes(rawTimeColumn, messagePool.view(logs[i].timestampId));
+    }
+    string messageColumn;
+    putVarint(messageColumn, words.size());
+    for (string_view word : words) putBytes(messageColumn, word);
+    messageColumn += indexBytes;
+
+    string payload;
+    putVarint(payload, info.rows);
+    for (const string* column : {&timeColumn, &formatColumn, &levelColumn, &messageColumn, &rawTimeColumn}) {
+        putColumn(payload, *column);
+    }
+    info.bytes = payload.size();
+    return payload;
+}
+
+/**
+ * Write the loaded logs as a block-compressed columnar archive
+ * 
+ * @param path      Output file
+ * @param textBytes Output approximate size of the same entries as log text
+ * @param error     Output message on failure
+ * @return          true if the archive was written
+ */
+bool writeArchive(const string& path, size_t& textBytes, string& error) {
+    // File-wide level dictionary (levels are few, so counts fit in every header)
+    ArchiveDirectory directory;
+    unordered_map<uint32_t, uint32_t> levelIndex;
+    textBytes = 0;
+    for (const LogEntry& entry : logs) {
+        if (levelIndex.emplace(entry.levelId, static_cast<uint32_t>(directory.levels.size())).second) {
+            directory.levels.emplace_back(entryLevel(entry));
+        }
+        textBytes += 19 + entryLevel(entry).size() + entryMessage(entry).size() + 4;
+    }
+
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open()) {
+        error = "Could not create " + path;
+        return false;
+    }
+    // Header: magic, version, and the UTC offset the epochs were decoded with
+    const uint32_t version = ARCHIVE_VERSION;
+    char utcOffset[8];
+    for (int i = 0; i < 8; ++i) utcOffset[i] = static_cast<char>((static_cast<uint64_t>(logUtcOffset) >> (8 * i)) & 0xFF);
+    out.write(ARCHIVE_MAGIC, 4);
+    out.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    out.write(utcOffset, sizeof(utcOffset));
+
+    uint64_t offset = 16;
+    for (size_t begin = 0; begin < logs.size(); begin += ARCHIVE_BLOCK_ROWS) {
+        ArchiveBlockInfo info;
+        info.levelCounts.assign(directory.levels.size(), 0);
+        string payload = encodeArchiveBlock(begin, std::min(logs.size(), begin + ARCHIVE_BLOCK_ROWS), levelIndex, info);
+        info.offset = offset;
+        out.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+        offset += payload.size();
+        directory.blocks.push_back(std::move(info));
+    }
+
+    // Footer: everything needed for statistics without touching a block
+    string footer;
+    putVarint(footer, directory.levels.size());
+    for (const string& level : directory.levels) putBytes(footer, level);
+    putVarint(footer, directory.blocks.size());
+    for (const ArchiveBlockInfo& info : directory.blocks) {
+        putVarint(footer, info.offset);
+        putVarint(footer, info.bytes);
+        putVarint(footer, info.rows);
+        putVarint(footer, zigzag(info.minEpoch));
+        putVarint(footer, zigzag(info.maxEpoch));
+        for (uint64_t count : info.levelCounts) putVarint(footer, count);
+    }
+    char tail[12];
+    for (int i = 0; i < 8; ++i) tail[i] = static_cast<char>((offset >> (8 * i)) & 0xFF);
+    std::memcpy(tail + 8, ARCHIVE_MAGIC, 4);
+    out.write(footer.data(), static_cast<std::streamsize>(footer.size()));
+    out.write(tail, sizeof(tail));
+
+    if (!out) {
+        error = "Write failed for " + path;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Read the level dictionary and block headers from an archive footer
+ * No block payload is read
+ * 
+ * @param path      Archive file
+ * @param directory Output directory
+ * @param error     Output message on failure
+ * @return          true if the footer is valid
+ */
+bool readArchiveDirectory(const string& path, ArchiveDirectory& directory, string& error) {
+    ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        error = "Could not open " + path;
+        return false;
+    }
+
+    char head[16];
+    char tail[12];
+    in.read(head, sizeof(head));
+    in.clear();  // Shortest archives hold fewer bytes than a version 2 header
+    in.seekg(0, std::ios::end);
+    uint64_t fileSize = static_cast<uint64_t>(in.tellg());
+    if (!in || fileSize < 8 + sizeof(tail) || std::memcmp(head, ARCHIVE_MAGIC, 4) != 0) {
+        error = "Not a log archive: " + path;
+        return false;
+    }
+    uint32_t version;
+    std::memcpy(&version, head + 4, sizeof(version));
+    if (version != 1 && version != ARCHIVE_VERSION) {
+        error = "Unsupported archive version " + std::to_string(version);
+        return false;
+    }
+    // Version 1 had no offset; those archives were written before --timezone existed, i.e. in UTC
+    uint64_t headerBytes = version == 1 ? 8 : 16;
+    uint64_t utcOffset = 0;
+    for (int i = 0; version > 1 && i < 8; ++i) utcOffset |= static_cast<uint64_t>(static_cast<uint8_t>(head[8 + i])) << (8 * i);
+    if (fileSize < headerBytes + sizeof(tail) || std::abs(static_cast<int64_t>(utcOffset)) > MAX_UTC_OFFSET) {
+        error = "Corrupt archive header";
+        return false;
+    }
+
+    in.seekg(static_cast<std::streamoff>(fileSize - sizeof(tail)));
+    in.read(tail, sizeof(tail));
+    uint64_t footerOffset = 0;
+    for (int i = 0; i < 8; ++i) footerOffset |= static_cast<uint64_t>(static_cast<uint8_t>(tail[i])) << (8 * i);
+    if (!in || std::memcmp(tail + 8, ARCHIVE_MAGIC, 4) != 0 || footerOffset < headerBytes ||
+        footerOffset > fileSize - sizeof(tail)) {
+        error = "Corrupt archive footer";
+        return false;
+    }
+
+    string footer(static_cast<size_t>(fileSize - sizeof(tail) - footerOffset), '\0');
+    in.seekg(static_cast<std::streamoff>(footerOffset));
+    in.read(&footer[0], static_cast<std::streamsize>(footer.size()));
+
+    const char* cursor = footer.data();
+    const char* end = cursor + footer.size();
+    uint64_t levelCount, blockCount;
+    bool ok = static_cast<bool>(in) && getVarint(cursor, end, levelCount) && levelCount <= footer.size();
+    directory = ArchiveDirectory{};
+    directory.utcOffset = static_cast<int64_t>(utcOffset);
+    for (uint64_t l = 0; ok && l < levelCount; ++l) {
+        string_view level;
+        ok = getBytes(cursor, end, level);
+        directory.levels.emplace_back(level);
+    }
+    ok = ok && getVarint(cursor, end, blockCount) && blockCount <= footer.size();
+    for (uint64_t b = 0; ok && b < blockCount; ++b) {
+        ArchiveBlockInfo info;
+        uint64_t rows, minEpoch, maxEpoch;
+        ok = getVarint(cursor, end, info.offset) && getVarint(cursor, end, info.bytes) &&
+             getVarint(cursor, end, rows) && getVarint(cursor, end, minEpoch) && getVarint(cursor, end, maxEpoch) &&
+             info.offset >= headerBytes && info.offset + info.bytes <= footerOffset;
+        info.rows = static_cast<uint32_t>(rows);
+        info.minEpoch = unzigzag(minEpoch);
+        info.maxEpoch = unzigzag(maxEpoch);
+        info.levelCounts.resize(directory.levels.size());
+        for (auto& count : info.levelCounts) ok = ok && getVarint(cursor, end, count);
+        directory.blocks.push_back(std::move(info));
+    }
+    if (!ok || cursor != end) {
+        error = "Corrupt archive footer";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Decode one archive block into the entries a filter keeps
+ * Message and raw timestamp text is interned into the message pool only for
+ * kept rows, so dropped rows cost no pool memory. Thread-safe: the pool is
+ * sharded and each call writes only its own output.
+ * 
+ * @param payload  Encoded block
+ * @param info     Block header (time base)
+ * @param levelIds Pool id of each archive level (placeholders when keep drops every row)
+ * @param keep     Called as keep(entry) with epoch, format and level set
+ * @param entries  Output kept entries in archive order
+ * @return         false if the payload is corrupt
+ */
+template <typename Keep>
+static bool decodeArchiveBlock(const string& payload, const ArchiveBlockInfo& info,
+                               const vector<uint32_t>& levelIds, Keep&& keep, vector<LogEntry>& entries) {
+    const char* cursor = payload.data();
+    const char* end = cursor + payload.size();
+    uint64_t rows;
+    string columns[5];
+    if (!getVarint(cursor, end, rows) || rows != info.rows || rows > ARCHIVE_BLOCK_ROWS) return false;
+    for (auto& column : columns) {
+        if (!getColumn(cursor, end, column)) return false;
+    }
+
+    entries.assign(static_cast<size_t>(rows), LogEntry{});
+
+    // Timestamps
+    const char* time = columns[0].data();
+    const char* timeEnd = time + columns[0].size();
+    uint64_t previous = static_cast<uint64_t>(info.minEpoch == INT64_MAX ? 0 : info.minEpoch);
+    for (auto& entry : entries) {
+        uint64_t delta;
+        if (!getVarint(time, timeEnd, delta)) return false;
+        previous += static_cast<uint64_t>(unzigzag(delta));
+        entry.epoch = static_cast<int64_t>(previous);
+    }
+
+    // Run-length columns
+    auto decodeRuns = [&entries](const string& column, const auto& assign) {
+        const char* p = column.data();
+        const char* pEnd = p + column.size();
+        size_t row = 0;
+        while (row < entries.size()) {
+            uint64_t value, run;
+            if (!getVarint(p, pEnd, value) || !getVarint(p, pEnd, run) || run > entries.size() - row) return false;
+            for (uint64_t r = 0; r < run; ++r) {
+                if (!assign(entries[row++], value)) return false;
+            }
+        }
+        return true;
+    };
+    bool ok = decodeRuns(columns[1], [](LogEntry& entry, uint64_t value) {
+        entry.format = static_cast<uint32_t>(value);
+        return value <= TIMESTAMP_RAW;
+    });
+    ok = ok && decodeRuns(columns[2], [&levelIds](LogEntry& entry, uint64_t value) {
+        if (value >= levelIds.size()) return false;
+        entry.levelId = levelIds[value];
+        return true;
+    });
+    if (!ok) return false;
+
+    // Message dictionary, interned on first use by a kept row
+    const char* message = columns[3].data();
+    const char* messageEnd = message + columns[3].size();
+    uint64_t wordCount;
+    if (!getVarint(message, messageEnd, wordCount) || wordCount > rows) return false;
+    vector<string_view> words(static_cast<size_t>(wordCount));
+    for (auto& word : words) {
+        if (!getBytes(message, messageEnd, word)) return false;
+    }
+    vector<uint32_t> wordIds(words.size(), MessagePool::INVALID_ID);
+
+    // Every row is read to advance the columns; only kept rows are compacted to the front
+    const char* rawTime = columns[4].data();
+    const char* rawTimeEnd = rawTime + columns[4].size();
+    size_t kept = 0;
+    for (auto& entry : entries) {
+        uint64_t index;
+        string_view rawText;
+        if (!getVarint(message, messageEnd, index) || index >= words.size()) return false;
+        if (entry.format == TIMESTAMP_RAW && !getBytes(rawTime, rawTimeEnd, rawText)) return false;
+        if (!keep(entry)) continue;
+
+        if (wordIds[index] == MessagePool::INVALID_ID) wordIds[index] = messagePool.intern(words[index]);
+        entry.messageId = wordIds[index];
+        entry.length = static_cast<uint32_t>(words[index].size());
+        entry.timestampId = entry.format == TIMESTAMP_RAW ? messagePool.intern(rawText) : MessagePool::INVALID_ID;
+        entries[kept++] = entry;
+    }
+    entries.resize(kept);
+    return true;
+}
+
+/**
+ * Write the loaded logs to an archive file in the current directory
+ */
+void saveArchive() {
+    if (logsEmpty()) return;
+
+    string filename;
+    cout << "\n  " << GREEN << "Enter archive filename (without extension): " << RESET;
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    getline(cin, filename);
+    if (filename.empty()) {
+        cerr << RED << "  ✗ No filename provided.\n" << RESET;
+        return;
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    string path = filename + ".lga";
+    size_t textBytes = 0;
+    string error;
+    if (!writeArchive(path, textBytes, error)) {
+        cerr << RED << "  ✗ " << error << "\n" << RESET;
+        return;
+    }
+    double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+    size_t archiveBytes = static_cast<size_t>(std::filesystem::file_size(path));
+    size_t blockCount = (logs.size() + ARCHIVE_BLOCK_ROWS - 1) / ARCHIVE_BLOCK_ROWS;
+    cout << GREEN << "  ✓ Archived " << logs.size() << " entries in " << blockCount << " blocks to " << path 
+         << " (" << fixed << setprecision(1) << elapsedMs << " ms)\n" << RESET;
+    cout << CYAN << "  ℹ Size: " << formatBytes(archiveBytes) << " vs ~" << formatBytes(textBytes) << " as text ("
+         << setprecision(1) << (textBytes > 0 ? archiveBytes * 100.0 / textBytes : 0.0) << "%)\n" << RESET;
+}
+
+/**
+ * Prompt for an archive path and read its directory
+ */
+static bool promptArchiveDirectory(string& path, ArchiveDirectory& directory) {
+    cout << "\n  " << GREEN << "Enter archive file name (.lga): " << RESET;
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    getline(cin, path);
+    if (path.empty()) {
+        cerr << RED << "  ✗ No filename provided.\n" << RESET;
+        return false;
+    }
+    if (!isValidLogPath(path)) {
+        cerr << RED << "  ✗ Invalid or unauthorized file path.\n" << RESET;
+        return false;
+    }
+    string error;
+    if (!readArchiveDirectory(path, directory, error)) {
+        cerr << RED << "  ✗ " << error << "\n" << RESET;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Show level statistics and time range of an archive from its block headers
+ * No block is read or decompressed
+ */
+void showArchiveSummary() {
+    string path;
+    ArchiveDirectory directory;
+    if (!promptArchiveDirectory(path, directory)) return;
+
+    uint64_t total = 0;
+    int64_t minEpoch = INT64_MAX, maxEpoch = INT64_MIN;
+    uint64_t payloadBytes = 0;
+    vector<uint64_t> levelTotals(directory.levels.size(), 0);
+    for (const ArchiveBlockInfo& info : directory.blocks) {
+        total += info.rows;
+        payloadBytes += info.bytes;
+        minEpoch = std::min(minEpoch, info.minEpoch);
+        maxEpoch = std::max(maxEpoch, info.maxEpoch);
+        for (size_t l = 0; l < levelTotals.size(); ++l) levelTotals[l] += info.levelCounts[l];
+    }
+
+    cout << "\n  " << BRIGHT_CYAN << "════════════════════════════════════════════════════════════" << RESET << "\n";
+    cout << "  " << BRIGHT_CYAN << "ARCHIVE SUMMARY: " << path << RESET << "\n";
+    cout << "  " << BRIGHT_CYAN << "════════════════════════════════════════════════════════════" << RESET << "\n\n";
+    cout << "  " << CYAN << "Entries: " << RESET << total << " in " << directory.blocks.size() 
+         << " blocks (" << formatBytes(payloadBytes) << " of column data)\n\n";
+
+    for (size_t l = 0; l < levelTotals.size(); ++l) {
+        double percentage = total > 0 ? levelTotals[l] * 100.0 / total : 0.0;
+        cout << "  " << getLevelColor(directory.levels[l]) << std::left << std::setw(8) << directory.levels[l] << RESET
+             << " " << levelTotals[l] << " (" << fixed << setprecision(1) << percentage << "%)\n";
+    }
+    if (minEpoch <= maxEpoch) {
+        // Shown in the archive's own wall clock (formatEpoch adds the current offset)
+        int64_t shift = directory.utcOffset - logUtcOffset;
+        cout << "\n  " << CYAN << "First Entry: " << RESET << formatEpoch(minEpoch + shift, TIMESTAMP_ISO) << "\n";
+        cout << "  " << CYAN << "Last Entry:  " << RESET << formatEpoch(maxEpoch + shift, TIMESTAMP_ISO) << "\n";
+        cout << "  " << CYAN << "UTC Offset:  " << RESET << formatUtcOffset(directory.utcOffset) << "\n";
+    }
+    cout << "\n";
+}
+
+/**
+ * Load an archive, decompressing only blocks that can match a time/level filter
+ * Decoded entries replace the loaded logs, so every other menu works on them
+ */
+void loadArchive() {
+    string path;
+    ArchiveDirectory directory;
+    if (!promptArchiveDirectory(path, directory)) return;
+
+    // Optional filters, answered from block headers first
+    string startText, endText, levelText;
+    cout << "  " << YELLOW << "Start time (YYYY-MM-DD HH:MM:SS, blank = no limit): " << RESET;
+    getline(cin, startText);
+    cout << "  " << YELLOW << "End time (YYYY-MM-DD HH:MM:SS, blank = no limit): " << RESET;
+    getline(cin, endText);
+    cout << "  " << YELLOW << "Level (blank = all): " << RESET;
+    getline(cin, levelText);
+
+    // Filter times are in the archive's wall clock, not the current --timezone
+    int64_t start = startText.empty() ? INT64_MIN : timestampToEpoch(startText);
+    int64_t end = endText.empty() ? INT64_MAX : timestampToEpoch(endText);
+    if ((!startText.empty() && start == INVALID_EPOCH) || (!endText.empty() && end == INVALID_EPOCH)) {
+        cerr << RED << "  ✗ Invalid time format.\n" << RESET;
+        return;
+    }
+    if (!startText.empty()) start += logUtcOffset - directory.utcOffset;
+    if (!endText.empty()) end += logUtcOffset - directory.utcOffset;
+    bool timeFilter = !startText.empty() || !endText.empty();
+
+    size_t levelFilter = directory.levels.size();  // No level filter
+    if (!levelText.empty()) {
+        for (size_t l = 0; l < directory.levels.size(); ++l) {
+            if (toLowerStr(directory.levels[l]) == toLowerStr(levelText)) levelFilter = l;
+        }
+        if (levelFilter == directory.levels.size()) {
+            cerr << RED << "  ✗ Level not present in archive: " << levelText << "\n" << RESET;
+            return;
+        }
+    }
+
+    vector<size_t> selected;
+    for (size_t b = 0; b < directory.blocks.size(); ++b) {
+        const ArchiveBlockInfo& info = directory.blocks[b];
+        if (timeFilter && (info.minEpoch > end || info.maxEpoch < start)) continue;
+        if (levelFilter < directory.levels.size() && info.levelCounts[levelFilter] == 0) continue;
+        selected.push_back(b);
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    MemoryScope memory(MEMORY_LOADER);
+
+    // Blocks are read and decoded in batches of one block per worker, so only
+    // one batch of payloads and decoded rows is held next to the store
+    unsigned workerCount = std::max(1u, std::thread::hardware_concurrency());
+    workerCount = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(workerCount, selected.size())));
+    ifstream in(path, std::ios::binary);
+    vector<string> payloads(workerCount);
+    vector<vector<LogEntry>> decoded(workerCount);
+    auto decodeBatch = [&](size_t first, const vector<uint32_t>& levelIds, const auto& keep, string& error) {
+        size_t count = std::min<size_t>(workerCount, selected.size() - first);
+        for (size_t s = 0; s < count && in; ++s) {
+            const ArchiveBlockInfo& info = directory.blocks[selected[first + s]];
+            payloads[s].resize(static_cast<size_t>(info.bytes));
+            in.seekg(static_cast<std::streamoff>(info.offset));
+            in.read(&payloads[s][0], static_cast<std::streamsize>(info.bytes));
+        }
+        if (!in) {
+            error = "Could not read archive blocks.";
+            return false;
+        }
+
+        std::atomic<bool> corrupt{false};
+        runOnWorkers(static_cast<unsigned>(count), "archive.decode", [&](unsigned w) {
+            const ArchiveBlockInfo& info = directory.blocks[selected[first + w]];
+            if (!decodeArchiveBlock(payloads[w], info, levelIds, keep, decoded[w])) corrupt = true;
+            string().swap(payloads[w]);
+        });
+        if (corrupt) error = "Corrupt archive block.";
+        return !corrupt;
+    };
+
+    // Every selected block is read and checked before the loaded logs are
+    // dropped; keeping no rows leaves the message pool untouched
+    string error;
+    vector<uint32_t> placeholderIds(directory.levels.size(), 0);
+    auto keepNone = [](const LogEntry&) { return false; };
+    for (size_t first = 0; first < selected.size(); first += workerCount) {
+        if (!decodeBatch(first, placeholderIds, keepNone, error)) {
+            cerr << RED << "  ✗ " << error << " The loaded logs were kept.\n" << RESET;
+            return;
+        }
+    }
+
+    logs.clear();
+    messagePool.clear();
+    resultCache.clear();
+    searchSteps.clear();
+    currentStep = SIZE_MAX;
+    templateIndex.clear();
+    anomalyDetector.reset();
+    sourceFile.close();
+    if (logUtcOffset != directory.utcOffset) {
+        cout << CYAN << "  ℹ Using the archive's UTC offset " << formatUtcOffset(directory.utcOffset)
+             << " (was " << formatUtcOffset(logUtcOffset) << ").\n" << RESET;
+        logUtcOffset = directory.utcOffset;
+    }
+
+    // Rows that pass the exact filters (block headers only ruled out whole blocks)
+    vector<uint32_t> levelIds;
+    for (const string& level : directory.levels) levelIds.push_back(messagePool.intern(level));
+    uint32_t levelId = levelFilter < directory.levels.size() ? levelIds[levelFilter] : 0;
+    auto keep = [&](const LogEntry& entry) {
+        if (timeFilter && (entry.epoch == INVALID_EPOCH || entry.epoch < start || entry.epoch > end)) return false;
+        return levelFilter == directory.levels.size() || entry.levelId == levelId;
+    };
+
+    // Kept rows in archive order; the decoded batch counts against the budget while it is appended
+    for (size_t first = 0; first < selected.size(); first += workerCount) {
+        if (!decodeBatch(first, levelIds, keep, error)) {
+            cerr << RED << "  ✗ " << error << "\n" << RESET;  // Archive changed since it was checked
+            logs.clear();
+            buildBlockIndex();
+            return;
+        }
+        size_t batchBytes = 0;
+        for (const auto& block : decoded) batchBytes += block.capacity() * sizeof(LogEntry);
+        size_t count = std::min<size_t>(workerCount, selected.size() - first);
+        for (size_t s = 0; s < count; ++s) {
+            for (const LogEntry& entry : decoded[s]) {
+                if (logs.memoryBudget() > 0 && logs.size() % LOG_BLOCK_SIZE == 0) {
+                    logs.setReservedBytes(budgetReservedBytes(logs.size()) + batchBytes);
+                }
+                logs.push_back(entry);
+                anomalyDetector.observe(entry);
+            }
+        }
+    }
+    if (logs.memoryBudget() > 0) logs.setReservedBytes(budgetReservedBytes(logs.size()));
+    for (auto& block : decoded) vector<LogEntry>().swap(block);
+    anomalyDetector.finish();
+    buildBlockIndex();
+
+    double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    cout << GREEN << "  ✓ Loaded " << logs.size() << " log entries from " << path << " in "
+         << fixed << setprecision(1) << elapsedMs << " ms.\n" << RESET;
+    cout << CYAN << "  ℹ Decompressed " << selected.size() << " of " << directory.blocks.size()
+         << " blocks; the rest were ruled out by their headers.\n" << RESET;
+    if (!logs.empty()) printMemorySummary();
+}
+
+/**
+ * Display archive menu and handle user selection
+ */
+void archiveMenu() {
+    // Display archive options
+    cout << "\n  " << BRIGHT_CYAN << "ARCHIVE OPTIONS" << RESET << "\n";
+    cout << "  1. Write Archive (loaded logs)\n";
+    cout << "  2. Archive Summary (headers only)\n";
+    cout << "  3. Load Archive (time/level filter)\n";
+    cout << "  4. Back\n";
+    cout << "\n  " << BRIGHT_CYAN << "Select option (1-4): " << RESET;
+
+    int choice;
+    cin >> choice;
+
+    // Handle invalid input
+    if(cin.fail()) {
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        cout << RED << "\n  ✗ Invalid input.\n" << RESET;
+        return;
+    }
+
+    switch (choice) {
+        case 1: saveArchive(); break;
+        case 2: showArchiveSummary(); break;
+        case 3: loadArchive(); break;
+        case 4: break;
+        default: cout << RED << "\n  ✗ Invalid option.\n" << RESET; break;
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// IMPLEMENTATION: MESSAGE TEMPLATES
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Characters that separate template tokens (kept verbatim in the template)
+ */
+static bool isTemplateDelimiter(char c) {
+    return std::isspace(static_cast<unsigned char>(c)) || std::strchr("=:,;()[]{}\"'<>", c) != nullptr;
+}
+
+/**
+ * Reduce a message to its template by replacing variable tokens
+ * A token is a run between delimiters; any token with a digit (ids, numbers,
+ * IPs, hex values, paths with ids) becomes <*>
+ * 
+ * @param message Message text
+ * @return        Template text, e.g. "Cache miss (UserID: <*>)"
+ */
+string messageTemplate(string_view message) {
+    string result;
+    appendTemplate(message, result);
+    return result;
+}
+
+/**
+ * Append the template of a message to a buffer (see messageTemplate)
+ * 
+ * @param message Message text
+ * @param result  Buffer to append to
+ */
+void appendTemplate(string_view message, string& result) {
+    result.reserve(result.size() + message.size());
+    size_t i = 0;
+    while (i < message.size()) {
+        if (isTemplateDelimiter(message[i]) || message[i] == '\0') {
+            result.push_back(message[i++]);
+            continue;
+        }
+        size_t tokenEnd = i;
+        bool hasDigit = false;
+        while (tokenEnd < message.size() && !isTemplateDelimiter(message[tokenEnd])) {
+            hasDigit = hasDigit || std::isdigit(static_cast<unsigned char>(message[tokenEnd]));
+            tokenEnd++;
+        }
+        if (hasDigit) result += "<*>";
+        else result.append(message.data() + i, tokenEnd - i);
+        i = tokenEnd;
+    }
+}
+
+/**
+ * Template key of an entry's message, computed once per distinct message
+ * Messages left in the file (low-memory mode) have no id and are tokenized each time.
+ * Keys are hashes, so templates are never stored; use messageTemplate() for the text.
+ * 
+ * @param entry Log entry
+ * @return      Nonzero 64-bit template key
+ */
+uint64_t TemplateIndex::keyOf(const LogEntry& entry) {
+    if (entry.messageId == LogEntry::LAZY_MESSAGE) return keyOf(entryMessage(entry));
+
+    if (entry.messageId >= byMessage.size()) {
+        MemoryScope memory(MEMORY_INDEX);
+        byMessage.resize(std::max(messagePool.idLimit(), static_cast<size_t>(entry.messageId) + 1), 0);
+    }
+    uint64_t& cached = byMessage[entry.messageId];
+    if (cached == 0) cached = keyOf(entryMessage(entry));
+    return cached;
+}
+
+/**
+ * Template key of a message that may not be in the pool
+ * 
+ * @param message Message text
+ * @return        Nonzero 64-bit template key (same as keyOf(entry) for that message)
+ */
+uint64_t TemplateIndex::keyOf(string_view message) {
+    scratch.clear();
+    appendTemplate(message, scratch);
+    return hashBytes(scratch.data(), scratch.size()) | 1;
+}
+
+void TemplateIndex::clear() {
+    decltype(byMessage)().swap(byMessage);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// IMPLEMENTATION: REPEAT COLLAPSE
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Run key of an entry under the collapser's mode
+ * 
+ * @param entry Log entry
+ * @return      Key that is equal for entries that belong in one run
+ */
+uint64_t RunCollapser::keyOf(const LogEntry& entry) {
+    if (mode == COLLAPSE_TEMPLATES) return templateIndex.keyOf(entry);
+    if (entry.messageId != LogEntry::LAZY_MESSAGE) return entry.messageId;
+    string_view message = entryMessage(entry);
+    return hashBytes(message.data(), message.size());
+}
+
+/**
+ * Add the next entry in render order
+ * 
+ * @param entry    Next entry
+ * @param finished Receives the previous run when this entry starts a new one
+ * @return         True if finished was filled
+ */
+bool RunCollapser::push(const LogEntry& entry, CollapsedRun& finished) {
+    uint64_t key = keyOf(entry);
+    if (run.count > 0 && key == runKey && entry.levelId == run.first.levelId) {
+        // Hashed messages are confirmed byte-for-byte; ids and templates are exact
+        if (mode == COLLAPSE_TEMPLATES || entry.messageId != LogEntry::LAZY_MESSAGE ||
+            entryMessage(entry) == entryMessage(run.first)) {
+            run.last = entry;
+            run.count++;
+            return false;
+        }
+    }
+
+    bool closed = run.count > 0;
+    if (closed) finished = run;
+    run.first = run.last = entry;
+    run.count = 1;
+    runKey = key;
+    return closed;
+}
+
+bool RunCollapser::flush(CollapsedRun& finished) {
+    if (run.count == 0) return false;
+    finished = run;
+    run.count = 0;
+    return true;
+}
+
+/**
+ * Write a run as one log line; runs longer than one entry get a count and
+ * time span, and in template mode show the template instead of the first message
+ * 
+ * @param out   Output stream
+ * @param run   Run to write
+ * @param color Use ANSI colors (console) or plain text (export)
+ */
+void writeCollapsedRun(std::ostream& out, const CollapsedRun& run, bool color) {
+    string_view level = entryLevel(run.first);
+    if (color) {
+        out << "  " << CYAN << entryTimestamp(run.first) << RESET
+            << " [" << getLevelColor(level) << level << RESET << "] ";
+    } else {
+        out << entryTimestamp(run.first) << " [" << level << "] ";
+    }
+
+    if (run.count == 1) {
+        out << entryMessage(run.first) << "\n";
+        return;
+    }
+    if (collapseMode == COLLAPSE_TEMPLATES) out << messageTemplate(entryMessage(run.first));
+    else out << entryMessage(run.first);
+
+    if (color) out << " " << YELLOW;
+    else out << " ";
+    out << "(×" << run.count << ", " << entryTimestamp(run.first) << " → " << entryTimestamp(run.last) << ")";
+    if (color) out << RESET;
+    out << "\n";
+}
+
+/**
+ * Cycle the collapse mode: off → identical messages → identical templates
+ */
+void toggleCollapseMode() {
+    collapseMode = static_cast<CollapseMode>((collapseMode + 1) % 3);
+    cout << GREEN << "  ✓ Repeat collapse: " << collapseModeName(collapseMode) << "\n" << RESET;
+}
+
+/**
+ * Display name of a collapse mode
+ * 
+ * @param mode Collapse mode
+ * @return     "off", "messages" or "templates"
+ */
+const char* collapseModeName(CollapseMode mode) {
+    switch (mode) {
+        case COLLAPSE_MESSAGES:  return "messages";
+        case COLLAPSE_TEMPLATES: return "templates";
+        default:                 return "off";
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// IMPLEMENTATION: LOG DIFF
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Time span covered by a profile in hours, used to normalize counts
+ * Floored at one minute so tiny files do not produce huge rates
+ */
+double TemplateProfile::hours() const {
+    if (minEpoch > maxEpoch) return 1.0;
+    return std::max<double>(static_cast<double>(maxEpoch - minEpoch + 1), 60.0) / 3600.0;
+}
+
+/**
+ * Stream a log file into template counts
+ * Lines are parsed with the normal parser but nothing is stored per entry,
+ * so memory is bounded by the number of distinct templates
+ * 
+ * @param filename Log file path
+ * @param profile  Receives counts and the covered time span
+ */
+void buildTemplateProfile(const string& filename, TemplateProfile& profile) {
+    ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) return;
+    profile.opened = true;
+
+    string line;
+    string text;
+    while (getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        addProfileLine(profile, line, text);
+    }
+}
+
+/**
+ * Parse one raw line into a template profile
+ * 
+ * @param profile Profile to update
+ * @param line    Line without terminator
+ * @param text    Scratch buffer for the template key
+ * @param weight  Inverse selection odds of a sampled line (1 when every line counts once)
+ * @return        false if the line is not a log entry (non-empty ones count as skipped)
+ */
+bool addProfileLine(TemplateProfile& profile, const string& line, string& text, double weight) {
+    LogEntry entry;
+    if (!parseLogLine(line, entry, false)) {
+        if (!line.empty()) profile.skipped++;
+        return false;
+    }
+    // Keyed by level and template, so a message moving from WARN to ERROR shows up
+    text.assign("[").append(entryLevel(entry)).append("] ");
+    appendTemplate(string_view(line).substr(entry.offset, entry.length), text);
+    auto& slot = profile.templates[hashBytes(text.data(), text.size())];
+    if (slot.count++ == 0) slot.text = text;
+    slot.weight += weight;
+
+    profile.levels[entry.levelId]++;
+    profile.levelWeights[entry.levelId] += weight;
+    profile.entries++;
+    profile.entryWeight += weight;
+    profile.entryWeightSquares += weight * weight;
+    if (entry.epoch != INVALID_EPOCH) {
+        profile.minEpoch = std::min(profile.minEpoch, entry.epoch);
+        profile.maxEpoch = std::max(profile.maxEpoch, entry.epoch);
+    }
+    return true;
+}
+
+/**
+ * Compare two log files by message template
+ * 
+ * Both files are profiled in parallel, then joined on template key with one
+ * hash lookup per template. Counts are normalized per hour of covered time.
+ * A template changed significantly when the binomial test on its two counts
+ * (expected split = ratio of the time spans) gives |z| ≥ 3 and its hourly
+ * rate moved by at least 2x.
+ */
+void compareLogFiles() {
+    string names[2];
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    for (int f = 0; f < 2; ++f) {
+        cout << "\n  " << GREEN << (f == 0 ? "Baseline log file (before): " : "Compared log file (after): ") << RESET;
+        getline(cin, names[f]);
+        if (names[f].empty()) {
+            cerr << RED << "  ✗ No filename provided.\n" << RESET;
+            return;
+        }
+        if (!isValidLogPath(names[f])) {
+            cerr << RED << "  ✗ Invalid or unauthorized file path.\n" << RESET;
+            return;
+        }
+    }
+
+    cout << CYAN << "  ℹ Profiling both files...\n" << RESET;
+    auto startTime = std::chrono::steady_clock::now();
+    TemplateProfile profiles[2];
+    std::thread second(buildTemplateProfile, std::cref(names[1]), std::ref(profiles[1]));
+    buildTemplateProfile(names[0], profiles[0]);
+    second.join();
+    double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+    for (int f = 0; f < 2; ++f) {
+        if (!profiles[f].opened) {
+            cerr << RED << "  ✗ Could not open file: " << names[f] << RESET << "\n";
+            return;
+        }
+    }
+    const TemplateProfile& before = profiles[0];
+    const TemplateProfile& after = profiles[1];
+    const double hoursBefore = before.hours();
+    const double hoursAfter = after.hours();
+
+    struct Change {
+        const string* text;
+        uint64_t countBefore;
+        uint64_t countAfter;
+        double score;                            // Sort key: count, or |z|
+    };
+    vector<Change> added, vanished, changed;
+
+    // Hash join: probe the "after" table with every "before" template, then the reverse for new ones
+    const double shareBefore = hoursBefore / (hoursBefore + hoursAfter);
+    for (const auto& [key, templ] : before.templates) {
+        auto match = after.templates.find(key);
+        if (match == after.templates.end()) {
+            vanished.push_back({&templ.text, templ.count, 0, static_cast<double>(templ.count)});
+            continue;
+        }
+        double total = static_cast<double>(templ.count + match->second.count);
+        double expected = total * shareBefore;
+        double z = (templ.count - expected) / std::sqrt(std::max(total * shareBefore * (1.0 - shareBefore), 1e-9));
+        double rateBefore = (templ.count + 0.5) / hoursBefore;
+        double rateAfter = (match->second.count + 0.5) / hoursAfter;
+        double ratio = std::max(rateBefore, rateAfter) / std::min(rateBefore, rateAfter);
+        if (std::fabs(z) >= LOG_DIFF_Z_THRESHOLD && ratio >= LOG_DIFF_MIN_RATIO) {
+            changed.push_back({&templ.text, templ.count, match->second.count, std::fabs(z)});
+        }
+    }
+    for (const auto& [key, templ] : after.templates) {
+        if (before.templates.find(key) == before.templates.end()) {
+            added.push_back({&templ.text, 0, templ.count, static_cast<double>(templ.count)});
+        }
+    }
+
+    cout << "\n  " << BRIGHT_CYAN << "════════════════════════════════════════════════════════════" << RESET << "\n";
+    cout << "  " << BRIGHT_CYAN << "LOG DIFF (per hour)" << RESET << "\n";
+    cout << "  " << BRIGHT_CYAN << "════════════════════════════════════════════════════════════" << RESET << "\n\n";
+    cout << "  Before: " << names[0] << " — " << before.entries << " entries, "
+         << before.templates.size() << " templates, " << fixed << setprecision(1) << hoursBefore << " h\n";
+    cout << "  After:  " << names[1] << " — " << after.entries << " entries, "
+         << after.templates.size() << " templates, " << hoursAfter << " h\n";
+
+    auto printSection = [&](const char* title, const char* color, vector<Change>& items) {
+        std::sort(items.begin(), items.end(), [](const Change& a, const Change& b) { return a.score > b.score; });
+        cout << "\n  " << color << title << " (" << items.size() << ")" << RESET << "\n";
+        if (items.empty()) {
+            cout << "    none\n";
+            return;
+        }
+        for (size_t i = 0; i < items.size() && i < LOG_DIFF_TOP; ++i) {
+            cout << "    " << std::setw(9) << setprecision(1) << items[i].countBefore / hoursBefore << " → "
+                 << std::setw(9) << items[i].countAfter / hoursAfter << "/h  " << *items[i].text << "\n";
+        }
+        if (items.size() > LOG_DIFF_TOP) cout << "    ... and " << (items.size() - LOG_DIFF_TOP) << " more\n";
+    };
+    printSection("NEW TEMPLATES", RED, added);
+    printSection("VANISHED TEMPLATES", GREEN, vanished);
+    printSection("CHANGED RATES", YELLOW, changed);
+
+    cout << "\n  " << CYAN << "ℹ Compared in " << setprecision(0) << elapsedMs << " ms" << RESET << "\n\n";
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// IMPLEMENTATION: TEMPORAL JOIN
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Pair every entry of one side with the entries of the other side that lie
+ * at most `window` seconds before it (same second included)
+ * 
+ * Both sides must be sorted by epoch. One sweep moves two cursors over the
+ * leading side, so the cost is O(n + m + pairs) with no nested scan.
+ * 
+ * @param leading  Side A, whose entries come first (sorted)
+ * @param trailing Side B (sorted)
+ * @param window   Maximum lead time in seconds
+ * @param emit     Called as emit(leadingIndex, trailingIndex) for each pair
+ */
+template <typename Emit>
+void temporalJoin(const vector<JoinEntry>& leading, const vector<JoinEntry>& trailing, int64_t window, Emit&& emit) {
+    size_t low = 0, high = 0;
+    for (size_t b = 0; b < trailing.size(); ++b) {
+        const int64_t epoch = trailing[b].epoch;
+        while (high < leading.size() && leading[high].epoch <= epoch) high++;
+        while (low < high && leading[low].epoch < epoch - window) low++;
+        for (size_t a = low; a < high; ++a) emit(a, b);
+    }
+}
+
+/**
+ * Collect the entries of a source that match a filter query, sorted by time
+ * Entries without a valid timestamp cannot be joined and are dropped. The
+ * template key of every kept entry is computed here, once.
+ * 
+ * @param source    Entries to filter (LogStore or vector)
+ * @param messageOf Message text of source[i]
+ * @param text      Filter query text (empty = every entry)
+ * @param side      Receives the matching entries
+ * @return          False if the query does not compile
+ */
+template <typename Entries, typename MessageOf>
+bool collectJoinSide(const Entries& source, MessageOf&& messageOf, const string& text, vector<JoinEntry>& side) {
+    FilterQuery query;
+    string error;
+    if (!text.empty() && !query.compile(text, error)) {
+        cerr << RED << "  ✗ Invalid query: " << error << "\n" << RESET;
+        return false;
+    }
+    for (size_t i = 0; i < source.size(); ++i) {
+        const LogEntry& entry = source[i];
+        if (entry.epoch == INVALID_EPOCH) continue;
+
+        // Pooled messages use the per-id verdict and key caches
+        string_view message = messageOf(i);
+        bool pooled = entry.messageId != LogEntry::LAZY_MESSAGE;
+        if (!text.empty() && !(pooled ? query.matches(entry) : query.matches(entry, message))) continue;
+        uint64_t key = pooled ? templateIndex.keyOf(entry) : templateIndex.keyOf(message);
+        side.push_back({entry.epoch, &entry, message, key});
+    }
+    // Files are normally in time order already; sort only when they are not
+    auto byEpoch = [](const JoinEntry& a, const JoinEntry& b) { return a.epoch < b.epoch; };
+    if (!std::is_sorted(side.begin(), side.end(), byEpoch)) {
+        std::stable_sort(side.begin(), side.end(), byEpoch);
+    }
+    return true;
+}
+
+/**
+ * Correlate two sources: "every A within N seconds before a B"
+ * 
+ * A is taken from the loaded logs, B from a second file or from the loaded
+ * logs again; each side is narrowed with the filter query language. Pairs
+ * are listed under their B entry and grouped by (A template, B template).
+ */
+void correlateSources() {
+    if (logsEmpty()) return;
+
+    string otherFile, queryA, queryB, windowText;
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    cout << "\n  " << GREEN << "Second log file for side B (blank = loaded logs): " << RESET;
+    getline(cin, otherFile);
+    cout << "  " << GREEN << "Side A query, the earlier entries (blank = all), e.g. level = WARN: " << RESET;
+    getline(cin, queryA);
+    cout << "  " << GREEN << "Side B query, the later entries (blank = all), e.g. level = ERROR: " << RESET;
+    getline(cin, queryB);
+    cout << "  " << GREEN << "Window in seconds (blank = " << JOIN_DEFAULT_WINDOW << "): " << RESET;
+    getline(cin, windowText);
+
+    int64_t window = JOIN_DEFAULT_WINDOW;
+    if (!windowText.empty()) {
+        try {
+            window = std::stoll(windowText);
+        } catch (...) {
+            window = -1;
+        }
+        if (window < 0) {
+            cerr << RED << "  ✗ Invalid window: " << windowText << "\n" << RESET;
+            return;
+        }
+    }
+
+    // Side B from another file: parsed into memory for the duration of the join.
+    // Its messages go to a scratch pool that is released on return, so only
+    // level names (and irregular timestamp text) reach the shared pool.
+    vector<LogEntry> otherEntries;
+    vector<string_view> otherMessages;
+    MessagePool otherPool;
+    if (!otherFile.empty()) {
+        if (!isValidLogPath(otherFile)) {
+            cerr << RED << "  ✗ Invalid or unauthorized file path.\n" << RESET;
+            return;
+        }
+        ifstream file(otherFile, std::ios::binary);
+        if (!file.is_open()) {
+            cerr << RED << "  ✗ Could not open file: " << otherFile << RESET << "\n";
+            return;
+        }
+        string line;
+        while (getline(file, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            LogEntry entry;
+            if (parseLogLine(line, entry, false)) {
+                otherMessages.push_back(otherPool.view(otherPool.intern(string_view(line).substr(entry.offset, entry.length))));
+                otherEntries.push_back(entry);
+            }
+        }
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    auto loadedMessage = [](size_t i) { return entryMessage(logs[i]); };
+    auto otherMessage = [&otherMessages](size_t i) { return otherMessages[i]; };
+    vector<JoinEntry> sideA, sideB;
+    if (!collectJoinSide(logs, loadedMessage, queryA, sideA)) return;
+    bool sideBOk = otherFile.empty() ? collectJoinSide(logs, loadedMessage, queryB, sideB)
+                                     : collectJoinSide(otherEntries, otherMessage, queryB, sideB);
+    if (!sideBOk) return;
+
+    // Sweep once: count pairs, keep the first few B entries with their A
+    // entries for display, and group every pair by its two templates
+    struct PairGroup {
+        uint64_t count = 0;
+        const JoinEntry* sampleA = nullptr;
+        const JoinEntry* sampleB = nullptr;
+    };
+    unordered_map<uint64_t, PairGroup> groups;
+    vector<std::pair<size_t, vector<size_t>>> preview;  // (B index, A indices)
+    uint64_t pairs = 0;
+    size_t matchedB = 0;
+
+    temporalJoin(sideA, sideB, window, [&](size_t a, size_t b) {
+        if (sideA[a].entry == sideB[b].entry) return;  // Both sides from the loaded logs: not its own cause
+        pairs++;
+        if (preview.empty() || preview.back().first != b) {
+            matchedB++;
+            if (preview.size() < JOIN_PREVIEW_ROWS) preview.emplace_back(b, vector<size_t>());
+        }
+        if (preview.back().first == b && preview.back().second.size() < JOIN_PREVIEW_ROWS) {
+            preview.back().second.push_back(a);
+        }
+        uint64_t key = sideA[a].templateKey ^ (sideB[b].templateKey * 0x9E3779B97F4A7C15ull);
+        PairGroup& group = groups[key];
+        if (group.count++ == 0) {
+            group.sampleA = &sideA[a];
+            group.sampleB = &sideB[b];
+        }
+    });
+    double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+    cout << "\n  " << BRIGHT_CYAN << "════════════════════════════════════════════════════════════" << RESET << "\n";
+    cout << "  " << BRIGHT_CYAN << "TIME JOIN: A within " << window << "s before B" << RESET << "\n";
+    cout << "  " << BRIGHT_CYAN << "════════════════════════════════════════════════════════════" << RESET << "\n\n";
+    cout << "  Side A: " << sideA.size() << " entries, side B: " << sideB.size() << " entries\n";
+
+    if (pairs == 0) {
+        cout << "\n  " << YELLOW << "No B entry has an A entry within " << window << "s before it.\n\n" << RESET;
+        return;
+    }
+
+    cout << "\n";
+    for (const auto& [b, leads] : preview) {
+        printLogEntry(*sideB[b].entry, sideB[b].message);
+        for (size_t a : leads) {
+            cout << "      " << YELLOW << "← " << (sideB[b].epoch - sideA[a].epoch) << "s " << RESET;
+            printLogEntry(*sideA[a].entry, sideA[a].message);
+        }
+    }
+    if (matchedB > preview.size()) {
+        cout << "  " << YELLOW << "... " << (matchedB - preview.size()) << " more B entries with matches\n" << RESET;
+    }
+
+    vector<const PairGroup*> ranked;
+    ranked.reserve(groups.size());
+    for (const auto& item : groups) ranked.push_back(&item.second);
+    std::sort(ranked.begin(), ranked.end(), [](const PairGroup* x, const PairGroup* y) { return x->count > y->count; });
+
+    cout << "\n  " << BRIGHT_CYAN << "Top template pairs (A → B):" << RESET << "\n";
+    for (size_t i = 0; i < ranked.size() && i < JOIN_TOP_GROUPS; ++i) {
+        const JoinEntry& sampleA = *ranked[i]->sampleA;
+        const JoinEntry& sampleB = *ranked[i]->sampleB;
+        cout << "    " << YELLOW << std::setw(7) << ranked[i]->count << "×" << RESET << "  ["
+             << entryLevel(*sampleA.entry) << "] " << messageTemplate(sampleA.message) << "\n"
+             << "              → [" << entryLevel(*sampleB.entry) << "] "
+             << messageTemplate(sampleB.message) << "\n";
+    }
+
+    cout << "\n  " << GREEN << "✓ " << pairs << " pairs for " << matchedB << " B entries in "
+         << fixed << setprecision(1) << elapsedMs << " ms.\n\n" << RESET;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// IMPLEMENTATION: SESSIONS
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Extract the value of a "Field: value" or "field=value" pair from a message
+ * The field name matches case-insensitively and must start a word; the value
+ * is the following run of letters, digits, '_', '-' and '.'.
+ * 
+ * @param message Message text
+ * @param field   Field name, e.g. "UserID"
+ * @param value   Receives the value (a view into message)
+ * @return        True if the field was found with a non-empty value
+ */
+bool extractField(string_view message, string_view field, string_view& value) {
+    auto sameChar = [](char a, char b) {
+        return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+    };
+    auto isValueChar = [](char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '-' || c == '.';
+    };
+
+    auto from = message.begin();
+    while (true) {
+        auto found = std::search(from, message.end(), field.begin(), field.end(), sameChar);
+        if (found == message.end()) return false;
+        size_t pos = static_cast<size_t>(found - message.begin());
+        from = found + 1;
+        if (pos > 0 && std::isalnum(static_cast<unsigned char>(message[pos - 1]))) continue;
+
+        size_t i = pos + field.size();
+        while (i < message.size() && message[i] == ' ') i++;
+        if (i >= message.size() || (message[i] != ':' && message[i] != '=')) continue;
+        i++;
+        while (i < message.size() && (message[i] == ' ' || message[i] == '"' || message[i] == '\'')) i++;
+
+        size_t valueEnd = i;
+        while (valueEnd < message.size() && isValueChar(message[valueEnd])) valueEnd++;
+        if (valueEnd == i) continue;
+        value = message.substr(i, valueEnd - i);
+        return true;
+    }
+}
+
+/**
+ * Add one entry to its session, closing the previous session of the same
+ * id when the inactivity gap was exceeded
+ * 
+ * @param index Entry index in logs
+ * @param entry The entry
+ */
+void Sessionizer::observe(uint32_t index, const LogEntry& entry) {
+    if (entry.epoch == INVALID_EPOCH) return;
+    string_view id;
+    if (!extractField(entryMessage(entry), field, id)) return;
+    withId++;
+
+    key.assign(id.data(), id.size());  // The text itself, so colliding hashes never merge two ids
+    Session& session = open[key];
+    if (!session.entries.empty() && entry.epoch - session.end > gap) close(session);
+    if (session.entries.empty()) {
+        session.id.assign(id.data(), id.size());
+        session.start = entry.epoch;
+    }
+    session.end = std::max(session.end, entry.epoch);
+    session.entries.push_back(index);
+}
+
+/**
+ * Move an open session to the closed list and leave the slot empty
+ */
+void Sessionizer::close(Session& session) {
+    session.endedInError = isErrorLevel(entryLevel(logs[session.entries.back()]));
+    closed.push_back(std::move(session));
+    session = Session();
+}
+
+void Sessionizer::finish() {
+    for (auto& item : open) {
+        if (!item.second.entries.empty()) close(item.second);
+    }
+    open.clear();
+    std::sort(closed.begin(), closed.end(), [](const Session& a, const Session& b) { return a.start < b.start; });
+}
+
+/**
+ * Format a duration in seconds as "2h 05m", "3m 20s" or "45s"
+ * 
+ * @param seconds Duration
+ * @return        Short text
+ */
+static string formatDuration(int64_t seconds) {
+    ostringstream oss;
+    if (seconds >= 3600) {
+        oss << seconds / 3600 << "h " << std::setw(2) << std::setfill('0') << (seconds % 3600) / 60 << "m";
+    } else if (seconds >= 60) {
+        oss << seconds / 60 << "m " << std::setw(2) << std::setfill('0') << seconds % 60 << "s";
+    } else {
+        oss << seconds << "s";
+    }
+    return oss.str();
+}
+
+/**
+ * Reconstruct sessions from an id field and report them
+ * 
+ * Shows session counts, duration statistics, the longest sessions and the
+ * sessions whose last entry was an error; any session's timeline can then
+ * be opened by id.
+ */
+void showSessions() {
+    if (logsEmpty()) return;
+
+    string field, gapText;
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    cout << "\n  " << GREEN << "Id field (blank = " << SESSION_DEFAULT_FIELD << "): " << RESET;
+    getline(cin, field);
+    if (field.empty()) field = SESSION_DEFAULT_FIELD;
+    cout << "  " << GREEN << "Inactivity gap in minutes (blank = " << SESSION_DEFAULT_GAP_MINUTES << "): " << RESET;
+    getline(cin, gapText);
+
+    int64_t gapMinutes = SESSION_DEFAULT_GAP_MINUTES;
+    if (!gapText.empty()) {
+        try {
+            gapMinutes = std::stoll(gapText);
+        } catch (...) {
+            gapMinutes = -1;
+        }
+        if (gapMinutes <= 0) {
+            cerr << RED << "  ✗ Invalid gap: " << gapText << "\n" << RESET;
+            return;
+        }
+    }
+
+    // One streaming pass in load order
+    auto startTime = std::chrono::steady_clock::now();
+    Sessionizer sessionizer(field, gapMinutes * 60);
+    for (size_t i = 0; i < logs.size(); ++i) sessionizer.observe(static_cast<uint32_t>(i), logs[i]);
+    sessionizer.finish();
+    double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+    const vector<Session>& sessions = sessionizer.sessions();
+    if (sessions.empty()) {
+        cout << YELLOW << "\n  ⚠ No entries carry a \"" << field << "\" field.\n" << RESET;
+        return;
+    }
+
+    // Duration statistics
+    vector<int64_t> durations;
+    durations.reserve(sessions.size());
+    std::unordered_set<string_view> ids;
+    size_t errorSessions = 0;
+    for (const Session& session : sessions) {
+        durations.push_back(session.end - session.start);
+        ids.insert(session.id);
+        if (session.endedInError) errorSessions++;
+    }
+    std::sort(durations.begin(), durations.end());
+    double meanDuration = 0.0;
+    for (int64_t d : durations) meanDuration += static_cast<double>(d);
+    meanDuration /= static_cast<double>(durations.size());
+
+    cout << "\n  " << BRIGHT_CYAN << "════════════════════════════════════════════════════════════" << RESET << "\n";
+    cout << "  " << BRIGHT_CYAN << "SESSIONS BY " << field << " (gap " << gapMinutes << " min)" << RESET << "\n";
+    cout << "  " << BRIGHT_CYAN << "════════════════════════════════════════════════════════════" << RESET << "\n\n";
+    cout << "  Sessions:        " << sessions.size() << " (" << ids.size() << " distinct ids, "
+         << sessionizer.entriesWithId() << " entries)\n";
+    cout << "  Duration:        median " << formatDuration(durations[durations.size() / 2])
+         << ", mean " << formatDuration(static_cast<int64_t>(meanDuration))
+         << ", max " << formatDuration(durations.back()) << "\n";
+    cout << "  Ended in error:  " << RED << errorSessions << RESET << " ("
+         << fixed << setprecision(1) << (errorSessions * 100.0 / sessions.size()) << "%)\n";
+
+    auto printSession = [](const Session& session) {
+        cout << "    " << CYAN << formatEpoch(session.start, TIMESTAMP_ISO) << RESET << "  "
+             << std::left << std::setw(12) << session.id << std::right << " "
+             << std::setw(8) << formatDuration(session.end - session.start) << "  "
+             << session.entries.size() << " entries"
+             << (session.endedInError ? string("  ") + RED + "✗ error" + RESET : string()) << "\n";
+    };
+
+    vector<const Session*> ranked;
+    for (const Session& session : sessions) ranked.push_back(&session);
+    std::sort(ranked.begin(), ranked.end(), [](const Session* a, const Session* b) {
+        return a->end - a->start > b->end - b->start;
+    });
+    cout << "\n  " << BRIGHT_CYAN << "Longest sessions:" << RESET << "\n";
+    for (size_t i = 0; i < ranked.size() && i < SESSION_LIST_ROWS; ++i) printSession(*ranked[i]);
+
+    if (errorSessions > 0) {
+        cout << "\n  " << BRIGHT_CYAN << "Sessions that ended in error:" << RESET << "\n";
+        size_t listed = 0;
+        for (const Session& session : sessions) {
+            if (!session.endedInError) continue;
+            if (listed++ == SESSION_LIST_ROWS) {
+                cout << "    ... and " << (errorSessions - SESSION_LIST_ROWS) << " more\n";
+                break;
+            }
+            printSession(session);
+        }
+    }
+    cout << "\n  " << CYAN << "ℹ Built in " << setprecision(1) << elapsedMs << " ms" << RESET << "\n";
+
+    // Timelines on request
+    while (true) {
+        string id;
+        cout << "\n  " << GREEN << "Show timeline for id (blank = done): " << RESET;
+        if (!getline(cin, id) || id.empty()) break;
+
+        bool found = false;
+        for (const Session& session : sessions) {
+            if (session.id != id) continue;
+            found = true;
+            cout << "\n  " << BRIGHT_CYAN << "Session " << session.id << " — "
+                 << formatDuration(session.end - session.start) << ", " << session.entries.size()
+                 << " entries" << RESET << "\n";
+            size_t shown = 0;
+            for (uint32_t index : session.entries) {
+                if (shown++ == SESSION_TIMELINE_ROWS) {
+                    cout << "  ... " << (session.entries.size() - SESSION_TIMELINE_ROWS) << " more entries\n";
+                    break;
+                }
+                printLogEntry(logs[index]);
+            }
+        }
+        if (!found) cout << YELLOW << "  ⚠ No session with id " << id << "\n" << RESET;
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// IMPLEMENTATION: RESULT CACHE
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Append one index; indices must arrive in ascending order
+ * 
+ * @param index Entry index
+ */
+void EntryBitmap::add(uint32_t index) {
+    uint16_t high = static_cast<uint16_t>(index >> 16);
+    uint16_t low = static_cast<uint16_t>(index);
+    if (chunks.empty() || chunks.back().high != high) {
+        chunks.emplace_back();
+        chunks.back().high = high;
+    }
+    Chunk& chunk = chunks.back();
+
+    if (chunk.bits.empty()) {
+        if (chunk.array.size() < ARRAY_LIMIT) {
+            chunk.array.push_back(low);
+        } else {
+            // Too dense for an array: convert to a bitmap
+            chunk.bits.assign(1024, 0);
+            for (uint16_t value : chunk.array) chunk.bits[value >> 6] |= 1ull << (value & 63);
+            vector<uint16_t>().swap(chunk.array);
+            chunk.bits[low >> 6] |= 1ull << (low & 63);
+        }
+    } else {
+        chunk.bits[low >> 6] |= 1ull << (low & 63);
+    }
+    chunk.count++;
+    cardinality++;
+}
+
+/**
+ * Build a bitmap from ascending indices
+ * 
+ * @param indices Sorted entry indices
+ * @return        Compressed bitmap
+ */
+EntryBitmap EntryBitmap::fromSorted(const vector<uint32_t>& indices) {
+    EntryBitmap bitmap;
+    bitmap.appendSorted(indices);
+    return bitmap;
+}
+
+void EntryBitmap::appendSorted(const vector<uint32_t>& indices) {
+    for (uint32_t index : indices) add(index);
+    shrink();
+}
+
+/**
+ * Expand back to ascending indices
+ * 
+ * @return Entry indices
+ */
+vector<uint32_t> EntryBitmap::toVector() const {
+    vector<uint32_t> indices;
+    indices.reserve(cardinality);
+    forEach([&indices](uint32_t index) { indices.push_back(index); });
+    return indices;
+}
+
+size_t EntryBitmap::bytes() const {
+    size_t total = sizeof(EntryBitmap) + chunks.capacity() * sizeof(Chunk);
+    for (const Chunk& chunk : chunks) {
+        total += chunk.array.capacity() * sizeof(uint16_t) + chunk.bits.capacity() * sizeof(uint64_t);
+    }
+    return total;
+}
+
+/**
+ * Every index in [0, count), stored as full dense chunks
+ * 
+ * @param count Number of entries
+ * @return      Bitmap of all entries
+ */
+EntryBitmap EntryBitmap::range(uint32_t count) {
+    EntryBitmap bitmap;
+    for (uint32_t begin = 0; begin < count; begin += 65536) {
+        uint32_t size = std::min<uint32_t>(65536, count - begin);
+        Chunk chunk;
+        chunk.high = static_cast<uint16_t>(begin >> 16);
+        chunk.count = size;
+        if (size <= ARRAY_LIMIT) {
+            for (uint32_t low = 0; low < size; ++low) chunk.array.push_back(static_cast<uint16_t>(low));
+        } else {
+            chunk.bits.assign(1024, 0);
+            std::fill(chunk.bits.begin(), chunk.bits.begin() + size / 64, ~0ull);
+            if (size % 64) chunk.bits[size / 64] = (1ull << (size % 64)) - 1;
+        }
+        bitmap.pushChunk(std::move(chunk));
+    }
+    return bitmap;
+}
+
+void EntryBitmap::pushChunk(Chunk&& chunk) {
+    if (chunk.count == 0) return;
+    cardinality += chunk.count;
+    chunks.push_back(std::move(chunk));
+}
+
+/**
+ * Concatenate a bitmap whose indices all lie in later chunks
+ * 
+ * @param tail Bitmap to move in (left empty)
+ */
+void EntryBitmap::append(EntryBitmap&& tail) {
+    for (Chunk& chunk : tail.chunks) pushChunk(std::move(chunk));
+    tail.chunks.clear();
+    tail.cardinality = 0;
+}
+
+void EntryBitmap::shrink() {
+    for (Chunk& chunk : chunks) chunk.array.shrink_to_fit();
+    chunks.shrink_to_fit();
+}
+
+/**
+ * Number of set bits in a 64-bit word
+ */
+static inline unsigned popcount64(uint64_t word) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    return static_cast<unsigned>(__popcnt64(word));
+#elif defined(_MSC_VER)
+    word = word - ((word >> 1) & 0x5555555555555555ull);
+    word = (word & 0x3333333333333333ull) + ((word >> 2) & 0x3333333333333333ull);
+    word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return static_cast<unsigned>((word * 0x0101010101010101ull) >> 56);
+#else
+    return static_cast<unsigned>(__builtin_popcountll(word));
+#endif
+}
+
+/**
+ * Combine two 1024-word chunk bitmaps and count the result
+ * 
+ * AVX2 handles 4 words per step when the build enables it (-mavx2 or
+ * /arch:AVX2), SSE2 handles 2 otherwise; the scalar loop covers the rest.
+ * 
+ * @param out   Receives the combined words
+ * @param left  Left operand
+ * @param right Right operand
+ * @param op    AND, OR or ANDNOT (left and not right)
+ * @return      Number of set bits in out
+ */
+static uint32_t combineWords(uint64_t* out, const uint64_t* left, const uint64_t* right, EntryBitmap::Op op) {
+    constexpr size_t WORDS = 1024;
+    size_t w = 0;
+#if defined(__AVX2__)
+    for (; w + 4 <= WORDS; w += 4) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(left + w));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(right + w));
+        __m256i r = op == EntryBitmap::AND ? _mm256_and_si256(a, b)
+                  : op == EntryBitmap::OR  ? _mm256_or_si256(a, b)
+                  :                          _mm256_andnot_si256(b, a);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + w), r);
+    }
+#elif defined(LOG_ANALYZER_SSE2)
+    for (; w + 2 <= WORDS; w += 2) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(left + w));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(right + w));
+        __m128i r = op == EntryBitmap::AND ? _mm_and_si128(a, b)
+                  : op == EntryBitmap::OR  ? _mm_or_si128(a, b)
+                  :                          _mm_andnot_si128(b, a);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + w), r);
+    }
+#endif
+    for (; w < WORDS; ++w) {
+        out[w] = op == EntryBitmap::AND ? (left[w] & right[w])
+               : op == EntryBitmap::OR  ? (left[w] | right[w])
+               :                          (left[w] & ~right[w]);
+    }
+
+    uint32_t count = 0;
+    for (w = 0; w < WORDS; ++w) count += popcount64(out[w]);
+    return count;
+}
+
+/**
+ * Combine two chunks with the same high bits
+ * 
+ * Two arrays merge as sorted lists; an array against a bitmap tests
+ * membership when the result can only shrink the array; anything else is
+ * expanded to words and combined with combineWords(). Results small
+ * enough for an array are converted back.
+ */
+EntryBitmap::Chunk EntryBitmap::combineChunks(const Chunk& left, const Chunk& right, Op op) {
+    Chunk result;
+    result.high = left.high;
+
+    if (left.bits.empty() && right.bits.empty()) {
+        auto out = std::back_inserter(result.array);
+        if (op == AND) {
+            std::set_intersection(left.array.begin(), left.array.end(), right.array.begin(), right.array.end(), out);
+        } else if (op == OR) {
+            std::set_union(left.array.begin(), left.array.end(), right.array.begin(), right.array.end(), out);
+        } else {
+            std::set_difference(left.array.begin(), left.array.end(), right.array.begin(), right.array.end(), out);
+        }
+        result.count = static_cast<uint32_t>(result.array.size());
+        if (result.count > ARRAY_LIMIT) {
+            result.bits.assign(1024, 0);
+            for (uint16_t value : result.array) result.bits[value >> 6] |= 1ull << (value & 63);
+            vector<uint16_t>().swap(result.array);
+        }
+        return result;
+    }
+
+    if (left.bits.empty() && op != OR) {
+        // Sparse left side: keep the values whose bit is (not) set on the right
+        for (uint16_t value : left.array) {
+            bool present = (right.bits[value >> 6] >> (value & 63)) & 1;
+            if (present == (op == AND)) result.array.push_back(value);
+        }
+        result.count = static_cast<uint32_t>(result.array.size());
+        return result;
+    }
+    if (right.bits.empty() && op == AND) return combineChunks(right, left, op);
+
+    auto expand = [](const Chunk& chunk, vector<uint64_t>& words) -> const uint64_t* {
+        if (!chunk.bits.empty()) return chunk.bits.data();
+        words.assign(1024, 0);
+        for (uint16_t value : chunk.array) words[value >> 6] |= 1ull << (value & 63);
+        return words.data();
+    };
+    vector<uint64_t> leftWords, rightWords;
+    result.bits.assign(1024, 0);
+    result.count = combineWords(result.bits.data(), expand(left, leftWords), expand(right, rightWords), op);
+
+    if (result.count <= ARRAY_LIMIT) {
+        vector<uint16_t> values;
+        values.reserve(result.count);
+        for (size_t w = 0; w < result.bits.size(); ++w) {
+            for (uint64_t word = result.bits[w]; word; word &= word - 1) {
+                values.push_back(static_cast<uint16_t>(w * 64 + lowestBit64(word)));
+            }
+        }
+        result.array.swap(values);
+        vector<uint64_t>().swap(result.bits);
+    }
+    return result;
+}
+
+/**
+ * Set operation over two bitmaps, merged chunk by chunk
+ * 
+ * @param left  Left operand
+ * @param right Right operand
+ * @param op    AND, OR or ANDNOT (left and not right)
+ * @return      Combined bitmap
+ */
+EntryBitmap EntryBitmap::combine(const EntryBitmap& left, const EntryBitmap& right, Op op) {
+    EntryBitmap result;
+    size_t i = 0, j = 0;
+    while (i < left.chunks.size() || j < right.chunks.size()) {
+        bool leftOnly = j == right.chunks.size() ||
+                        (i < left.chunks.size() && left.chunks[i].high < right.chunks[j].high);
+        bool rightOnly = !leftOnly && (i == left.chunks.size() || right.chunks[j].high < left.chunks[i].high);
+
+        if (leftOnly) {
+            if (op != AND) result.pushChunk(Chunk(left.chunks[i]));
+            i++;
+        } else if (rightOnly) {
+            if (op == OR) result.pushChunk(Chunk(right.chunks[j]));
+            j++;
+        } else {
+            result.pushChunk(combineChunks(left.chunks[i], right.chunks[j], op));
+            i++;
+            j++;
+        }
+    }
+    return result;
+}
+
+/**
+ * Look up a cached result and mark it most recently used
+ * 
+ * @param key     Normalized query
+ * @param matches Receives the cached indices on a hit
+ * @param covered Receives how many entries the result covers
+ * @return        true on a hit
+ */
+bool ResultCache::find(const string& key, vector<uint32_t>& matches, size_t& covered) {
+    auto bitmap = find(key, covered);
+    if (!bitmap) return false;
+    matches = bitmap->toVector();  // Outside the lock
+    return true;
+}
+
+std::shared_ptr<const EntryBitmap> ResultCache::find(const string& key, size_t& covered) {
+    std::lock_guard<std::mutex> guard(lock);
+    auto slot = slots.find(key);
+    if (slot == slots.end()) {
+        misses++;
+        return nullptr;
+    }
+    order.splice(order.begin(), order, slot->second);
+    covered = slot->second->covered;
+    hits++;
+    return slot->second->matches;
+}
+
+/**
+ * Cache a complete result (replacing any older one for the key)
+ * 
+ * @param key     Normalized query
+ * @param matches Ascending matching indices
+ * @param covered Number of entries the result covers
+ */
+void ResultCache::store(const string& key, const vector<uint32_t>& matches, size_t covered) {
+    MemoryScope memory(MEMORY_CACHE);
+    store(key, std::make_shared<const EntryBitmap>(EntryBitmap::fromSorted(matches)), covered);
+}
+
+void ResultCache::store(const string& key, std::shared_ptr<const EntryBitmap> bitmap, size_t covered) {
+    std::lock_guard<std::mutex> guard(lock);
+    auto slot = slots.find(key);
+    if (slot != slots.end()) {
+        used -= slot->second->matches->bytes() + slot->second->key.size();
+        order.erase(slot->second);
+        slots.erase(slot);
+    }
+    size_t size = bitmap->bytes() + key.size();
+    if (size > capacity) return;  // Larger than the whole cache: not worth keeping
+
+    order.push_front(Slot{key, std::move(bitmap), covered});
+    slots[key] = order.begin();
+    used += size;
+    evict();
+}
+
+/**
+ * Merge matches found among entries appended after the result was computed
+ * The merged copy is built outside the lock and replaces the stored bitmap
+ * only if no other thread replaced it meanwhile.
+ * 
+ * @param key      Normalized query
+ * @param appended Ascending matching indices, all at or above the old coverage
+ * @param covered  New number of entries covered
+ */
+void ResultCache::extend(const string& key, const vector<uint32_t>& appended, size_t covered) {
+    std::shared_ptr<const EntryBitmap> current;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        auto slot = slots.find(key);
+        if (slot == slots.end()) return;
+        current = slot->second->matches;
+    }
+
+    std::shared_ptr<EntryBitmap> merged;
+    {
+        MemoryScope memory(MEMORY_CACHE);
+        merged = std::make_shared<EntryBitmap>(*current);
+        merged->appendSorted(appended);
+    }
+
+    std::lock_guard<std::mutex> guard(lock);
+    auto slot = slots.find(key);
+    if (slot == slots.end() || slot->second->matches != current) return;
+    used -= current->bytes();
+    slot->second->matches = std::move(merged);
+    slot->second->covered = covered;
+    used += slot->second->matches->bytes();
+    evict();
+}
+
+/**
+ * Drop least recently used results until the cache fits its cap
+ * Caller holds the lock
+ */
+void ResultCache::evict() {
+    while (used > capacity && !order.empty()) {
+        Slot& last = order.back();
+        used -= last.matches->bytes() + last.key.size();
+        slots.erase(last.key);
+        order.pop_back();
+        evictions++;
+    }
+}
+
+void ResultCache::clear() {
+    std::lock_guard<std::mutex> guard(lock);
+    order.clear();
+    slots.clear();
+    used = 0;
+}
+
+void ResultCache::setCapacity(size_t capacityBytes) {
+    std::lock_guard<std::mutex> guard(lock);
+    capacity = capacityBytes;
+    evict();
+}
+
+size_t ResultCache::entryCount() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return slots.size();
+}
+
+size_t ResultCache::memoryBytes() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return used;
+}
+
+/**
+ * Cache key of a compiled search
+ * Keywords match case-insensitively, so their lowercased text is the key;
+ * regexes are case-sensitive and keep their input byte for byte. Whitespace
+ * is never collapsed, since it is part of what is searched for.
+ * 
+ * @param query Compiled search
+ * @return      Cache key
+ */
+string resultCacheKey(const SearchQuery& query) {
+    return query.isRegex ? "search:regex:" + query.text : "search:keyword:" + query.literal;
+}
+
+/**
+ * Matches of a keyword or /regex/ search, from the cache when possible
+ * 
+ * A hit returns immediately; entries appended since the result was cached
+ * are scanned and merged into it. A miss runs the background search
+ * (streaming the first streamLimit matches) and caches the result unless
+ * the search was cancelled.
+ * 
+ * @param query       Compiled search
+ * @param streamLimit Matches to stream while a fresh search runs
+ * @return            Search outcome (elapsedMs covers the lookup on a hit)
+ */
+SearchRun cachedSearch(SearchQuery& query, size_t streamLimit) {
+    string key = resultCacheKey(query);
+    SearchRun run;
+    size_t covered = 0;
+    auto startTime = std::chrono::steady_clock::now();
+
+    if (!resultCache.find(key, run.matches, covered)) {
+        run = runBackgroundSearch(query, streamLimit);
+        if (!run.cancelled) resultCache.store(key, run.matches, logs.size());
+        return run;
+    }
+
+    // Entries added after the result was cached (e.g. a followed file)
+    if (covered < logs.size()) {
+        vector<uint32_t> appended;
+        for (size_t i = covered; i < logs.size(); ++i) {
+            if (searchMatches(query, logs[i])) appended.push_back(static_cast<uint32_t>(i));
+        }
+        run.matches.insert(run.matches.end(), appended.begin(), appended.end());
+        resultCache.extend(key, appended, logs.size());
+    }
+
+    for (size_t i = 0; i < run.matches.size() && i < streamLimit; ++i) printLogEntry(logs[run.matches[i]]);
+    run.cached = true;
+    run.completedBlocks = blockIndex.size();
+    run.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    return run;
+}
+
+/**
+ * Re-check only the entries of an earlier result set
+ * Runs on the calling thread; the cost is proportional to the number of
+ * candidates, not to the size of the log
+ * 
+ * @param query       Compiled search
+ * @param candidates  Ascending entry indices of the previous result
+ * @param streamLimit Matches to print while checking
+ * @return            Matches among the candidates plus timing figures
+ */
+SearchRun refineSearch(SearchQuery& query, const vector<uint32_t>& candidates, size_t streamLimit) {
+    SearchRun run;
+    auto startTime = std::chrono::steady_clock::now();
+    for (uint32_t index : candidates) {
+        const LogEntry& entry = logs[index];
+        run.scannedBytes += entryMessage(entry).size();
+        if (!searchMatches(query, entry)) continue;
+        if (run.matches.size() < streamLimit) printLogEntry(entry);
+        run.matches.push_back(index);
+    }
+    run.scannedEntries = candidates.size();
+    run.completedBlocks = blockIndex.size();
+    run.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    return run;
+}
+
+/**
+ * Remember a finished search so it can be refined or revisited later
+ * The oldest result set is dropped once SEARCH_STEP_LIMIT are kept
+ * 
+ * @param chain       Search and its refinements, e.g. "timeout → db"
+ * @param matches     Matching entry indices
+ * @param makeCurrent Make this the set that "+keyword" refines next
+ */
+void recordSearchStep(const string& chain, const vector<uint32_t>& matches, bool makeCurrent) {
+    if (searchSteps.size() >= SEARCH_STEP_LIMIT) {
+        searchSteps.pop_front();
+        currentStep = currentStep == 0 || currentStep == SIZE_MAX ? SIZE_MAX : currentStep - 1;
+    }
+    MemoryScope memory(MEMORY_CACHE);
+    searchSteps.push_back(SearchStep{chain, EntryBitmap::fromSorted(matches), searchHistory.size() - 1});
+    if (makeCurrent) currentStep = searchSteps.size() - 1;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// IMPLEMENTATION: LEVEL BITMAPS
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Rebuild the per-level bitmaps for the currently loaded logs
+ * Workers take 65536-entry segments (one bitmap chunk each) and the
+ * segment bitmaps are concatenated in order afterwards
+ */
+void LevelBitmaps::build() {
+    clear();
+    size_t segmentCount = (logs.size() + 65535) / 65536;
+    vector<vector<std::pair<uint32_t, EntryBitmap>>> segments(segmentCount);
+
+    unsigned workerCount = std::max(1u, std::thread::hardware_concurrency());
+    workerCount = static_cast<unsigned>(std::min<size_t>(workerCount, segmentCount));
+
+    std::atomic<size_t> nextSegment{0};
+    auto worker = [&]() {
+        TraceSpan span("bitmaps.worker");
+        MemoryScope memory(MEMORY_INDEX);
+        for (size_t s = nextSegment++; s < segmentCount; s = nextSegment++) {
+            auto& local = segments[s];
+            size_t end = std::min(logs.size(), (s + 1) * 65536);
+            EntryBitmap* last = nullptr;
+            uint32_t lastId = MessagePool::INVALID_ID;
+            for (size_t i = s * 65536; i < end; ++i) {
+                uint32_t levelId = logs[i].levelId;
+                if (levelId != lastId) {
+                    auto slot = std::find_if(local.begin(), local.end(),
+                                             [levelId](const auto& level) { return level.first == levelId; });
+                    if (slot == local.end()) {
+                        local.emplace_back(levelId, EntryBitmap());
+                        slot = local.end() - 1;
+                    }
+                    last = &slot->second;
+                    lastId = levelId;
+                }
+                last->add(static_cast<uint32_t>(i));
+            }
+        }
+    };
+
+    vector<std::thread> workers;
+    for (unsigned i = 1; i < workerCount; ++i) workers.emplace_back(worker);
+    if (workerCount > 0) worker();  // Calling thread takes part too
+    for (auto& t : workers) t.join();
+
+    for (auto& segment : segments) {
+        for (auto& [levelId, bitmap] : segment) {
+            auto slot = std::find_if(levels.begin(), levels.end(),
+                                     [id = levelId](const auto& level) { return level.first == id; });
+            if (slot == levels.end()) {
+                levels.emplace_back(levelId, EntryBitmap());
+                slot = levels.end() - 1;
+            }
+            slot->second.append(std::move(bitmap));
+        }
+    }
+    for (auto& level : levels) level.second.shrink();
+    everything = EntryBitmap::range(static_cast<uint32_t>(logs.size()));
+}
+
+void LevelBitmaps::clear() {
+    levels.clear();
+    everything = EntryBitmap();
+}
+
+/**
+ * Bitmap of the entries with one level
+ * 
+ * @param levelId Level pool id
+ * @return        Bitmap, or nullptr if no entry has the level
+ */
+const EntryBitmap* LevelBitmaps::find(uint32_t levelId) const {
+    for (const auto& level : levels) {
+        if (level.first == levelId) return &level.second;
+    }
+    return nullptr;
+}
+
+size_t LevelBitmaps::bytes() const {
+    size_t total = everything.bytes();
+    for (const auto& level : levels) total += level.second.bytes();
+    return total;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// IMPLEMENTATION: SAMPLING
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Draw lines at random byte offsets with parallel positional reads
+ * 
+ * Offsets are drawn up front and sorted so the reads sweep the file in
+ * order. Each worker opens its own handle (reads on one synchronous handle
+ * are serialized by Windows) and reads a window of SAMPLE_PROBE_BYTES
+ * around each offset with ReadFile and an OVERLAPPED position, the Windows
+ * counterpart of pread; a window that does not hold the whole line is
+ * retried once with SAMPLE_MAX_LINE_BYTES. The line containing the offset
+ * is kept. A line is hit in proportion to its length, so each one carries
+ * the weight file bytes / line bytes, which makes weighted shares and
+ * totals unbiased (Hansen-Hurwitz) whatever the lengths of the levels.
+ * 
+ * @param path       File to sample
+ * @param sampleSize Number of probes
+ * @param sample     Receives the lines, their weights and read statistics
+ * @param error      Receives a message on failure
+ * @return           false if the file could not be read
+ */
+bool sampleByOffsets(const string& path, size_t sampleSize, LogSample& sample, string& error) {
+    unsigned workerCount = std::max(1u, std::thread::hardware_concurrency());
+    workerCount = static_cast<unsigned>(std::min<size_t>(workerCount, sampleSize));
+    vector<HANDLE> files(workerCount, INVALID_HANDLE_VALUE);
+    auto closeAll = [&files]() {
+        for (HANDLE file : files) {
+            if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        }
+    };
+    for (HANDLE& file : files) {
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                           OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            closeAll();
+            error = "Could not open file: " + path;
+            return false;
+        }
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(files[0], &size) || size.QuadPart <= 0) {
+        closeAll();
+        error = "File is empty: " + path;
+        return false;
+    }
+    sample.streamed = false;
+    sample.fileBytes = static_cast<uint64_t>(size.QuadPart);
+
+    std::mt19937_64 random(std::random_device{}());
+    std::uniform_int_distribution<uint64_t> pick(0, sample.fileBytes - 1);
+    vector<uint64_t> offsets(sampleSize);
+    for (uint64_t& offset : offsets) offset = pick(random);
+    std::sort(offsets.begin(), offsets.end());
+
+    vector<string> lines(sampleSize);
+    vector<uint64_t> lineBytes(sampleSize, 0);  // 0 = no complete line found
+    std::atomic<size_t> nextProbe{0};
+    std::atomic<uint64_t> bytesRead{0};
+
+    // One probe: the line containing the offset (terminator included in its length),
+    // or false if the window does not reach both of its ends
+    auto probe = [&](HANDLE file, uint64_t offset, vector<char>& buffer, size_t p) {
+        uint64_t first = offset > buffer.size() / 2 ? offset - buffer.size() / 2 : 0;
+        OVERLAPPED position{};
+        position.Offset = static_cast<DWORD>(first);
+        position.OffsetHigh = static_cast<DWORD>(first >> 32);
+        DWORD got = 0;
+        if (!ReadFile(file, buffer.data(), static_cast<DWORD>(buffer.size()), &got, &position) || got == 0) return false;
+        bytesRead += got;
+
+        const char* begin = buffer.data();
+        const char* end = begin + got;
+        const char* at = begin + (offset - first);
+        if (at >= end) return false;
+
+        // Back to the previous newline (or the start of the file)
+        const char* start = at;
+        while (start > begin && start[-1] != '\n') start--;
+        if (start == begin && first > 0) return false;
+
+        // Forward to the newline ending the line (or the end of the file)
+        const char* stop = static_cast<const char*>(memchr(at, '\n', end - at));
+        uint64_t bytes;
+        if (stop != nullptr) {
+            bytes = static_cast<uint64_t>(stop + 1 - start);
+        } else {
+            if (first + got < sample.fileBytes) return false;
+            stop = end;
+            bytes = static_cast<uint64_t>(end - start);
+        }
+        if (stop > start && stop[-1] == '\r') stop--;
+        lines[p].assign(start, stop);
+        lineBytes[p] = bytes;
+        return true;
+    };
+
+    runOnWorkers(workerCount, "sample.probe", [&](unsigned w) {
+        vector<char> small(SAMPLE_PROBE_BYTES);
+        vector<char> large;
+        for (size_t p = nextProbe++; p < sampleSize; p = nextProbe++) {
+            if (probe(files[w], offsets[p], small, p)) continue;
+            // Long line: one wider read
+            if (sample.fileBytes <= SAMPLE_PROBE_BYTES) continue;
+            large.resize(SAMPLE_MAX_LINE_BYTES);
+            probe(files[w], offsets[p], large, p);
+        }
+    });
+    closeAll();
+
+    for (size_t p = 0; p < sampleSize; ++p) {
+        if (lineBytes[p] > 0) {
+            sample.lines.push_back(std::move(lines[p]));
+            sample.weights.push_back(static_cast<double>(sample.fileBytes) / lineBytes[p]);
+        } else {
+            sample.missedProbes++;
+        }
+    }
+    sample.bytesRead = bytesRead;
+    sample.threads = workerCount;
+    return true;
+}
+
+/**
+ * Keep a uniform sample of the lines of a stream in one pass
+ * 
+ * Reservoir sampling with geometric skips (Li's Algorithm L): after the
+ * reservoir fills, the number of lines to pass over before the next
+ * replacement is drawn directly. Line boundaries are found with memchr
+ * in large reads and skipped lines are never copied. The total line
+ * count is exact.
+ * 
+ * @param input      Stream of log lines
+ * @param sampleSize Reservoir size
+ * @param sample     Receives the lines and the line count
+ */
+void sampleByReservoir(std::istream& input, size_t sampleSize, LogSample& sample) {
+    sample.streamed = true;
+    std::mt19937_64 random(std::random_device{}());
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    auto draw = [&]() { return std::max(unit(random), std::numeric_limits<double>::min()); };
+    std::uniform_int_distribution<size_t> slot(0, sampleSize - 1);
+
+    const double k = static_cast<double>(sampleSize);
+    double weight = 1.0;
+    uint64_t nextKeep = 0;  // Line number of the next replacement (once the reservoir is full)
+    auto keep = [&](string&& line) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (sample.lines.size() < sampleSize) {
+            sample.lines.push_back(std::move(line));
+        } else {
+            sample.lines[slot(random)] = std::move(line);
+        }
+        if (sample.lines.size() == sampleSize) {
+            weight *= std::exp(std::log(draw()) / k);
+            nextKeep = sample.streamLines + static_cast<uint64_t>(std::floor(std::log(draw()) / std::log1p(-weight))) + 1;
+        }
+    };
+
+    // Lines are found with memchr in large reads; only kept lines are copied
+    vector<char> buffer(SAMPLE_STREAM_CHUNK);
+    string pending;          // Line continuing from the previous read
+    bool pendingKept = false;
+    while (input.read(buffer.data(), buffer.size()) || input.gcount() > 0) {
+        size_t got = static_cast<size_t>(input.gcount());
+        sample.bytesRead += got;
+        const char* cursor = buffer.data();
+        const char* end = cursor + got;
+        while (cursor < end) {
+            if (!pendingKept && pending.empty()) {
+                // Start of a line: decide whether it is kept
+                sample.streamLines++;
+                pendingKept = sample.lines.size() < sampleSize || sample.streamLines == nextKeep;
+            }
+            const char* stop = static_cast<const char*>(memchr(cursor, '\n', end - cursor));
+            const char* lineEnd = stop ? stop : end;
+            if (pendingKept) pending.append(cursor, lineEnd);
+            else if (!stop) pending.assign(1, '\0');  // Marks a skipped line still in progress
+            if (!stop) break;
+
+            if (pendingKept) keep(std::move(pending));
+            pending.clear();
+            pendingKept = false;
+            cursor = stop + 1;
+        }
+    }
+    if (pendingKept && !pending.empty()) keep(std::move(pending));
+}
+
+/**
+ * Parse sampled lines into a profile on all cores
+ * Workers fill private profiles that are merged afterwards
+ */
+static void profileSample(const LogSample& sample, TemplateProfile& profile) {
+    const vector<string>& lines = sample.lines;
+    unsigned workerCount = std::max(1u, std::thread::hardware_concurrency());
+    workerCount = static_cast<unsigned>(std::min<size_t>(workerCount, std::max<size_t>(lines.size(), 1)));
+    vector<TemplateProfile> partial(workerCount);
+
+    runOnWorkers(workerCount, "sample.profile", [&](unsigned w) {
+        string text;
+        for (size_t i = w; i < lines.size(); i += workerCount) {
+            addProfileLine(partial[w], lines[i], text, sample.weights.empty() ? 1.0 : sample.weights[i]);
+        }
+    });
+
+    for (TemplateProfile& part : partial) {
+        for (auto& [key, templ] : part.templates) {
+            auto& slot = profile.templates[key];
+            if (slot.count == 0) slot.text = std::move(templ.text);
+            slot.count += templ.count;
+            slot.weight += templ.weight;
+        }
+        for (const auto& [levelId, count] : part.levels) profile.levels[levelId] += count;
+        for (const auto& [levelId, weight] : part.levelWeights) profile.levelWeights[levelId] += weight;
+        profile.entries += part.entries;
+        profile.entryWeight += part.entryWeight;
+        profile.entryWeightSquares += part.entryWeightSquares;
+        profile.skipped += part.skipped;
+        profile.minEpoch = std::min(profile.minEpoch, part.minEpoch);
+        profile.maxEpoch = std::max(profile.maxEpoch, part.maxEpoch);
+    }
+}
+
+/**
+ * 95% Wilson score interval of a proportion
+ * 
+ * @param share Sampled (weighted) share with the property
+ * @param total Sample size; the effective size for weighted samples
+ * @param low   Receives the lower bound
+ * @param high  Receives the upper bound
+ */
+static void wilsonInterval(double share, double total, double& low, double& high) {
+    if (total <= 0) {
+        low = 0.0;
+        high = 1.0;
+        return;
+    }
+    const double z2 = SAMPLE_Z_95 * SAMPLE_Z_95;
+    const double n = total;
+    const double p = share;
+    double center = (p + z2 / (2 * n)) / (1 + z2 / n);
+    double margin = SAMPLE_Z_95 * std::sqrt(p * (1 - p) / n + z2 / (4 * n * n)) / (1 + z2 / n);
+    low = std::max(0.0, center - margin);
+    high = std::min(1.0, center + margin);
+}
+
+/**
+ * Display showStatistics()-style estimates from a sample
+ * 
+ * Level shares and the dominant templates are reported with 95% Wilson
+ * intervals and scaled to the whole input: by the exact line count for
+ * streamed input, or by the mean line weight (file bytes / line bytes)
+ * for random offsets, whose shares are weighted the same way and whose
+ * intervals use the effective sample size of the weights.
+ * 
+ * @param sample Sampled lines
+ * @param source File name (or "stdin") for the header
+ */
+void showSampleEstimate(const LogSample& sample, const string& source) {
+    TemplateProfile profile;
+    profileSample(sample, profile);
+
+    // Unparsable lines are part of the input too; scale counts to log entries only
+    double totalEntries = 0.0;
+    if (sample.streamed) {
+        totalEntries = sample.lines.empty() ? 0.0 : static_cast<double>(sample.streamLines) * profile.entries / sample.lines.size();
+    } else if (!sample.lines.empty()) {
+        totalEntries = profile.entryWeight / sample.lines.size();
+    }
+    double effectiveSize = profile.entryWeightSquares > 0
+        ? profile.entryWeight * profile.entryWeight / profile.entryWeightSquares : 0.0;
+    bool census = sample.streamed && sample.lines.size() == sample.streamLines;  // Every line was kept
+
+    cout << "\n  " << BRIGHT_CYAN << "════════════════════════════════════════════════════════════" << RESET << "\n";
+    cout << "  " << BRIGHT_CYAN << "SAMPLE ESTIMATE" << RESET << "\n";
+    cout << "  " << BRIGHT_CYAN << "════════════════════════════════════════════════════════════" << RESET << "\n\n";
+
+    cout << "  " << CYAN << "Source:  " << RESET << source;
+    if (sample.streamed) {
+        cout << " — reservoir of " << sample.lines.size() << " from " << sample.streamLines << " lines (one pass)\n";
+    } else {
+        cout << " (" << formatBytes(sample.fileBytes) << ") — " << sample.lines.size() << " lines at random offsets, "
+             << sample.threads << (sample.threads == 1 ? " reader thread" : " reader threads");
+        if (sample.missedProbes > 0) cout << ", " << sample.missedProbes << " probes without a full line";
+        cout << "\n";
+    }
+    double seconds = sample.elapsedMs / 1000.0;
+    cout << "  " << CYAN << "Read:    " << RESET << formatBytes(sample.bytesRead) << " in "
+         << fixed << setprecision(1) << sample.elapsedMs << " ms";
+    if (seconds > 0) cout << " (" << setprecision(0) << (sample.bytesRead / (1024.0 * 1024.0)) / seconds << " MB/s)";
+    cout << "\n";
+    cout << "  " << CYAN << "Parsed:  " << RESET << profile.entries << " of " << sample.lines.size()
+         << " sampled lines (" << profile.skipped << " unparsable)\n";
+    cout << "  " << CYAN << "Entries: " << RESET << (sample.streamed ? "" : "≈ ")
+         << setprecision(0) << totalEntries << (sample.streamed ? "" : " (estimated from line lengths)") << "\n";
+
+    if (profile.entries == 0) {
+        cout << YELLOW << "\n  ⚠ No log entries in the sample.\n" << RESET;
+        return;
+    }
+
+    // Level shares, standard levels first (as in showStatistics)
+    struct LevelShare {
+        string level;
+        uint64_t count;
+        double share;                            // Weighted share of the sampled entries
+    };
+    vector<LevelShare> levels;
+    for (const auto& [levelId, count] : profile.levels) {
+        levels.push_back({string(messagePool.view(levelId)), count, profile.levelWeights[levelId] / profile.entryWeight});
+    }
+    const vector<string> standard = {"INFO", "WARN", "ERROR"};
+    auto rank = [&standard](const string& level) {
+        return static_cast<size_t>(std::find(standard.begin(), standard.end(), level) - standard.begin());
+    };
+    std::sort(levels.begin(), levels.end(), [&rank](const LevelShare& a, const LevelShare& b) {
+        return rank(a.level) != rank(b.level) ? rank(a.level) < rank(b.level) : a.share > b.share;
+    });
+    double maxShare = 0.0;
+    for (const auto& level : levels) maxShare = std::max(maxShare, level.share);
+
+    cout << "\n  " << BRIGHT_CYAN << (census ? "Level share" : "Level share (95% interval)") << RESET << "\n";
+    for (const auto& [level, count, share] : levels) {
+        double low, high;
+        wilsonInterval(share, effectiveSize, low, high);
+        string color = rank(level) < standard.size() ? getLevelColor(level) : string(CYAN);
+        string bar;
+        for (int i = 0; i < static_cast<int>(share * 40 / maxShare); ++i) bar += "█";
+
+        cout << "  " << color << std::left << std::setw(8) << level << RESET << " " << color << bar << RESET
+             << " " << setprecision(1) << share * 100 << "%";
+        if (census) {
+            cout << "  " << count << "\n";
+        } else {
+            cout << " (" << low * 100 << "–" << high * 100 << "%)  ≈ " << setprecision(0) << share * totalEntries << "\n";
+        }
+    }
+
+    // Dominant templates
+    vector<const TemplateProfile::Template*> templates;
+    for (const auto& [key, templ] : profile.templates) templates.push_back(&templ);
+    size_t shown = std::min(SAMPLE_TOP_TEMPLATES, templates.size());
+    std::partial_sort(templates.begin(), templates.begin() + shown, templates.end(),
+                      [](const auto* a, const auto* b) { return a->weight > b->weight; });
+
+    cout << "\n  " << BRIGHT_CYAN << "─────────────────────────────────────────────────────────────" << RESET << "\n";
+    cout << "  " << BRIGHT_CYAN << (census ? "Top message templates" : "Top message templates (95% interval)") << RESET << "\n";
+    for (size_t t = 0; t < shown; ++t) {
+        double share = templates[t]->weight / profile.entryWeight;
+        double low, high;
+        wilsonInterval(share, effectiveSize, low, high);
+        cout << "  " << std::right << std::setw(5) << setprecision(1) << share * 100 << "%";
+        if (census) {
+            cout << "  " << std::setw(8) << templates[t]->count;
+        } else {
+            cout << " (" << low * 100 << "–" << high * 100 << "%)";
+        }
+        cout << "  " << templates[t]->text << "\n";
+    }
+    cout << std::left;
+
+    if (profile.minEpoch <= profile.maxEpoch) {
+        cout << "\n  " << CYAN << "Sampled span: " << RESET << formatEpoch(profile.minEpoch, TIMESTAMP_ISO)
+             << " → " << formatEpoch(profile.maxEpoch, TIMESTAMP_ISO) << "\n";
+    }
+    if (census) {
+        cout << "  " << CYAN << "ℹ The sample holds every line, so these figures are exact.\n" << RESET << "\n";
+    } else {
+        cout << "  " << CYAN << "ℹ Templates seen in the sample: " << profile.templates.size()
+             << "; rare messages may be missing entirely.\n" << RESET << "\n";
+    }
+}
+
+/**
+ * Sample a file or stream and print the estimate
+ * 
+ * Large regular files are sampled at random offsets; pipes, standard
+ * input ("-") and files under SAMPLE_STREAM_BYTES are streamed through
+ * a reservoir instead (one pass, exact line count).
+ * 
+ * @param path       File name, or "-" for standard input
+ * @param sampleSize Lines to sample
+ * @return           false if the input could not be read
+ */
+bool sampleLogSource(const string& path, size_t sampleSize) {
+    namespace fs = std::filesystem;
+
+    LogSample sample;
+    auto startTime = std::chrono::steady_clock::now();
+    if (path == "-") {
+        sampleByReservoir(cin, sampleSize, sample);
+    } else {
+        std::error_code error;
+        bool regular = fs::is_regular_file(path, error);
+        uint64_t size = regular ? fs::file_size(path, error) : 0;
+        if (regular && !error && size > SAMPLE_STREAM_BYTES) {
+            string message;
+            if (!sampleByOffsets(path, sampleSize, sample, message)) {
+                cerr << RED << "  ✗ " << message << "\n" << RESET;
+                return false;
+            }
+        } else {
+            ifstream file(path, std::ios::binary);
+            if (!file.is_open()) {
+                cerr << RED << "  ✗ Could not open file: " << path << "\n" << RESET;
+                return false;
+            }
+            sampleByReservoir(file, sampleSize, sample);
+        }
+    }
+    sample.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+    showSampleEstimate(sample, path == "-" ? "stdin" : path);
+    return true;
+}
+
+/**
+ * Prompt for a file and sample size, then show the estimate
+ * The loaded logs are left untouched
+ */
+void sampleLogFile() {
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    cout << "\n  " << GREEN << "Enter log file name: " << RESET;
+    string filename;
+    getline(cin, filename);
+    if (filename.empty()) {
+        cerr << RED << "  ✗ No filename provided.\n" << RESET;
+        return;
+    }
+    if (!isValidLogPath(filename)) {
+        cerr << RED << "  ✗ Invalid or unauthorized file path.\n" << RESET;
+        return;
+    }
+
+    cout << "  " << YELLOW << "Lines to sample (blank = " << SAMPLE_DEFAULT_LINES << "): " << RESET;
+    string text;
+    getline(cin, text);
+    size_t sampleSize = SAMPLE_DEFAULT_LINES;
+    if (!text.empty()) {
+        try {
+            sampleSize = std::stoul(text);
+        } catch (...) {
+            cerr << RED << "  ✗ Invalid sample size.\n" << RESET;
+            return;
+        }
+    }
+    sampleSize = std::clamp(sampleSize, SAMPLE_MIN_LINES, SAMPLE_MAX_LINES);
+
+    sampleLogSource(filename, sampleSize);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// IMPLEMENTATION: INSTRUMENTATION
+// ═══════════════════════════════════════════════════════════════════════════
+
+static const char* const PHASE_NAMES[PHASE_COUNT] = {
+    "load.validate", "load.open", "load.read", "load.parse", "load.store",
+    "index", "sort", "search", "query", "statistics", "export"
+};
+static const char* const COUNTER_NAMES[COUNTER_COUNT] = {
+    "bytes_read", "lines", "parsed", "skipped", "allocations", "entries_scanned", "matches", "exported"
+};
+
+static const char* const MEMORY_TAG_NAMES[MEMORY_TAG_COUNT] = {"other", "loader", "index", "cache", "query"};
+
+static thread_local MemoryTag currentMemoryTag = MEMORY_OTHER;
+
+/**
+ * Prefix of every block from operator new: requested size and subsystem
+ * (16 bytes, so the block itself keeps malloc's alignment)
+ */
+struct AllocationHeader {
+    uint64_t size;
+    uint64_t tag;                                // UNTRACKED_BLOCK if allocated while tracking was off
+};
+
+static constexpr uint64_t UNTRACKED_BLOCK = ~0ULL;
+
+/**
+ * Whether blocks from operator new may carry an AllocationHeader
+ * 
+ * A C++ runtime loaded as a DLL (libstdc++-6.dll, libc++.dll, msvcp140.dll)
+ * does not see this program's operator new, yet code inlined here may free
+ * blocks it allocated, and those have no header. Headers are therefore only
+ * used when the runtime is linked in statically (-static-libstdc++, /MT);
+ * otherwise operator new is plain malloc/free, which any block survives.
+ * Decided once, before the first block is allocated or freed.
+ */
+static bool allocationHeaders() noexcept {
+    static const bool usable = GetModuleHandleA("libstdc++-6.dll") == nullptr &&
+                               GetModuleHandleA("libc++.dll") == nullptr &&
+                               GetModuleHandleA("msvcp140.dll") == nullptr;
+    return usable;
+}
+
+/**
+ * Allocate, with a tracking header when the runtime allows it; counts the
+ * call while instrumentation is on
+ */
+static void* trackedAllocate(std::size_t size) noexcept {
+    if (profiler.enabled()) profiler.count(COUNTER_ALLOCATIONS);
+    if (!allocationHeaders()) return std::malloc(size ? size : 1);
+
+    if (size > SIZE_MAX - sizeof(AllocationHeader)) return nullptr;  // Header + size would wrap
+    auto* header = static_cast<AllocationHeader*>(std::malloc(sizeof(AllocationHeader) + size));
+    if (header == nullptr) return nullptr;
+    header->size = size;
+    header->tag = UNTRACKED_BLOCK;
+    if (memoryTracker.enabled()) {
+        MemoryTag tag = currentMemoryTag;
+        header->tag = tag;
+        memoryTracker.allocated(tag, size);
+    }
+    return header + 1;
+}
+
+static void trackedRelease(void* memory) noexcept {
+    if (memory == nullptr) return;
+    if (!allocationHeaders()) {
+        std::free(memory);
+        return;
+    }
+    auto* header = static_cast<AllocationHeader*>(memory) - 1;
+    if (header->tag != UNTRACKED_BLOCK) {
+        memoryTracker.released(static_cast<MemoryTag>(header->tag), header->size);
+    }
+    std::free(header);
+}
+
+/**
+ * Replaced allocation functions: every block is tagged with the calling
+ * thread's subsystem. The nothrow forms are replaced too, because some
+ * standard libraries implement them with malloc directly; array forms
+ * forward to these, aligned forms stay with the standard library. The
+ * deletes stay out of line so GCC does not see malloc/free as a
+ * new/delete mismatch.
+ */
+void* operator new(std::size_t size) {
+    if (void* memory = trackedAllocate(size)) return memory;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return trackedAllocate(size);
+}
+
+LOG_ANALYZER_NOINLINE void operator delete(void* memory) noexcept {
+    trackedRelease(memory);
+}
+
+LOG_ANALYZER_NOINLINE void operator delete(void* memory, std::size_t) noexcept {
+    trackedRelease(memory);
+}
+
+LOG_ANALYZER_NOINLINE void operator delete(void* memory, const std::nothrow_t&) noexcept {
+    trackedRelease(memory);
+}
+
+void MemoryTracker::setEnabled(bool value) {
+    active.store(value && allocationHeaders(), std::memory_order_relaxed);
+}
+
+void MemoryTracker::allocated(MemoryTag tag, size_t bytes) {
+    Totals& total = totals[tag];
+    total.allocations.fetch_add(1, std::memory_order_relaxed);
+    int64_t live = total.live.fetch_add(static_cast<int64_t>(bytes), std::memory_order_relaxed) + static_cast<int64_t>(bytes);
+    int64_t peak = total.peak.load(std::memory_order_relaxed);
+    while (live > peak && !total.peak.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+}
+
+MemoryScope::MemoryScope(MemoryTag tag) : previous(currentMemoryTag) {
+    currentMemoryTag = tag;
+}
+
+MemoryScope::~MemoryScope() {
+    currentMemoryTag = previous;
+}
+
+MemoryTag MemoryScope::current() {
+    return currentMemoryTag;
+}
+
+/**
+ * Record timed calls of a phase
+ * 
+ * @param phase       Phase
+ * @param nanoseconds Total duration of the calls
+ * @param calls       Number of calls
+ * @param longest     Longest single call (defaults to the total)
+ */
+void Profiler::addTime(Phase phase, uint64_t nanoseconds, uint64_t calls, uint64_t longest) {
+    PhaseTotals& totals = phases[phase];
+    totals.calls.fetch_add(calls, std::memory_order_relaxed);
+    totals.nanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+    if (longest == 0) longest = nanoseconds;
+    uint64_t seen = totals.longest.load(std::memory_order_relaxed);
+    while (longest > seen && !totals.longest.compare_exchange_weak(seen, longest, std::memory_order_relaxed)) {}
+}
+
+void Profiler::reset() {
+    for (PhaseTotals& totals : phases) {
+        totals.calls = 0;
+        totals.nanoseconds = 0;
+        totals.longest = 0;
+    }
+    for (auto& counter : counters) counter = 0;
+}
+
+/**
+ * Display the phase table and counters
+ */
+void Profiler::printReport() const {
+    cout << "\n  " << BRIGHT_CYAN << "════════════════════════════════════════════════════════════" << RESET << "\n";
+    cout << "  " << BRIGHT_CYAN << "TIMING REPORT" << RESET << "\n";
+    cout << "  " << BRIGHT_CYAN << "════════════════════════════════════════════════════════════" << RESET << "\n\n";
+    cout << "  Instrumentation is " << (enabled() ? GREEN "on" : YELLOW "off") << RESET << "\n\n";
+
+    uint64_t grandTotal = 0;
+    for (const PhaseTotals& totals : phases) grandTotal += totals.nanoseconds.load();
+
+    cout << "  " << CYAN << std::left << std::setw(16) << "Phase" << std::right << std::setw(12) << "Calls"
+         << std::setw(12) << "Total ms" << std::setw(12) << "Mean µs" << std::setw(12) << "Max µs"
+         << std::setw(8) << "Share" << RESET << "\n";
+    for (int p = 0; p < PHASE_COUNT; ++p) {
+        uint64_t calls = phases[p].calls.load();
+        if (calls == 0) continue;
+        double totalNs = static_cast<double>(phases[p].nanoseconds.load());
+        cout << "  " << std::left << std::setw(16) << PHASE_NAMES[p] << std::right << std::setw(12) << calls
+             << fixed << setprecision(1) << std::setw(12) << totalNs / 1e6
+             << setprecision(2) << std::setw(12) << totalNs / calls / 1e3
+             << std::setw(12) << phases[p].longest.load() / 1e3
+             << setprecision(1) << std::setw(7) << (grandTotal ? totalNs * 100.0 / grandTotal : 0.0) << "%\n";
+    }
+    if (grandTotal == 0) cout << "  (no phases recorded yet)\n";
+
+    cout << "\n  " << BRIGHT_CYAN << "─────────────────────────────────────────────────────────────" << RESET << "\n";
+    for (int c = 0; c < COUNTER_COUNT; ++c) {
+        uint64_t value = counters[c].load();
+        cout << "  " << CYAN << std::left << std::setw(18) << COUNTER_NAMES[c] << RESET
+             << (c == COUNTER_BYTES_READ ? formatBytes(value) : std::to_string(value)) << "\n";
+    }
+    cout << std::right << "\n";
+}
+
+/**
+ * Write the totals as JSON: phases (calls, total/mean/max) and counters
+ * 
+ * @param path  Output file
+ * @param error Receives a message on failure
+ * @return      false if the file could not be written
+ */
+bool Profiler::writeJson(const string& path, string& error) const {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        error = "Could not create file: " + path;
+        return false;
+    }
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    out << "{\n  \"generated\": " << std::chrono::duration_cast<std::chrono::seconds>(now).count()
+        << ",\n  \"enabled\": " << (enabled() ? "true" : "false") << ",\n  \"phases\": {";
+    bool first = true;
+    for (int p = 0; p < PHASE_COUNT; ++p) {
+        uint64_t calls = phases[p].calls.load();
+        uint64_t totalNs = phases[p].nanoseconds.load();
+        out << (first ? "\n" : ",\n") << "    \"" << PHASE_NAMES[p] << "\": {\"calls\": " << calls
+            << ", \"total_ns\": " << totalNs << ", \"mean_ns\": " << (calls ? totalNs / calls : 0)
+            << ", \"max_ns\": " << phases[p].longest.load() << "}";
+        first = false;
+    }
+    out << "\n  },\n  \"counters\": {";
+    for (int c = 0; c < COUNTER_COUNT; ++c) {
+        out << (c ? ",\n" : "\n") << "    \"" << COUNTER_NAMES[c] << "\": " << counters[c].load();
+    }
+    out << "\n  }\n}\n";
+
+    if (!out.good()) {
+        error = "Write failed: " + path;
+        return false;
+    }
+    return true;
+}
+
+ScopedTimer::ScopedTimer(Phase phase) : phase(phase), active(profiler.enabled()), traced(tracer.enabled()) {
+    if (traced) tracer.record(PHASE_NAMES[phase], 'B');
+    if (active) start = std::chrono::steady_clock::now();
+}
+
+void ScopedTimer::stop() {
+    if (active) {
+        active = false;
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        profiler.addTime(phase, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+    if (traced) {
+        traced = false;
+        tracer.record(PHASE_NAMES[phase], 'E');
+    }
+}
+
+PhaseLaps::PhaseLaps(bool active) : active(active) {
+    if (active) last = std::chrono::steady_clock::now();
+}
+
+void PhaseLaps::lap(Phase phase) {
+    if (!active) return;
+    auto now = std::chrono::steady_clock::now();
+    uint64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - last).count();
+    nanoseconds[phase] += elapsed;
+    calls[phase]++;
+    longest[phase] = std::max(longest[phase], elapsed);
+    last = now;
+}
+
+PhaseLaps::~PhaseLaps() {
+    if (!active) return;
+    for (int p = 0; p < PHASE_COUNT; ++p) {
+        if (calls[p]) profiler.addTime(static_cast<Phase>(p), nanoseconds[p], calls[p], std::max<uint64_t>(longest[p], 1));
+    }
+}
+
+/**
+ * Per-thread trace state: the claimed ring goes back to the recorder's
+ * pool when the thread exits
+ */
+struct TraceThread {
+    TraceRing* ring = nullptr;
+    uint32_t id = 0;
+    ~TraceThread() {
+        if (ring) tracer.release(ring);
+    }
+};
+static thread_local TraceThread traceThread;
+
+/**
+ * Drop the events of any earlier recording and start a new one
+ * (called from the menu thread while no workers are running)
+ */
+void TraceRecorder::start() {
+    {
+        std::lock_guard<std::mutex> guard(registry);
+        for (auto& ring : rings) ring->head.store(0, std::memory_order_relaxed);
+    }
+    epoch.store(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count(), std::memory_order_relaxed);
+    if (traceThread.id == 0) traceThread.id = nextThread++;
+    mainThread = traceThread.id;
+    active.store(true, std::memory_order_release);
+}
+
+/**
+ * Append an event to the calling thread's ring, claiming one on first use
+ * 
+ * @param name Span name (must outlive the recorder: use string literals)
+ * @param type 'B' (begin) or 'E' (end)
+ */
+void TraceRecorder::record(const char* name, char type) {
+    TraceThread& self = traceThread;
+    if (self.ring == nullptr) {
+        std::lock_guard<std::mutex> guard(registry);
+        if (idle.empty()) {
+            rings.push_back(std::make_unique<TraceRing>());
+            self.ring = rings.back().get();
+        } else {
+            self.ring = idle.back();
+            idle.pop_back();
         }
+        if (self.id == 0) self.id = nextThread++;
     }
-    
-    // Display buffered output and footer
-    cout << oss.str();
-    cout << "  " << BRIGHT_CYAN << "─────────────────────────────────────────────────────────────" << RESET << "\n";
-    cout << "  " << BRIGHT_CYAN << "Total: " << count << " entries" << RESET << "\n\n";
+
+    int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    TraceRing& ring = *self.ring;
+    uint64_t head = ring.head.load(std::memory_order_relaxed);
+    TraceEvent& event = ring.events[head & (TRACE_RING_EVENTS - 1)];
+    event.nanoseconds = static_cast<uint64_t>(std::max<int64_t>(0, now - epoch.load(std::memory_order_relaxed)));
+    event.name = name;
+    event.thread = self.id;
+    event.type = type;
+    ring.head.store(head + 1, std::memory_order_release);
+}
+
+void TraceRecorder::release(TraceRing* ring) {
+    std::lock_guard<std::mutex> guard(registry);
+    idle.push_back(ring);
 }
 
 /**
- * Display logs with pagination (unused placeholder function)
+ * Write every ring as Chrome trace-event JSON (timestamps in microseconds)
  * 
- * @param filter   Log level filter
- * @param pageSize Number of entries per page
+ * @param path    Output file
+ * @param written Receives the number of events written
+ * @param dropped Receives the number of events lost to full rings
+ * @param error   Receives a message on failure
+ * @return        false if the file could not be written
  */
-void viewLogsPaginated(const string& filter, int pageSize = 20) {
-    if(logsEmpty()) return;
+bool TraceRecorder::writeJson(const string& path, size_t& written, size_t& dropped, string& error) {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        error = "Could not create file: " + path;
+        return false;
+    }
 
-    vector<LogEntry> filtered = getFilteredLogs(filter);
-    if(filtered.empty()) {
-        cout << RED << "\n  ✗ No logs match the filter.\n" << RESET;
-        return;
+    written = dropped = 0;
+    vector<TraceEvent> events;
+    {
+        std::lock_guard<std::mutex> guard(registry);
+        for (const auto& ring : rings) {
+            uint64_t head = ring->head.load(std::memory_order_acquire);
+            uint64_t first = head > TRACE_RING_EVENTS ? head - TRACE_RING_EVENTS : 0;
+            dropped += first;
+            for (uint64_t i = first; i < head; ++i) events.push_back(ring->events[i & (TRACE_RING_EVENTS - 1)]);
+        }
+    }
+    std::stable_sort(events.begin(), events.end(),
+                     [](const TraceEvent& a, const TraceEvent& b) { return a.nanoseconds < b.nanoseconds; });
+
+    vector<uint32_t> threads;
+    for (const TraceEvent& event : events) threads.push_back(event.thread);
+    std::sort(threads.begin(), threads.end());
+    threads.erase(std::unique(threads.begin(), threads.end()), threads.end());
+
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    out << "  {\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 0, \"args\": {\"name\": \"Log File Analyzer\"}}";
+    for (uint32_t thread : threads) {
+        out << ",\n  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << thread
+            << ", \"args\": {\"name\": \"" << (thread == mainThread ? string("main") : "worker " + std::to_string(thread))
+            << "\"}}";
     }
+    char timestamp[32];
+    for (const TraceEvent& event : events) {
+        snprintf(timestamp, sizeof(timestamp), "%.3f", event.nanoseconds / 1e3);
+        out << ",\n  {\"name\": \"" << event.name << "\", \"ph\": \"" << event.type << "\", \"ts\": " << timestamp
+            << ", \"pid\": 1, \"tid\": " << event.thread << "}";
+    }
+    out << "\n]}\n";
 
-    size_t totalPages = (filtered.size() + pageSize - 1) / pageSize;
-    size_t currentPage = 0;
+    if (!out.good()) {
+        error = "Write failed: " + path;
+        return false;
+    }
+    written = events.size();
+    return true;
+}
 
-    // Pagination loop
-    while(true) {
-        cout << "\033[H\033[2J";  // Clear screen
-        
-        // Display header with page info
-        cout << "\n  " << BRIGHT_CYAN << "════════════════════════════════════════════════════════════" << RESET << "\n";
-        if(filter.empty()) {
-            cout << "  " << BRIGHT_CYAN << "ALL LOGS (Page " << (currentPage + 1) << "/" << totalPages << ")" << RESET << "\n";
-        } else {
-            cout << "  " << BRIGHT_CYAN << filter << " LOGS (Page " << (currentPage + 1) << "/" << totalPages << ")" << RESET << "\n";
-        }
-        cout << "  " << BRIGHT_CYAN << "════════════════════════════════════════════════════════════" << RESET << "\n\n";
+TraceSpan::TraceSpan(const char* name) : name(tracer.enabled() ? name : nullptr) {
+    if (this->name) tracer.record(name, 'B');
+}
 
-        // Calculate page range
-        size_t start = currentPage * pageSize;
-        size_t end = std::min(start + pageSize, filtered.size());
+TraceSpan::~TraceSpan() {
+    if (name) tracer.record(name, 'E');
+}
 
-        // Display logs for current page
-        for(size_t i = start; i < end; ++i) {
-            const auto& entry = filtered[i];
-            string levelColor = getLevelColor(entry.level);
-            cout << "  " << CYAN << entry.timestamp << RESET 
-                 << " [" << levelColor << entry.level << RESET << "] " 
-                 << entry.message << "\n";
-        }
+/**
+ * Begin recording a trace that is written to a file when recording stops
+ * (from the menu, or at exit)
+ * 
+ * @param path Trace file
+ */
+void startTracing(const string& path) {
+    static bool exitHandler = false;
+    if (!exitHandler) {
+        std::atexit(writeTraceAtExit);
+        exitHandler = true;
+    }
+    traceOutput = path;
+    tracer.start();
+}
 
-        // Display navigation footer
-        cout << "\n  " << BRIGHT_CYAN << "─────────────────────────────────────────────────────────────" << RESET << "\n";
-        cout << "  " << BRIGHT_CYAN << "Showing " << (start + 1) << "-" << end << " of " << filtered.size() << " entries" << RESET << "\n";
-        cout << "  [N]ext  [P]revious  [Q]uit: ";
+/**
+ * Stop recording and write the trace file
+ * 
+ * @return false if the file could not be written
+ */
+bool finishTracing() {
+    tracer.stop();
+    size_t written = 0, dropped = 0;
+    string error;
+    if (!tracer.writeJson(traceOutput, written, dropped, error)) {
+        cerr << RED << "  ✗ " << error << "\n" << RESET;
+        return false;
+    }
+    cout << GREEN << "  ✓ Trace of " << written << " events written to " << traceOutput
+         << " (open in Perfetto or chrome://tracing)\n" << RESET;
+    if (dropped > 0) {
+        cout << YELLOW << "  ⚠ " << dropped << " older events were overwritten (" << TRACE_RING_EVENTS
+             << " kept per thread)\n" << RESET;
+    }
+    return true;
+}
 
-        // Handle user input
-        char input;
-        cin >> input;
-        input = std::tolower(input);
+/**
+ * Write the trace if recording is still on when the program exits
+ */
+void writeTraceAtExit() {
+    if (tracer.enabled()) finishTracing();
+}
 
-        if(input == 'n' && currentPage < totalPages - 1) {
-            currentPage++;
-        } else if(input == 'p' && currentPage > 0) {
-            currentPage--;
-        } else if(input == 'q') {
-            break;
-        }
+/**
+ * Write the --profile summary when the program exits
+ */
+void writeProfileAtExit() {
+    string error;
+    if (profiler.writeJson(profileOutput, error)) {
+        cout << CYAN << "  ℹ Timing summary written to " << profileOutput << "\n" << RESET;
+    } else {
+        cerr << RED << "  ✗ " << error << "\n" << RESET;
     }
 }
 
-// ═══════════════════════════════════════════════════════════════════════════
-// IMPLEMENTATION: SEARCH LOGS
-// ═══════════════════════════════════════════════════════════════════════════
+/**
+ * Working set of the process
+ * 
+ * @param current Receives the current working set (RSS)
+ * @param peak    Receives the peak working set
+ * @return        false if the counters are unavailable
+ */
+static bool processMemory(size_t& current, size_t& peak) {
+    PROCESS_MEMORY_COUNTERS counters{};
+    counters.cb = sizeof(counters);
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return false;
+    current = counters.WorkingSetSize;
+    peak = counters.PeakWorkingSetSize;
+    return true;
+}
 
 /**
- * Search logs for keyword (case-insensitive)
- * Searches both message content and log level
- * Automatically adds search to history
+ * Sizes of the structures holding the loaded logs, largest first
+ * Mapped files are listed separately: they count toward RSS only as far
+ * as their pages have been touched.
+ * 
+ * @param mapped Receives the mapped (non-heap) components
+ * @return       Heap components
  */
-void searchLogs() {
-    if (logsEmpty()) return;
+static vector<std::pair<string, size_t>> memoryComponents(vector<std::pair<string, size_t>>& mapped) {
+    size_t stepBytes = 0;
+    for (const SearchStep& step : searchSteps) stepBytes += step.matches.bytes() + step.chain.size();
+    vector<std::pair<string, size_t>> heap = {
+        {"entry store", logs.residentBytes()},
+        {"string pool", messagePool.arenaBytes() + messagePool.indexBytes()},
+        {"skip index", blockIndex.capacity() * sizeof(LogBlockIndex)},
+        {"level bitmaps", levelBitmaps.bytes()},
+        {"result cache", resultCache.memoryBytes()},
+        {"search results", stepBytes},
+    };
+    auto largestFirst = [](const auto& a, const auto& b) { return a.second > b.second; };
+    std::stable_sort(heap.begin(), heap.end(), largestFirst);
 
-    // Get search keyword from user
-    string keyword;
-    cout << "\n  " << YELLOW << "Enter search keyword: " << RESET;
-    cin.ignore(numeric_limits<streamsize>::max(), '\n');
-    getline(cin, keyword);
+    mapped.clear();
+    if (logs.sealedBytes() > 0) mapped.emplace_back("spilled entries", logs.sealedBytes());
+    if (sourceFile.isOpen()) mapped.emplace_back("source file", sourceFile.fileSize());
+    return heap;
+}
 
-    // Validate input
-    if (keyword.empty()) {
-        cerr << RED << "  ✗ No search keyword provided.\n" << RESET;
-        return;
+/**
+ * Subsystems ordered by live heap bytes, largest first
+ */
+static vector<MemoryTag> subsystemsBySize() {
+    vector<MemoryTag> tags;
+    for (int t = 0; t < MEMORY_TAG_COUNT; ++t) tags.push_back(static_cast<MemoryTag>(t));
+    std::stable_sort(tags.begin(), tags.end(), [](MemoryTag a, MemoryTag b) {
+        return memoryTracker.liveBytes(a) > memoryTracker.liveBytes(b);
+    });
+    return tags;
+}
+
+/**
+ * Memory summary printed after each load: RSS and cost per entry, the
+ * largest structures and, while instrumentation is on, heap bytes per subsystem
+ */
+void printMemorySummary() {
+    size_t entries = std::max<size_t>(logs.size(), 1);
+    vector<std::pair<string, size_t>> mapped;
+    auto heap = memoryComponents(mapped);
+    size_t structureBytes = 0;
+    for (const auto& component : heap) structureBytes += component.second;
+
+    size_t rss = 0, peak = 0;
+    cout << CYAN << "  ℹ Memory: ";
+    if (processMemory(rss, peak)) {
+        cout << "RSS " << formatBytes(rss) << " (peak " << formatBytes(peak) << "), " << rss / entries << " B per entry; ";
     }
+    cout << "structures " << formatBytes(structureBytes) << " (" << structureBytes / entries << " B per entry)\n";
 
-    // Track search in history
-    searchHistory.push_back(keyword);
+    cout << "  ℹ Largest: ";
+    for (size_t i = 0; i < heap.size() && i < MEMORY_SUMMARY_COMPONENTS; ++i) {
+        cout << (i ? ", " : "") << heap[i].first << " " << formatBytes(heap[i].second);
+    }
+    cout << "\n";
+    if (memoryTracker.enabled()) {
+        cout << "  ℹ Heap by subsystem: ";
+        bool first = true;
+        for (MemoryTag tag : subsystemsBySize()) {
+            cout << (first ? "" : ", ") << MEMORY_TAG_NAMES[tag] << " " << formatBytes(memoryTracker.liveBytes(tag));
+            first = false;
+        }
+        cout << "\n";
+    }
+    cout << RESET;
+}
 
-    // Display search header
+/**
+ * Display the full memory report: process totals, every structure with
+ * its cost per entry, and live/peak heap bytes per subsystem
+ */
+void showMemoryReport() {
     cout << "\n  " << BRIGHT_CYAN << "════════════════════════════════════════════════════════════" << RESET << "\n";
-    cout << "  " << BRIGHT_CYAN << "SEARCH RESULTS FOR: \"" << keyword << "\" (case-insensitive)" << RESET << "\n";
+    cout << "  " << BRIGHT_CYAN << "MEMORY REPORT" << RESET << "\n";
     cout << "  " << BRIGHT_CYAN << "════════════════════════════════════════════════════════════" << RESET << "\n\n";
 
-    int matchCount = 0;
-    ostringstream oss;
-    
-    // Search through all log entries
-    for (const auto& entry : logs) {
-        // Check if keyword appears in message or level
-        if (caseInsensitiveSearch(entry.message, keyword) || 
-            caseInsensitiveSearch(entry.level, keyword)) {
-            
-            string levelColor = getLevelColor(entry.level);
+    double entries = static_cast<double>(std::max<size_t>(logs.size(), 1));
+    bool tracking = memoryTracker.enabled();
+    vector<std::pair<string, size_t>> mapped;
+    auto heap = memoryComponents(mapped);
+    size_t heapBytes = 0;
+    if (tracking) {
+        for (int t = 0; t < MEMORY_TAG_COUNT; ++t) heapBytes += memoryTracker.liveBytes(static_cast<MemoryTag>(t));
+    } else {
+        for (const auto& component : heap) heapBytes += component.second;
+    }
+    size_t rss = 0, peak = 0;
+    bool haveRss = processMemory(rss, peak);
 
-            oss << "  " << CYAN << entry.timestamp << RESET 
-                << " [" << levelColor << entry.level << RESET << "] " 
-                << entry.message << "\n";
-            matchCount++;
-        }
+    cout << "  " << CYAN << std::left << std::setw(22) << "Entries" << RESET << logs.size() << "\n";
+    if (haveRss) {
+        cout << "  " << CYAN << std::setw(22) << "RSS (peak)" << RESET << formatBytes(rss) << " (" << formatBytes(peak) << ")\n";
+        cout << "  " << CYAN << std::setw(22) << "RSS per entry" << RESET << fixed << setprecision(1) << rss / entries << " B\n";
+    }
+    cout << "  " << CYAN << std::setw(22) << (tracking ? "Tracked heap" : "Structures") << RESET << formatBytes(heapBytes) << "\n";
+    cout << "  " << CYAN << std::setw(22) << (tracking ? "Heap per entry" : "Structures per entry") << RESET
+         << fixed << setprecision(1) << heapBytes / entries << " B\n";
+
+    cout << "\n  " << CYAN << std::setw(22) << "Structure" << std::right << std::setw(12) << "Bytes"
+         << std::setw(14) << "Per entry" << std::setw(8) << "Heap" << RESET << "\n";
+    for (const auto& [name, bytes] : heap) {
+        cout << "  " << std::left << std::setw(22) << name << std::right << std::setw(12) << formatBytes(bytes)
+             << std::setw(12) << setprecision(1) << bytes / entries << " B"
+             << std::setw(7) << (heapBytes ? bytes * 100.0 / heapBytes : 0.0) << "%\n";
+    }
+    for (const auto& [name, bytes] : mapped) {
+        cout << "  " << std::left << std::setw(22) << (name + " (mapped)") << std::right << std::setw(12)
+             << formatBytes(bytes) << std::setw(12) << setprecision(1) << bytes / entries << " B\n";
     }
 
-    // Display results or no-match message
-    if (matchCount > 0) {
-        cout << oss.str();
-        cout << "\n  " << BRIGHT_CYAN << "─────────────────────────────────────────────────────────────" << RESET << "\n";
-        cout << "  " << BRIGHT_CYAN << "Found: " << matchCount << " matching entries" << RESET << "\n";
-    } else {
-        cout << "  " << RED << "✗ No matching logs found.\n" << RESET;
+    if (!tracking) {
+        cout << "\n  " << CYAN << (allocationHeaders()
+            ? "ℹ Heap per subsystem is tracked while instrumentation is on (from the moment it is turned on)."
+            : "ℹ Heap per subsystem needs a statically linked C++ runtime (-static-libstdc++ or /MT).")
+             << RESET << "\n\n";
+        return;
+    }
+    cout << "\n  " << CYAN << std::left << std::setw(22) << "Subsystem" << std::right << std::setw(12) << "Live"
+         << std::setw(12) << "Peak" << std::setw(14) << "Allocations" << RESET << "\n";
+    for (MemoryTag tag : subsystemsBySize()) {
+        cout << "  " << std::left << std::setw(22) << MEMORY_TAG_NAMES[tag] << std::right
+             << std::setw(12) << formatBytes(memoryTracker.liveBytes(tag))
+             << std::setw(12) << formatBytes(memoryTracker.peakBytes(tag))
+             << std::setw(14) << memoryTracker.allocations(tag) << "\n";
+    }
+    cout << "\n  " << CYAN << "ℹ Heap bytes are requested sizes of blocks allocated since instrumentation was turned on;"
+         << " allocator overhead shows up only in RSS." << RESET << "\n\n";
+}
+
+/**
+ * Turn instrumentation on or off, show the report, write the JSON
+ * summary, reset the totals, start/stop trace recording or show the
+ * memory report
+ */
+void instrumentationMenu() {
+    while (true) {
+        cout << "\n  " << BRIGHT_CYAN << "INSTRUMENTATION [" << (profiler.enabled() ? "on" : "off") << "]" << RESET << "\n";
+        cout << "  1. " << (profiler.enabled() ? "Turn Off" : "Turn On") << "\n";
+        cout << "  2. Show Timing Report\n";
+        cout << "  3. Write JSON Summary\n";
+        cout << "  4. Reset Totals\n";
+        cout << "  5. " << (tracer.enabled() ? "Stop Trace Recording (writes " + traceOutput + ")" : string("Start Trace Recording")) << "\n";
+        cout << "  6. Memory Report\n";
+        cout << "  7. Back\n";
+        cout << "\n  " << BRIGHT_CYAN << "Select option (1-7): " << RESET;
+
+        int choice;
+        cin >> choice;
+        if (cin.fail()) {
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            cout << RED << "\n  ✗ Invalid input.\n" << RESET;
+            return;
+        }
+
+        switch (choice) {
+            case 1:
+                profiler.setEnabled(!profiler.enabled());
+                memoryTracker.setEnabled(profiler.enabled());
+                cout << GREEN << "  ✓ Instrumentation " << (profiler.enabled() ? "on" : "off") << ".\n" << RESET;
+                break;
+            case 2:
+                profiler.printReport();
+                break;
+            case 3: {
+                cout << "  " << YELLOW << "JSON file (blank = " << PROFILE_DEFAULT_FILE << "): " << RESET;
+                string path;
+                cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                getline(cin, path);
+                if (path.empty()) path = PROFILE_DEFAULT_FILE;
+                string error;
+                if (profiler.writeJson(path, error)) {
+                    cout << GREEN << "  ✓ Timing summary written to " << path << "\n" << RESET;
+                } else {
+                    cerr << RED << "  ✗ " << error << "\n" << RESET;
+                }
+                break;
+            }
+            case 4:
+                profiler.reset();
+                cout << GREEN << "  ✓ Totals reset.\n" << RESET;
+                break;
+            case 5: {
+                if (tracer.enabled()) {
+                    finishTracing();
+                    break;
+                }
+                cout << "  " << YELLOW << "Trace file (blank = " << TRACE_DEFAULT_FILE << "): " << RESET;
+                string path;
+                cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                getline(cin, path);
+                if (path.empty()) path = TRACE_DEFAULT_FILE;
+                startTracing(path);
+                cout << GREEN << "  ✓ Recording trace events; stop here or exit to write " << path << "\n" << RESET;
+                break;
+            }
+            case 6:
+                showMemoryReport();
+                break;
+            case 7:
+                return;
+            default:
+                cout << RED << "\n  ✗ Invalid option.\n" << RESET;
+                break;
+        }
     }
-    cout << "\n";
 }
 
 // ═══════════════════════════════════════════════════════════════════════════
-// IMPLEMENTATION: SEARCH AND EXPORT
+// IMPLEMENTATION: BENCHMARK
 // ═══════════════════════════════════════════════════════════════════════════
 
 /**
- * Search logs and optionally export results
- * Combines search functionality with immediate export option
- * Displays preview of first 10 results before export confirmation
+ * Stream buffer that discards everything (silences views while they are timed)
  */
-void searchAndExport() {
-    if(logsEmpty()) return;
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return traits_type::not_eof(c); }
+    std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+};
 
-    // Get search keyword
-    string keyword;
-    cout << "\n  " << YELLOW << "Enter search keyword: " << RESET;
-    cin.ignore(numeric_limits<streamsize>::max(), '\n');
-    getline(cin, keyword);
+/**
+ * Timings of one benchmark case
+ */
+struct BenchCase {
+    string name;
+    vector<double> milliseconds;    // One per measured repetition
+    double work = 0;                // Units processed per repetition
+    bool bytes = false;             // work is bytes (MB/s) rather than entries
+};
 
-    // Validate input
-    if(keyword.empty()) {
-        cerr << RED << "  ✗ No search keyword provided.\n" << RESET;
-        return;
+/**
+ * Run a case warmup + runs times and keep the measured durations
+ * 
+ * @param name   Case name
+ * @param warmup Unmeasured repetitions
+ * @param runs   Measured repetitions
+ * @param body   Callable doing one repetition; sets work and bytes on the case
+ * @return       The timed case
+ */
+template <typename Body>
+static BenchCase timeBenchCase(const string& name, unsigned warmup, unsigned runs, Body&& body) {
+    BenchCase result;
+    result.name = name;
+    for (unsigned i = 0; i < warmup + runs; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        body(result);
+        double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (i >= warmup) result.milliseconds.push_back(elapsed);
     }
+    return result;
+}
 
-    // Add to search history
-    searchHistory.push_back(keyword);
-
-    // Collect all matching results
-    vector<LogEntry> results;
-    for(const auto& entry : logs) {
-        if(caseInsensitiveSearch(entry.message, keyword) || 
-           caseInsensitiveSearch(entry.level, keyword)) {
-            results.push_back(entry);
-        }
-    }
+/**
+ * Nearest-rank percentile of sorted values
+ */
+static double percentile(const vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * sorted.size()));
+    return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+}
 
-    // Check if any matches found
-    if(results.empty()) {
-        cout << RED << "\n  ✗ No matching logs found.\n" << RESET;
-        return;
+/**
+ * Benchmark the analyzer on a log file and print a percentile table
+ * 
+ * Cases: load (read + parse + index), parse alone (first lines held in
+ * memory), keyword and regex search, a time-range query over the middle
+ * of the time span, statistics and export. Views are timed with their
+ * console output discarded; the export goes to a temporary file.
+ * 
+ * @param path   Log file
+ * @param warmup Unmeasured repetitions per case
+ * @param runs   Measured repetitions per case
+ * @return       false if the file could not be loaded
+ */
+bool runBenchmark(const string& path, unsigned warmup, unsigned runs) {
+    std::error_code sizeError;
+    double fileBytes = static_cast<double>(std::filesystem::file_size(path, sizeError));
+    if (sizeError) {
+        cerr << RED << "  ✗ Could not open file: " << path << "\n" << RESET;
+        return false;
     }
 
-    // Display search results header
     cout << "\n  " << BRIGHT_CYAN << "════════════════════════════════════════════════════════════" << RESET << "\n";
-    cout << "  " << BRIGHT_CYAN << "SEARCH RESULTS FOR: \"" << keyword << "\"" << RESET << "\n";
+    cout << "  " << BRIGHT_CYAN << "BENCHMARK: " << path << RESET << "\n";
     cout << "  " << BRIGHT_CYAN << "════════════════════════════════════════════════════════════" << RESET << "\n\n";
-
-    // Show preview (first 10 results)
-    int displayCount = std::min(10, (int)results.size());
-    for(int i = 0; i < displayCount; ++i) {
-        const auto& entry = results[i];
-        string levelColor = getLevelColor(entry.level);
-        cout << "  " << CYAN << entry.timestamp << RESET 
-             << " [" << levelColor << entry.level << RESET << "] " 
-             << entry.message << "\n";
+    cout << "  " << CYAN << formatBytes(static_cast<size_t>(fileBytes)) << ", " << warmup << " warmup + "
+         << runs << " measured runs per case" << RESET << "\n" << flush;
+
+    NullBuffer sink;
+    std::streambuf* console = cout.rdbuf(&sink);
+    vector<BenchCase> cases;
+
+    bool loaded = true;
+    cases.push_back(timeBenchCase("load", warmup, runs, [&](BenchCase& c) {
+        loaded = loadLogPath(path) && loaded;
+        c.work = fileBytes;
+        c.bytes = true;
+    }));
+    if (!loaded || logs.empty()) {
+        cout.rdbuf(console);
+        cerr << RED << "  ✗ No log entries could be loaded from " << path << "\n" << RESET;
+        return false;
     }
-
-    // Show count of additional results
-    if(results.size() > 10) {
-        cout << "  " << YELLOW << "... and " << (results.size() - 10) 
-             << " more matches\n" << RESET;
+    const double entryCount = static_cast<double>(logs.size());
+
+    // Parse alone, over lines already in memory
+    vector<string> lines;
+    double lineBytes = 0;
+    {
+        ifstream file(path, std::ios::binary);
+        string line;
+        while (lines.size() < BENCH_PARSE_LINES && getline(file, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            lineBytes += line.size() + 1;
+            lines.push_back(std::move(line));
+        }
+    }
+    size_t parsedLines = 0;
+    cases.push_back(timeBenchCase("parse", warmup, runs, [&](BenchCase& c) {
+        LogEntry entry;
+        parsedLines = 0;
+        for (const string& line : lines) parsedLines += parseLogLine(line, entry) ? 1 : 0;
+        c.work = lineBytes;
+        c.bytes = true;
+    }));
+
+    // Full scans (runBackgroundSearch bypasses the result cache)
+    const std::pair<const char*, const char*> searches[] = {
+        {"search", BENCH_SEARCH_KEYWORD}, {"search (regex)", BENCH_SEARCH_REGEX}
+    };
+    for (const auto& [name, text] : searches) {
+        SearchQuery query;
+        string error;
+        if (!compileSearchQuery(text, query, error)) continue;
+        cases.push_back(timeBenchCase(name, warmup, runs, [&](BenchCase& c) {
+            runBackgroundSearch(query, 0);
+            c.work = entryCount;
+        }));
     }
 
-    // Prompt for export
-    cout << "\n  " << GREEN << "✓ Found " << results.size() << " matches.\n" << RESET;
-    cout << "  Do you want to export these results? (y/n): ";
+    // Time range over the middle of the span (scanFilterQuery bypasses the result cache);
+    // its work is the entries left after block skipping. Skipped without valid timestamps.
+    int64_t minEpoch = INT64_MAX, maxEpoch = INT64_MIN;
+    for (const LogBlockIndex& block : blockIndex) {
+        minEpoch = std::min(minEpoch, block.minEpoch);
+        maxEpoch = std::max(maxEpoch, block.maxEpoch);
+    }
+    FilterQuery range;
+    string rangeError;
+    bool hasRange = minEpoch <= maxEpoch;
+    if (hasRange) {
+        int64_t middle = minEpoch + (maxEpoch - minEpoch) / 2;
+        int64_t halfWidth = static_cast<int64_t>((maxEpoch - minEpoch) * BENCH_RANGE_SHARE / 2);
+        hasRange = range.compile("ts between \"" + formatEpoch(middle - halfWidth, TIMESTAMP_ISO) + "\" and \""
+                                 + formatEpoch(middle + halfWidth, TIMESTAMP_ISO) + "\"", rangeError);
+    }
+    if (hasRange) {
+        cases.push_back(timeBenchCase("range query", warmup, runs, [&](BenchCase& c) {
+            size_t skippedBlocks = 0, candidateCount = 0, evaluated = 0;
+            scanFilterQuery(range, skippedBlocks, candidateCount, evaluated);
+            c.work = static_cast<double>(evaluated);
+        }));
+    }
 
-    char choice;
-    cin >> choice;
+    cases.push_back(timeBenchCase("statistics", warmup, runs, [&](BenchCase& c) {
+        showEntryStatistics(logs, "LOG STATISTICS");
+        c.work = entryCount;
+    }));
+
+    string exportPath = (std::filesystem::temp_directory_path(sizeError) / "log_analyzer_bench.txt").string();
+    bool exported = true;
+    cases.push_back(timeBenchCase("export", warmup, runs, [&](BenchCase& c) {
+        exported = writeExportFile(logs, "Benchmark", exportPath) && exported;
+        c.work = static_cast<double>(std::filesystem::file_size(exportPath, sizeError));
+        c.bytes = true;
+    }));
+    std::filesystem::remove(exportPath, sizeError);
+    cout.rdbuf(console);
+
+    cout << "  " << CYAN << logs.size() << " entries; the parse case uses the first " << lines.size()
+         << " lines (" << parsedLines << " valid)" << RESET << "\n";
+    if (!hasRange) cout << "  " << YELLOW << "⚠ No valid timestamps: range query skipped" << RESET << "\n";
+    cout << "\n";
 
-    if(choice == 'y' || choice == 'Y') {
-        ostringstream desc;
-        desc << "Search results for: \"" << keyword << "\"";
-        exportLogs(results, desc.str());
-    } else {
-        cout << YELLOW << "  Export cancelled.\n" << RESET;
+    // Nearest-rank percentiles equal the maximum until there are enough runs
+    auto percentileCell = [](const vector<double>& sorted, double p) {
+        ostringstream cell;
+        if (sorted.size() * (100.0 - p) < 100.0) cell << "-";
+        else cell << fixed << setprecision(2) << percentile(sorted, p);
+        return cell.str();
+    };
+    cout << "  " << CYAN << std::left << std::setw(16) << "Case" << std::right << std::setw(12) << "Work"
+         << std::setw(10) << "Min ms" << std::setw(10) << "p50 ms" << std::setw(10) << "p90 ms"
+         << std::setw(10) << "p99 ms" << std::setw(10) << "Max ms" << std::setw(16) << "p50 rate" << RESET << "\n";
+    for (BenchCase& c : cases) {
+        std::sort(c.milliseconds.begin(), c.milliseconds.end());
+        double median = percentile(c.milliseconds, 50);
+        ostringstream work, rate;
+        work << fixed << setprecision(1);
+        rate << fixed << setprecision(1);
+        if (c.bytes) {
+            work << c.work / (1024.0 * 1024.0) << " MB";
+            rate << (median > 0 ? c.work / (1024.0 * 1024.0) / (median / 1000.0) : 0.0) << " MB/s";
+        } else {
+            if (c.work < 1e6) work << c.work / 1e3 << " K";
+            else work << c.work / 1e6 << " M";
+            rate << (median > 0 ? c.work / 1e6 / (median / 1000.0) : 0.0) << " M/s";
+        }
+        cout << "  " << std::left << std::setw(16) << c.name << std::right << std::setw(12) << work.str()
+             << fixed << setprecision(2) << std::setw(10) << c.milliseconds.front() << std::setw(10) << median
+             << std::setw(10) << percentileCell(c.milliseconds, 90) << std::setw(10) << percentileCell(c.milliseconds, 99)
+             << std::setw(10) << c.milliseconds.back() << std::setw(16) << rate.str() << "\n";
+    }
+    cout << "\n";
+    if (hasRange) cout << "  " << CYAN << "ℹ Range query work is the entries evaluated after block skipping" << RESET << "\n";
+    if (runs < 100) {
+        cout << "  " << CYAN << "ℹ p90 needs 10 and p99 100 measured runs (--bench-runs); shown as - until then"
+             << RESET << "\n";
     }
+    if (!exported) cout << YELLOW << "\n  ⚠ Could not write the export file " << exportPath << "\n" << RESET;
+    cout << "\n";
+    return true;
 }
 
 // ═══════════════════════════════════════════════════════════════════════════
-// IMPLEMENTATION: STATISTICS DISPLAY
+// IMPLEMENTATION: QUERY SERVER
 // ═══════════════════════════════════════════════════════════════════════════
 
 /**
- * Display comprehensive log statistics with visual bar charts
+ * Answer one request line from a client
  * 
- * Features:
- * - Total entry count
- * - Bar charts for each log level (max 50 chars wide)
- * - Percentage calculations
- * - Time range information (first and last entry timestamps)
- * - Support for custom/unknown log levels
+ * A request is a filter query (same language as Query Logs), optionally
+ * prefixed with "count " to return only the number of matches. The
+ * response is up to SERVER_MAX_ROWS log lines followed by
+ * "END <matches> <returned> <ms> <hit|miss>", or a single "ERR <message>".
+ * The loaded logs are never modified while serving, so queries read them
+ * without locks; only the result cache is shared.
+ * 
+ * @param request Request line (trimmed)
+ * @return        Complete response text
  */
-void showStatistics() {
-    if (logsEmpty()) return;
+string answerServerQuery(const string& request) {
+    auto startTime = std::chrono::steady_clock::now();
+
+    bool countOnly = toLowerStr(request.substr(0, 6)) == "count ";
+    string text = countOnly ? request.substr(6) : request;
+
+    FilterQuery query;
+    string error;
+    if (!query.compile(text, error)) return "ERR " + error + "\n";
+    string key = query.cacheKey();
+
+    // Matches from the shared result cache, or the level bitmaps and surviving blocks;
+    // counts are the bitmap cardinality, only returned rows are visited
+    size_t covered = 0;
+    std::shared_ptr<const EntryBitmap> matches = resultCache.find(key, covered);
+    bool hit = matches != nullptr;
+    if (!hit) {
+        size_t skippedBlocks = 0, candidateCount = 0, evaluated = 0;
+        matches = std::make_shared<const EntryBitmap>(
+            scanFilterQuery(query, skippedBlocks, candidateCount, evaluated));
+        resultCache.store(key, matches, logs.size());
+    }
 
-    // Count occurrences of each log level
-    unordered_map<string, int> countMap;
-    int maxCount = 0;
+    ostringstream response;
+    size_t rows = countOnly ? 0 : std::min(matches->size(), SERVER_MAX_ROWS);
+    if (rows > 0) {
+        size_t written = 0;
+        matches->forEach([&](uint32_t index) {
+            if (written == rows) return;
+            const LogEntry& entry = logs[index];
+            response << entryTimestamp(entry) << " [" << entryLevel(entry) << "] " << entryMessage(entry) << "\n";
+            written++;
+        });
+    }
+    double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    response << "END " << matches->size() << " " << rows << " " << fixed << setprecision(2) << elapsedMs
+             << (hit ? " hit\n" : " miss\n");
+    return response.str();
+}
+
+/**
+ * Serve the loaded logs to local clients over a Unix domain socket
+ * 
+ * A single event loop polls the listening socket and every client
+ * (non-blocking), splits input into request lines and hands each one to a
+ * pool of query workers, one request in flight per client so responses keep
+ * their order. Workers append the response to the client's outbox and the
+ * loop sends it when the socket is writable. A client whose outbox or inbox
+ * holds SERVER_MAX_BUFFERED bytes gets no new queries, or is not read from,
+ * until it catches up. Any key stops the server.
+ * 
+ * @param socketPath Path of the socket file
+ * @return           false if the socket could not be set up
+ */
+bool runQueryServer(const string& socketPath) {
+    namespace fs = std::filesystem;
 
-    for(const auto& entry : logs) {
-        countMap[entry.level]++;
-        maxCount = std::max(maxCount, countMap[entry.level]);
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        cerr << RED << "  ✗ Could not initialize sockets.\n" << RESET;
+        return false;
     }
 
-    // Display header
-    cout << "\n  " << BRIGHT_CYAN << "════════════════════════════════════════════════════════════" << RESET << "\n";
-    cout << "  " << BRIGHT_CYAN << "LOG STATISTICS" << RESET << "\n";
-    cout << "  " << BRIGHT_CYAN << "════════════════════════════════════════════════════════════" << RESET << "\n\n";
-    cout << "  " << BRIGHT_CYAN << "Total Entries: " << logs.size() << RESET << "\n\n";
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        cerr << RED << "  ✗ Socket path too long: " << socketPath << "\n" << RESET;
+        WSACleanup();
+        return false;
+    }
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+    std::error_code ignored;
+    fs::remove(socketPath, ignored);  // Stale socket file from an earlier run
+
+    SOCKET listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    u_long nonBlocking = 1;
+    if (listener == INVALID_SOCKET ||
+        bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == SOCKET_ERROR ||
+        listen(listener, SOMAXCONN) == SOCKET_ERROR ||
+        ioctlsocket(listener, FIONBIO, &nonBlocking) == SOCKET_ERROR) {
+        cerr << RED << "  ✗ Could not listen on " << socketPath << "\n" << RESET;
+        if (listener != INVALID_SOCKET) closesocket(listener);
+        WSACleanup();
+        return false;
+    }
 
-    // Standard log levels to display first
-    vector<string> levels = {"INFO", "WARN", "ERROR"};
+    // Query workers
+    std::mutex jobLock;
+    std::condition_variable jobReady;
+    std::queue<std::pair<std::shared_ptr<ServerClient>, string>> jobs;
+    bool stopping = false;
+
+    auto worker = [&]() {
+        while (true) {
+            std::pair<std::shared_ptr<ServerClient>, string> job;
+            {
+                std::unique_lock<std::mutex> guard(jobLock);
+                jobReady.wait(guard, [&]() { return stopping || !jobs.empty(); });
+                if (jobs.empty()) return;
+                job = std::move(jobs.front());
+                jobs.pop();
+            }
+            string response = answerServerQuery(job.second);
+            std::lock_guard<std::mutex> guard(job.first->lock);
+            job.first->outbox += response;
+            job.first->busy = false;
+        }
+    };
+    unsigned workerCount = std::max(1u, std::thread::hardware_concurrency());
+    vector<std::thread> workers;
+    for (unsigned i = 0; i < workerCount; ++i) workers.emplace_back(worker);
+
+    cout << GREEN << "  ✓ Serving " << logs.size() << " entries on " << socketPath
+         << " with " << workerCount << " query workers (press any key to stop)\n" << RESET;
+
+    vector<std::shared_ptr<ServerClient>> clients;
+    vector<WSAPOLLFD> polled;
+    size_t served = 0;
+    char buffer[SERVER_RECV_BUFFER];
 
-    // Display statistics for standard levels
-    for(const auto& level : levels) {
-        if(countMap.find(level) == countMap.end()) continue;
-        
-        int count = countMap[level];
-        string levelColor = getLevelColor(level);
-        double percentage = logs.empty() ? 0.0 : (count * 100.0 / logs.size());
+    while (true) {
+        if (_kbhit()) {
+            _getch();
+            break;
+        }
 
-        // Create visual bar chart (proportional to count, max 50 chars)
-        int barLength = maxCount > 0 ? (count * 50) / maxCount : 0;
-        string bar;
-        for(int i = 0; i < barLength; ++i) bar += "█";
+        polled.assign(1, WSAPOLLFD{});
+        polled[0].fd = listener;
+        polled[0].events = POLLIN;
+        for (const auto& client : clients) {
+            WSAPOLLFD entry{};
+            entry.fd = client->socket;
+            if (client->inbox.size() < SERVER_MAX_BUFFERED) entry.events = POLLIN;  // Else the client's sends block
+            std::lock_guard<std::mutex> guard(client->lock);
+            if (!client->outbox.empty()) entry.events |= POLLOUT;
+            polled.push_back(entry);
+        }
+        if (WSAPoll(polled.data(), static_cast<unsigned long>(polled.size()), SERVER_POLL_INTERVAL_MS) == SOCKET_ERROR) {
+            cerr << RED << "  ✗ Poll failed; stopping server.\n" << RESET;
+            break;
+        }
 
-        cout << "  " << levelColor << std::left << std::setw(8) << level << RESET 
-             << " " << levelColor << bar << RESET 
-             << " " << count << " (" << fixed << setprecision(1) << percentage << "%)\n";
-    }
+        // New connections
+        if (polled[0].revents & POLLIN) {
+            SOCKET accepted;
+            while ((accepted = accept(listener, nullptr, nullptr)) != INVALID_SOCKET) {
+                ioctlsocket(accepted, FIONBIO, &nonBlocking);
+                auto client = std::make_shared<ServerClient>();
+                client->socket = accepted;
+                clients.push_back(std::move(client));
+            }
+        }
 
-    // Display any custom/unknown log levels
-    for(const auto& pair : countMap) {
-        if (std::find(levels.begin(), levels.end(), pair.first) == levels.end()) {
-            double percentage = logs.empty() ? 0.0 : (pair.second * 100.0 / logs.size());
-            int barLength = maxCount > 0 ? (pair.second * 50) / maxCount : 0;
-            string bar;
-            for(int i = 0; i < barLength; ++i) bar += "█";
+        // Reads and writes (new clients are polled from the next round on)
+        for (size_t c = 0; c + 1 < polled.size(); ++c) {
+            ServerClient& client = *clients[c];
+            short events = polled[c + 1].revents;
+
+            if (events & (POLLIN | POLLHUP | POLLERR)) {
+                int received = recv(client.socket, buffer, sizeof(buffer), 0);
+                if (received > 0) client.inbox.append(buffer, received);
+                else if (received == 0 || WSAGetLastError() != WSAEWOULDBLOCK) client.closing = true;
+
+                // A request line that never ends cannot be dispatched; drop the client
+                if (client.inbox.size() >= SERVER_MAX_BUFFERED && client.inbox.find('\n') == string::npos) {
+                    client.closing = true;
+                }
+            }
+            if (events & POLLOUT) {
+                std::lock_guard<std::mutex> guard(client.lock);
+                int sent = send(client.socket, client.outbox.data(), static_cast<int>(client.outbox.size()), 0);
+                if (sent > 0) client.outbox.erase(0, sent);
+                else if (WSAGetLastError() != WSAEWOULDBLOCK) client.closing = true;
+            }
+        }
 
-            cout << "  " << CYAN << std::left << std::setw(8) << pair.first << RESET 
-                 << " " << CYAN << bar << RESET 
-                 << " " << pair.second << " (" << fixed << setprecision(1) << percentage << "%)\n";
-        } 
+        // Dispatch the next complete request of every idle client that reads its responses
+        for (const auto& client : clients) {
+            if (client->closing) continue;
+            std::lock_guard<std::mutex> guard(client->lock);
+            while (!client->busy && client->outbox.size() < SERVER_MAX_BUFFERED) {
+                size_t newline = client->inbox.find('\n');
+                if (newline == string::npos) break;
+                string request = client->inbox.substr(0, newline);
+                client->inbox.erase(0, newline + 1);
+                while (!request.empty() && std::isspace(static_cast<unsigned char>(request.back()))) request.pop_back();
+                size_t first = request.find_first_not_of(" \t");
+                if (first == string::npos) continue;
+
+                client->busy = true;
+                served++;
+                std::lock_guard<std::mutex> jobGuard(jobLock);
+                jobs.emplace(client, request.substr(first));
+                jobReady.notify_one();
+            }
+        }
+
+        // Drop clients that hung up once their last query has finished
+        clients.erase(std::remove_if(clients.begin(), clients.end(), [](const std::shared_ptr<ServerClient>& client) {
+            std::lock_guard<std::mutex> guard(client->lock);
+            if (!client->closing || client->busy) return false;
+            closesocket(client->socket);
+            return true;
+        }), clients.end());
     }
 
-    // Display time range information
-    if (!logs.empty()) {
-        cout << "\n  " << BRIGHT_CYAN << "─────────────────────────────────────────────────────────────" << RESET << "\n";
-        cout << "  " << CYAN << "First Entry: " << RESET << logs.front().timestamp << "\n";
-        cout << "  " << CYAN << "Last Entry:  " << RESET << logs.back().timestamp << "\n";
+    {
+        std::lock_guard<std::mutex> guard(jobLock);
+        stopping = true;
     }
-    
-    cout << "\n";
+    jobReady.notify_all();
+    for (auto& t : workers) t.join();
+    for (const auto& client : clients) closesocket(client->socket);
+    closesocket(listener);
+    fs::remove(socketPath, ignored);
+    WSACleanup();
+
+    cout << GREEN << "  ✓ Server stopped after " << served << " queries.\n" << RESET;
+    return true;
 }
 
-// ═══════════════════════════════════════════════════════════════════════════
-// IMPLEMENTATION: VIEW SEARCH HISTORY
-// ═══════════════════════════════════════════════════════════════════════════
-
 /**
- * Display all previous search queries
- * Shows numbered list of all searches performed in current session
+ * Interactive thin client for a running query server
+ * Sends each typed query and prints the streamed response
+ * 
+ * @param socketPath Path of the server's socket file
+ * @return           false if the server could not be reached
  */
-void viewSearchHistory() {
-    if (searchHistory.empty()) {
-        cout << YELLOW << "\n  ⚠ No search history available.\n" << RESET;
-        return;
+bool runQueryClient(const string& socketPath) {
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        cerr << RED << "  ✗ Could not initialize sockets.\n" << RESET;
+        return false;
     }
 
-    cout << "\n  " << BRIGHT_CYAN << "════════════════════════════════════════════════════════════" << RESET << "\n";
-    cout << "  " << BRIGHT_CYAN << "SEARCH HISTORY" << RESET << "\n";
-    cout << "  " << BRIGHT_CYAN << "════════════════════════════════════════════════════════════" << RESET << "\n\n";
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        cerr << RED << "  ✗ Socket path too long: " << socketPath << "\n" << RESET;
+        WSACleanup();
+        return false;
+    }
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+    SOCKET server = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server == INVALID_SOCKET ||
+        connect(server, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == SOCKET_ERROR) {
+        cerr << RED << "  ✗ No query server at " << socketPath << " (start one with --serve FILE)\n" << RESET;
+        if (server != INVALID_SOCKET) closesocket(server);
+        WSACleanup();
+        return false;
+    }
 
-    // Display each search with index number
-    for (size_t i = 0; i < searchHistory.size(); ++i) {
-        cout << "  " << CYAN << (i + 1) << ". " << RESET << searchHistory[i] << "\n";
+    cout << GREEN << "  ✓ Connected to " << socketPath << "\n" << RESET;
+    cout << CYAN << "  ℹ Enter filter queries (prefix with \"count \" for counts only); blank line quits.\n" << RESET;
+
+    string pending;
+    char buffer[SERVER_RECV_BUFFER];
+    while (true) {
+        string request;
+        cout << "\n  " << BRIGHT_CYAN << "query> " << RESET;
+        if (!getline(cin, request) || request.empty()) break;
+        bool countOnly = toLowerStr(request.substr(0, 6)) == "count ";
+
+        request += "\n";
+        size_t offset = 0;
+        while (offset < request.size()) {
+            int sent = send(server, request.data() + offset, static_cast<int>(request.size() - offset), 0);
+            if (sent <= 0) break;
+            offset += sent;
+        }
+        if (offset < request.size()) {
+            cerr << RED << "  ✗ Connection lost.\n" << RESET;
+            break;
+        }
+
+        // Print response lines until END or ERR
+        bool done = false, lost = false;
+        while (!done) {
+            size_t newline;
+            while (!done && (newline = pending.find('\n')) != string::npos) {
+                string line = pending.substr(0, newline);
+                pending.erase(0, newline + 1);
+                if (line.rfind("END ", 0) == 0) {
+                    std::istringstream fields(line.substr(4));
+                    size_t matches = 0, rows = 0;
+                    double elapsedMs = 0.0;
+                    string cache;
+                    fields >> matches >> rows >> elapsedMs >> cache;
+                    cout << "  " << GREEN << "✓ " << matches << " matches";
+                    if (!countOnly && rows < matches) cout << " (showing " << rows << ")";
+                    cout << " in " << fixed << setprecision(2) << elapsedMs << " ms"
+                         << (cache == "hit" ? " [cached]" : "") << "\n" << RESET;
+                    done = true;
+                } else if (line.rfind("ERR ", 0) == 0) {
+                    cerr << RED << "  ✗ " << line.substr(4) << "\n" << RESET;
+                    done = true;
+                } else {
+                    // Colorize like local views when the line parses
+                    LogEntry entry;
+                    if (parseLogLine(line, entry, false)) {
+                        cout << "  " << CYAN << entryTimestamp(entry) << RESET << " ["
+                             << getLevelColor(entryLevel(entry)) << entryLevel(entry) << RESET << "] "
+                             << string_view(line).substr(entry.offset, entry.length) << "\n";
+                    } else {
+                        cout << "  " << line << "\n";
+                    }
+                }
+            }
+            if (done) break;
+            int received = recv(server, buffer, sizeof(buffer), 0);
+            if (received <= 0) {
+                lost = true;
+                break;
+            }
+            pending.append(buffer, received);
+        }
+        if (lost) {
+            cerr << RED << "  ✗ Connection lost.\n" << RESET;
+            break;
+        }
     }
-    cout << "\n";
+
+    closesocket(server);
+    WSACleanup();
+    return true;
 }
 
 // ═══════════════════════════════════════════════════════════════════════════
-// IMPLEMENTATION: EXPORT LOGS TO FILE
+// IMPLEMENTATION: ANOMALY DETECTION
 // ═══════════════════════════════════════════════════════════════════════════
 
 /**
- * Export log entries to a timestamped text file
- * 
- * Features:
- * - Automatically adds timestamp to filename (YYYYMMDD_HHMMSS format)
- * - Includes comprehensive header with metadata
- * - Shows export description and entry count
- * - Creates file in current working directory
+ * Exponentially weighted update of mean and variance
  * 
- * @param entries     Vector of log entries to export
- * @param description Description of the filter/search used
+ * @param value Observation
+ * @param alpha Weight of the new observation
  */
-void exportLogs(const vector<LogEntry> & entries, const string& description) {
-    if(entries.empty()) {
-        cout << RED << "\n  ✗ No logs to export.\n" << RESET;
-        return;
+void AnomalyDetector::Baseline::update(double value, double alpha) {
+    if (samples == 0) {
+        mean = value;
+        variance = 0.0;
+    } else {
+        double delta = value - mean;
+        mean += alpha * delta;
+        variance = (1.0 - alpha) * (variance + alpha * delta * delta);
     }
+    samples++;
+}
 
-    // Get filename from user
-    string filename;
-    cout << "\n  " << GREEN << "Enter export filename (without extension): " << RESET;
-    cin.ignore(numeric_limits<streamsize>::max(), '\n');
-    getline(cin, filename);
+void AnomalyDetector::reset() {
+    levels.clear();
+    lastLevelId = MessagePool::INVALID_ID;
+    lastLevel = 0;
+    windowTemplates.clear();
+    templateModels.clear();
+    incidents.clear();
+    window = INT64_MIN;
+    windowsClosed = 0;
+}
 
-    // Validate filename
-    if(filename.empty()) {
-        cerr << RED << "  ✗ No filename provided.\n" << RESET;
-        return;
+/**
+ * Count one entry into the open window, closing windows as time advances
+ * Entries that arrive out of order are counted in the open window
+ * 
+ * @param entry Parsed log entry
+ */
+void AnomalyDetector::observe(const LogEntry& entry) {
+    if (entry.epoch == INVALID_EPOCH) return;
+
+    int64_t entryWindow = entry.epoch / ANOMALY_WINDOW_SECONDS;
+    if (window == INT64_MIN) window = entryWindow;
+
+    // Close the open window and any empty windows in between (bounded)
+    if (entryWindow > window) {
+        int64_t gap = std::min<int64_t>(entryWindow - window, ANOMALY_MAX_GAP_WINDOWS);
+        for (int64_t k = 0; k < gap; ++k) {
+            closeWindow();
+            window++;
+        }
+        window = entryWindow;
     }
 
-    // Generate timestamped filename to avoid overwriting
-    auto now = std::chrono::system_clock::now();
-    auto time_t_now = std::chrono::system_clock::to_time_t(now);
-    ostringstream oss;
-    oss << filename << "_" 
-        << std::put_time(std::localtime(&time_t_now), "%Y%m%d_%H%M%S") 
-        << ".txt";
-    string fullFilename = oss.str();
-
-    // Create output file
-    std::ofstream outFile(fullFilename);
-    if (!outFile.is_open()) {
-        cerr << RED << "  ✗ Could not create export file.\n" << RESET;
-        return;
+    // Level slot (the last one is cached; there are only a handful)
+    if (entry.levelId != lastLevelId) {
+        lastLevel = levels.size();
+        for (size_t l = 0; l < levels.size(); ++l) {
+            if (levels[l].levelId == entry.levelId) lastLevel = l;
+        }
+        if (lastLevel == levels.size()) {
+            LevelModel model;
+            model.levelId = entry.levelId;
+            model.errorClass = isErrorLevel(entryLevel(entry));
+            levels.push_back(std::move(model));
+        }
+        lastLevelId = entry.levelId;
     }
+    LevelModel& level = levels[lastLevel];
+    level.count++;
+    if (level.errorClass) {
+        TemplateCount& slot = windowTemplates[templateIndex.keyOf(entry)];
+        if (slot.count++ == 0) slot.sample = entry;
+    }
+}
 
-    // Write file header
-    outFile << "========================================\n";
-    outFile << "LOG ANALYZER EXPORT\n";
-    outFile << description << "\n";
-    outFile << "Exported: " 
-            << std::put_time(std::localtime(&time_t_now), "%Y-%m-%d %H:%M:%S") 
-            << "\n";
-    outFile << "Total Entries: " << entries.size() << "\n";
-    outFile << "========================================\n\n";
+/**
+ * Score the open window against the baselines, record an incident if it
+ * spikes, then fold the window into the baselines
+ */
+void AnomalyDetector::closeWindow() {
+    const int64_t windowStart = window * ANOMALY_WINDOW_SECONDS;
+    const int64_t wallClock = windowStart + logUtcOffset;  // Hour-of-day seasonality follows the log's clock
+    const int64_t day = (wallClock >= 0 ? wallClock : wallClock - 86399) / 86400;
+    const int hour = static_cast<int>((wallClock - day * 86400) / 3600);
+
+    for (LevelModel& level : levels) {
+        Baseline& seasonal = level.hourly[hour];
+        const Baseline& baseline = seasonal.days >= 2 ? seasonal : level.overall;
+        double count = static_cast<double>(level.count);
+        double learned = count;
+
+        if (level.errorClass && level.overall.samples >= ANOMALY_WARMUP_WINDOWS && level.count >= ANOMALY_MIN_COUNT) {
+            double deviation = std::sqrt(std::max(baseline.variance, std::max(baseline.mean, 1.0)));
+            double z = (count - baseline.mean) / deviation;
+            if (z >= ANOMALY_Z_THRESHOLD) {
+                // Learn a clamped value so a burst does not hide its own next window
+                learned = baseline.mean + ANOMALY_Z_THRESHOLD * deviation;
+
+                // Extend this level's incident if it ended at the previous window, even
+                // when another level opened an incident in between
+                bool extend = level.openIncident != SIZE_MAX &&
+                              incidents[level.openIncident].end + 1 == windowStart;
+                if (!extend) {
+                    level.openIncident = incidents.size();
+                    incidents.emplace_back();
+                    incidents.back().start = windowStart;
+                    incidents.back().levelId = level.levelId;
+                }
+                AnomalyWindow& incident = incidents[level.openIncident];
+                incident.end = windowStart + ANOMALY_WINDOW_SECONDS - 1;
+                incident.count += level.count;
+                incident.expected += baseline.mean;
+                incident.maxZ = std::max(incident.maxZ, z);
+
+                // Templates that exceeded their own baseline the most
+                for (const auto& [key, templateCount] : windowTemplates) {
+                    double expected = 0.0;
+                    auto model = templateModels.find(key);
+                    if (model != templateModels.end()) {
+                        expected = model->second.ewma * std::pow(1.0 - ANOMALY_EWMA_ALPHA,
+                                                                 static_cast<double>(window - model->second.lastWindow));
+                    }
+                    double excess = templateCount.count - expected;
+                    string text = messageTemplate(entryMessage(templateCount.sample));
+                    auto found = std::find_if(incident.topTemplates.begin(), incident.topTemplates.end(),
+                                              [&text](const auto& item) { return item.first == text; });
+                    if (found != incident.topTemplates.end()) found->second += excess;
+                    else incident.topTemplates.emplace_back(std::move(text), excess);
+                }
+                std::sort(incident.topTemplates.begin(), incident.topTemplates.end(),
+                          [](const auto& a, const auto& b) { return a.second > b.second; });
+                if (incident.topTemplates.size() > ANOMALY_TOP_TEMPLATES) {
+                    incident.topTemplates.resize(ANOMALY_TOP_TEMPLATES);
+                }
+            }
+        }
 
-    // Calculate statistics for export
-    unordered_map<string, int> levelCount;
-    for(const auto& entry : entries) {
-        levelCount[entry.level]++;
+        level.overall.update(learned, ANOMALY_EWMA_ALPHA);
+        seasonal.update(learned, ANOMALY_EWMA_ALPHA);
+        if (seasonal.lastDay != day) {
+            seasonal.lastDay = day;
+            seasonal.days++;
+        }
+        level.count = 0;
     }
 
-    // Write statistics section
-    outFile << "\n--- Statistics ---\n";
-    for (const auto& pair : levelCount) {
-        double percentage = (pair.second * 100.0) / entries.size();
-        outFile << pair.first << ": " << pair.second 
-                << " (" << fixed << setprecision(1) << percentage << "%)\n";
+    // Fold this window's error templates into their lazily decayed EWMAs
+    for (const auto& [key, templateCount] : windowTemplates) {
+        TemplateModel& model = templateModels[key];
+        model.ewma *= std::pow(1.0 - ANOMALY_EWMA_ALPHA, static_cast<double>(window - model.lastWindow - 1));
+        model.ewma += ANOMALY_EWMA_ALPHA * (templateCount.count - model.ewma);
+        model.lastWindow = window;
     }
+    windowTemplates.clear();
+    windowsClosed++;
+}
 
-    // Write time range if entries exist
-    if(!entries.empty()) {
-        outFile << "\nTime Range:\n";
-        outFile << "  First: " << entries.front().timestamp << "\n";
-        outFile << "  Last:  " << entries.back().timestamp << "\n";
-    }
-    outFile << "========================================\n\n";
+void AnomalyDetector::finish() {
+    if (window != INT64_MIN) closeWindow();
+    window = INT64_MIN;
+}
 
-    // Write all log entries
-    for(const auto& entry : entries) {
-        outFile << entry.timestamp << " [" << entry.level << "] " 
-                << entry.message << "\n";
+/**
+ * Show the incidents found while loading
+ */
+void showAnomalyReport() {
+    if (logsEmpty()) return;
+
+    const vector<AnomalyWindow>& incidents = anomalyDetector.anomalies();
+
+    cout << "\n  " << BRIGHT_CYAN << "════════════════════════════════════════════════════════════" << RESET << "\n";
+    cout << "  " << BRIGHT_CYAN << "ANOMALY REPORT (" << ANOMALY_WINDOW_SECONDS << "s windows, z ≥ "
+         << fixed << setprecision(1) << ANOMALY_Z_THRESHOLD << ")" << RESET << "\n";
+    cout << "  " << BRIGHT_CYAN << "════════════════════════════════════════════════════════════" << RESET << "\n\n";
+
+    if (incidents.empty()) {
+        cout << "  " << GREEN << "✓ No anomalies in " << anomalyDetector.windowCount() << " windows.\n\n" << RESET;
+        return;
     }
 
-    outFile.close();
-    
-    // Confirm successful export
-    cout << GREEN << "  ✓ Exported " << entries.size() 
-         << " entries to " << fullFilename << "\n" << RESET;
+    for (const AnomalyWindow& incident : incidents) {
+        string_view level = messagePool.view(incident.levelId);
+        cout << "  " << CYAN << formatEpoch(incident.start, TIMESTAMP_ISO) << " → "
+             << formatEpoch(incident.end, TIMESTAMP_ISO).substr(11) << RESET << "  "
+             << getLevelColor(level) << level << RESET << " " << incident.count
+             << " (baseline " << fixed << setprecision(1) << incident.expected
+             << ", z=" << incident.maxZ << ")\n";
+        for (const auto& [text, excess] : incident.topTemplates) {
+            if (excess < 0.5) continue;
+            cout << "      " << YELLOW << "+" << setprecision(0) << excess << RESET << "  " << text << "\n";
+        }
+    }
+    cout << "\n  " << BRIGHT_CYAN << incidents.size() << " incident(s) in " 
+         << anomalyDetector.windowCount() << " windows" << RESET << "\n\n";
 }
 
 // ═══════════════════════════════════════════════════════════════════════════
-// IMPLEMENTATION: EXPORT MENU
+// IMPLEMENTATION: ADVANCED TOOLS MENU
 // ═══════════════════════════════════════════════════════════════════════════
 
 /**
- * Display export menu and handle user selection
- * Allows exporting logs filtered by level or all logs
+ * Display advanced tools menu and handle user selection
+ * Groups analysis tools that go beyond the basic view/search/export options
  */
-void exportMenu() {
-    if(logsEmpty()) return;
-
-    // Display export options
-    cout << "\n  " << BRIGHT_CYAN << "EXPORT OPTIONS" << RESET << "\n";
-    cout << "  1. Export All Logs\n";
-    cout << "  2. Export INFO Logs\n";
-    cout << "  3. Export WARN Logs\n";
-    cout << "  4. Export ERROR Logs\n";
-    cout << "  5. Cancel\n";
-    cout << "\n  " << BRIGHT_CYAN << "Select option (1-5): " << RESET;
+void advancedMenu() {
+    // Display advanced options
+    cout << "\n  " << BRIGHT_CYAN << "ADVANCED TOOLS" << RESET << "\n";
+    cout << "  1. Multi-Pattern Search (pattern file)\n";
+    cout << "  2. Query Logs (filter language)\n";
+    cout << "  3. Sort by Time\n";
+    cout << "  4. Archives (columnar .lga)\n";
+    cout << "  5. Anomaly Report\n";
+    cout << "  6. Collapse Repeats [" << collapseModeName(collapseMode) << "]\n";
+    cout << "  7. Compare Two Files (template diff)\n";
+    cout << "  8. Correlate Sources (time join)\n";
+    cout << "  9. Sessions (by id field)\n";
+    cout << "  10. Sample Estimate (huge files)\n";
+    cout << "  11. Instrumentation [" << (profiler.enabled() ? "on" : "off") << "]\n";
+    cout << "  12. Back\n";
+    cout << "\n  " << BRIGHT_CYAN << "Select option (1-12): " << RESET;
 
     int choice;
     cin >> choice;
@@ -954,13 +9607,19 @@ void exportMenu() {
         return;
     }
 
-    // Execute export based on user choice
     switch (choice) {
-        case 1: exportLogs(logs, "Filter: ALL"); break;
-        case 2: exportLogs(getFilteredLogs("INFO"), "Filter: INFO"); break;
-        case 3: exportLogs(getFilteredLogs("WARN"), "Filter: WARN"); break;
-        case 4: exportLogs(getFilteredLogs("ERROR"), "Filter: ERROR"); break;
-        case 5: cout << YELLOW << "  Export cancelled.\n" << RESET; break;
+        case 1: multiPatternSearch(); break;
+        case 2: queryLogs(); break;
+        case 3: sortLogsByTime(); break;
+        case 4: archiveMenu(); break;
+        case 5: showAnomalyReport(); break;
+        case 6: toggleCollapseMode(); break;
+        case 7: compareLogFiles(); break;
+        case 8: correlateSources(); break;
+        case 9: showSessions(); break;
+        case 10: sampleLogFile(); break;
+        case 11: instrumentationMenu(); break;
+        case 12: break;
         default: cout << RED << "\n  ✗ Invalid option.\n" << RESET; break;
     }
 }
@@ -984,29 +9643,216 @@ bool parseTimestamp(const string& timestamp, std::tm& tm_struct) {
 }
 
 /**
- * Check if a timestamp falls within a time range
+ * Days since 1970-01-01 for a proleptic Gregorian date
+ * Pure arithmetic, so results never depend on the local timezone
+ * 
+ * @param year  Full year (e.g. 2026)
+ * @param month Month 1-12
+ * @param day   Day of month 1-31
+ * @return      Day number relative to the Unix epoch
+ */
+static int64_t daysFromCivil(int64_t year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yearOfEra = static_cast<unsigned>(year - era * 400);
+    const unsigned dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + static_cast<int64_t>(dayOfEra) - 719468;
+}
+
+/**
+ * Proleptic Gregorian date for a day number (inverse of daysFromCivil)
+ * 
+ * @param days  Days since 1970-01-01
+ * @param year  Output full year
+ * @param month Output month 1-12
+ * @param day   Output day of month 1-31
+ */
+static void civilFromDays(int64_t days, int64_t& year, unsigned& month, unsigned& day) {
+    days += 719468;
+    const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const unsigned dayOfEra = static_cast<unsigned>(days - era * 146097);
+    const unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    const unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    const unsigned monthIndex = (5 * dayOfYear + 2) / 153;
+    day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+    month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+    year = static_cast<int64_t>(yearOfEra) + era * 400 + (month <= 2);
+}
+
+/**
+ * Print seconds since the epoch in one of the log timestamp formats
+ * (as wall-clock time of the log's --timezone)
+ * 
+ * @param epoch  Seconds since 1970-01-01 00:00:00 UTC
+ * @param format TIMESTAMP_ISO or TIMESTAMP_US
+ * @return       YYYY-MM-DD HH:MM:SS or MM/DD/YYYY HH:MM:SS
+ */
+string formatEpoch(int64_t epoch, TimestampFormat format) {
+    epoch += logUtcOffset;  // Back to the log's wall-clock time
+    int64_t days = (epoch >= 0 ? epoch : epoch - 86399) / 86400;
+    int64_t secondOfDay = epoch - days * 86400;
+    int64_t year;
+    unsigned month, day;
+    civilFromDays(days, year, month, day);
+
+    char text[64];
+    const int hour = static_cast<int>(secondOfDay / 3600);
+    const int minute = static_cast<int>(secondOfDay / 60 % 60);
+    const int second = static_cast<int>(secondOfDay % 60);
+    if (format == TIMESTAMP_US) {
+        std::snprintf(text, sizeof(text), "%02u/%02u/%04lld %02d:%02d:%02d",
+                      month, day, static_cast<long long>(year), hour, minute, second);
+    } else {
+        std::snprintf(text, sizeof(text), "%04lld-%02u-%02u %02d:%02d:%02d",
+                      static_cast<long long>(year), month, day, hour, minute, second);
+    }
+    return text;
+}
+
+/**
+ * Read a fixed number of decimal digits
+ * 
+ * @param text   Characters to read
+ * @param count  Number of digits
+ * @param value  Receives the number
+ * @return       false if any character is not a digit
+ */
+static inline bool readDigits(const char* text, int count, int& value) {
+    value = 0;
+    for (int i = 0; i < count; ++i) {
+        unsigned digit = static_cast<unsigned char>(text[i]) - '0';
+        if (digit > 9) return false;
+        value = value * 10 + static_cast<int>(digit);
+    }
+    return true;
+}
+
+/**
+ * Decode a canonical 19-character timestamp
+ * 
+ * @param text   YYYY-MM-DD HH:MM:SS or MM/DD/YYYY HH:MM:SS
+ * @param epoch  Receives seconds since 1970-01-01 00:00:00 UTC
+ * @param format Receives TIMESTAMP_ISO or TIMESTAMP_US
+ * @return       false if the text is not a valid timestamp in either layout
+ */
+bool TimestampDecoder::decode(string_view text, int64_t& epoch, TimestampFormat& format) {
+    if (text.size() != 19 || text[10] != ' ' || text[13] != ':' || text[16] != ':') return false;
+    const char* p = text.data();
+    bool us = p[2] == '/';
+
+    // Same date as the previous line: only the time of day is new
+    if (!cached || std::memcmp(p, lastDate, sizeof(lastDate)) != 0) {
+        int year, month, day;
+        if (us) {
+            if (p[5] != '/' || !readDigits(p, 2, month) || !readDigits(p + 3, 2, day) || !readDigits(p + 6, 4, year)) return false;
+        } else {
+            if (p[4] != '-' || p[7] != '-' || !readDigits(p, 4, year) || !readDigits(p + 5, 2, month) || !readDigits(p + 8, 2, day)) return false;
+        }
+        static const int DAYS_IN_MONTH[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+        if (month < 1 || month > 12 || day < 1) return false;
+        bool leap = year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+        if (day > DAYS_IN_MONTH[month - 1] + (month == 2 && leap ? 1 : 0)) return false;
+
+        std::memcpy(lastDate, p, sizeof(lastDate));
+        lastDay = daysFromCivil(year, static_cast<unsigned>(month), static_cast<unsigned>(day));
+        cached = true;
+    }
+
+    int hour, minute, second;
+    if (!readDigits(p + 11, 2, hour) || !readDigits(p + 14, 2, minute) || !readDigits(p + 17, 2, second)) return false;
+    if (hour > 23 || minute > 59 || second > 59) return false;
+
+    epoch = lastDay * 86400 + hour * 3600 + minute * 60 + second - logUtcOffset;
+    format = us ? TIMESTAMP_US : TIMESTAMP_ISO;
+    return true;
+}
+
+/**
+ * Convert a timestamp in any supported format to seconds since the epoch
+ * Accepts YYYY-MM-DD HH:MM:SS (formats 1 and 2) and MM/DD/YYYY HH:MM:SS
+ * (format 3), so entries from all formats share one comparable timeline.
+ * Canonical text goes through TimestampDecoder; other text (single-digit
+ * fields, out-of-range days) falls back to std::get_time.
+ * 
+ * @param timestamp Timestamp string (wall-clock time of the log's --timezone)
+ * @return          Seconds since 1970-01-01 00:00:00 UTC, or INVALID_EPOCH
+ */
+int64_t timestampToEpoch(const string& timestamp) {
+    TimestampDecoder decoder;
+    int64_t epoch;
+    TimestampFormat format;
+    if (decoder.decode(timestamp, epoch, format)) return epoch;
+
+    std::tm tm_struct = {};
+    istringstream ss(timestamp);
+    if (timestamp.find('/') != string::npos) {
+        ss >> std::get_time(&tm_struct, "%m/%d/%Y %H:%M:%S");
+    } else {
+        ss >> std::get_time(&tm_struct, "%Y-%m-%d %H:%M:%S");
+    }
+    if (ss.fail()) return INVALID_EPOCH;
+
+    int64_t days = daysFromCivil(tm_struct.tm_year + 1900, tm_struct.tm_mon + 1, tm_struct.tm_mday);
+    return days * 86400 + tm_struct.tm_hour * 3600 + tm_struct.tm_min * 60 + tm_struct.tm_sec - logUtcOffset;
+}
+
+/**
+ * Parse a --timezone value: the UTC offset of the log's timestamps
+ * "local" is resolved once, from the current local offset, so DST changes
+ * inside a log are not followed; pass an explicit offset to be exact.
  * 
- * @param timestamp Timestamp to check (YYYY-MM-DD HH:MM:SS)
- * @param startTime Range start time (YYYY-MM-DD HH:MM:SS)
- * @param endTime   Range end time (YYYY-MM-DD HH:MM:SS)
- * @return          true if timestamp is within range, false otherwise
+ * @param text   utc, local, or +HH:MM / -HH:MM (also +HH, +HHMM)
+ * @param offset Receives seconds east of UTC (left unchanged on failure)
+ * @return       false if the text is not a valid offset
  */
-bool isWithinTimeRange(const string& timestamp, const string& startTime, const string& endTime) {
-    std::tm entry_tm = {}, start_tm = {}, end_tm = {};
+bool parseUtcOffset(const string& text, int64_t& offset) {
+    string lower = toLowerStr(text);
+    if (lower == "utc" || lower == "z") {
+        offset = 0;
+        return true;
+    }
+    if (lower == "local") {
+        std::time_t now = std::time(nullptr);
+        std::tm local = *std::localtime(&now);
+        std::tm utc = *std::gmtime(&now);
+        auto secondsOf = [](const std::tm& t) {
+            return daysFromCivil(t.tm_year + 1900, t.tm_mon + 1, t.tm_mday) * 86400
+                 + t.tm_hour * 3600 + t.tm_min * 60 + t.tm_sec;
+        };
+        offset = secondsOf(local) - secondsOf(utc);
+        return true;
+    }
 
-    // Parse all timestamps
-    if(!parseTimestamp(timestamp, entry_tm) || 
-       !parseTimestamp(startTime, start_tm) || 
-       !parseTimestamp(endTime, end_tm)) {
+    if (text.size() < 3 || (text[0] != '+' && text[0] != '-')) return false;
+    string digits;
+    for (size_t i = 1; i < text.size(); ++i) {
+        if (text[i] == ':' && i == 3) continue;
+        digits += text[i];
+    }
+    int hours = 0, minutes = 0;
+    if ((digits.size() != 2 && digits.size() != 4) || !readDigits(digits.data(), 2, hours)
+        || (digits.size() == 4 && !readDigits(digits.data() + 2, 2, minutes)) || minutes > 59) {
         return false;
     }
+    int64_t parsed = (text[0] == '-' ? -1 : 1) * static_cast<int64_t>(hours * 3600 + minutes * 60);
+    if (std::abs(parsed) > MAX_UTC_OFFSET) return false;
+    offset = parsed;
+    return true;
+}
 
-    // Convert to time_t for comparison
-    time_t entry_time = std::mktime(&entry_tm);
-    time_t start = std::mktime(&start_tm);
-    time_t end = std::mktime(&end_tm);
-    
-    return entry_time >= start && entry_time <= end;
+/**
+ * Format a UTC offset for messages
+ * 
+ * @param offset Seconds east of UTC
+ * @return       "+HH:MM" or "-HH:MM"
+ */
+string formatUtcOffset(int64_t offset) {
+    char buffer[8];
+    int64_t magnitude = std::abs(offset);
+    std::snprintf(buffer, sizeof(buffer), "%c%02d:%02d", offset < 0 ? '-' : '+',
+                  static_cast<int>(magnitude / 3600), static_cast<int>(magnitude % 3600 / 60));
+    return buffer;
 }
 
 // ═══════════════════════════════════════════════════════════════════════════
@@ -1050,15 +9896,23 @@ void viewLogsByTimeRange() {
 
     int count = 0;
     ostringstream oss;
+    int64_t startEpoch = timestampToEpoch(startTime);
+    int64_t endEpoch = timestampToEpoch(endTime);
     
-    // Filter logs by time range
-    for (const auto& entry : logs) {
-        if(isWithinTimeRange(entry.timestamp, startTime, endTime)) {
-            string levelColor = getLevelColor(entry.level);
-            oss << "  " << CYAN << entry.timestamp << RESET 
-                << " [" << levelColor << entry.level << RESET << "] " 
-                << entry.message << "\n";
-            count++;
+    // Filter logs by time range, skipping blocks entirely outside it
+    for (size_t block = 0; block < blockIndex.size(); ++block) {
+        if (!blockOverlapsRange(blockIndex[block], startEpoch, endEpoch)) continue;
+
+        size_t blockEnd = std::min(logs.size(), (block + 1) * LOG_BLOCK_SIZE);
+        for (size_t i = block * LOG_BLOCK_SIZE; i < blockEnd; ++i) {
+            const auto& entry = logs[i];
+            if (entry.epoch >= startEpoch && entry.epoch <= endEpoch) {
+                string levelColor = getLevelColor(entryLevel(entry));
+                oss << "  " << CYAN << entryTimestamp(entry) << RESET 
+                    << " [" << levelColor << entryLevel(entry) << RESET << "] " 
+                    << entryMessage(entry) << "\n";
+                count++;
+            }
         }
     }
 
@@ -1076,6 +9930,18 @@ void viewLogsByTimeRange() {
 // IMPLEMENTATION: LOG LINE PARSING
 // ═══════════════════════════════════════════════════════════════════════════
 
+/**
+ * View of a regex capture group inside the original line (no copy)
+ * 
+ * @param line  Line the match was run against
+ * @param match Match results
+ * @param group Capture group index
+ * @return      View of the captured characters
+ */
+static string_view matchView(const string& line, const smatch& match, int group) {
+    return string_view(line.data() + match.position(group), match.length(group));
+}
+
 /**
  * Parse a single log line using multiple regex patterns
  * Attempts to match against 3 different log formats:
@@ -1083,39 +9949,50 @@ void viewLogsByTimeRange() {
  * 2. [YYYY-MM-DD HH:MM:SS] LEVEL: Message  
  * 3. MM/DD/YYYY HH:MM:SS - LEVEL - Message
  * 
- * @param line  Log line string to parse
- * @param entry LogEntry struct to populate with parsed data
- * @return      true if parsing succeeded, false if no format matched
+ * @param line          Log line string to parse
+ * @param entry         LogEntry struct to populate with parsed data
+ *                      (level and message are interned into the message
+ *                      pool; offset is relative to the line start)
+ * @param internMessage false to leave the message out of the pool (low-memory mode)
+ * @return              true if parsing succeeded, false if no format matched
  */
-bool parseLogLine(const string& line, LogEntry& entry) {
+bool parseLogLine(const string& line, LogEntry& entry, bool internMessage) {
     smatch match;
 
-    // Try format 1: YYYY-MM-DD HH:MM:SS [LEVEL] Message
-    if(regex_match(line, match, LOG_REGEX)) {
-        entry.timestamp = match[1];
-        entry.level = match[2];
-        entry.message = match[3];
-        return true;
+    // Try the three formats in order: YYYY-MM-DD HH:MM:SS [LEVEL] Message,
+    // [YYYY-MM-DD HH:MM:SS] LEVEL: Message, MM/DD/YYYY HH:MM:SS - LEVEL - Message
+    if(!regex_match(line, match, LOG_REGEX) &&
+       !regex_match(line, match, LOG_REGEX_ALT1) &&
+       !regex_match(line, match, LOG_REGEX_ALT2)) {
+        return false;  // No format matched
     }
 
-    // Try format 2: [YYYY-MM-DD HH:MM:SS] LEVEL: Message
-    if(regex_match(line, match, LOG_REGEX_ALT1)) {
-        entry.timestamp = match[1];
-        entry.level = match[2];
-        entry.message = match[3];
-        return true;
-    }
+    // All formats capture timestamp, level and message as groups 1-3
+    if(static_cast<size_t>(match.length(3)) > LogEntry::MAX_LENGTH) return false;
 
-    // Try format 3: MM/DD/YYYY HH:MM:SS - LEVEL - Message
-    if(regex_match(line, match, LOG_REGEX_ALT2)) {
-        entry.timestamp = match[1];
-        entry.level = match[2];
-        entry.message = match[3];
-        return true;
+    // Canonical timestamps decode without copies and print back identically
+    static thread_local TimestampDecoder decoder;
+    TimestampFormat format;
+    entry.timestampId = MessagePool::INVALID_ID;
+    if (decoder.decode(matchView(line, match, 1), entry.epoch, format)) {
+        entry.format = format;
+    } else {
+        string timestamp = match[1];
+        entry.epoch = timestampToEpoch(timestamp);
+        entry.format = timestamp.find('/') != string::npos ? TIMESTAMP_US : TIMESTAMP_ISO;
+
+        // Keep the text only if the epoch would not print back identically (e.g. 2026-02-30)
+        if(entry.epoch == INVALID_EPOCH || formatEpoch(entry.epoch, static_cast<TimestampFormat>(entry.format)) != timestamp) {
+            entry.format = TIMESTAMP_RAW;
+            entry.timestampId = messagePool.intern(timestamp);
+        }
     }
-    
-    // No format matched
-    return false;
+
+    entry.levelId = messagePool.intern(matchView(line, match, 2));
+    entry.offset = match.position(3);
+    entry.length = static_cast<uint32_t>(match.length(3));
+    entry.messageId = internMessage ? messagePool.intern(matchView(line, match, 3)) : LogEntry::LAZY_MESSAGE;
+    return true;
 }
 
 // ═══════════════════════════════════════════════════════════════════════════
@@ -1134,11 +10011,115 @@ bool parseLogLine(const string& line, LogEntry& entry) {
  *    - Execute corresponding function
  *    - Loop until user selects exit
  * 
- * @return 0 on successful exit
+ * Options:
+ *   --low-memory        Keep messages in the mapped file instead of memory
+ *   --max-memory SIZE   Spill entry blocks to disk segments above SIZE (e.g. 512M)
+ *   --collapse[=templates] Fold runs of repeated messages (or templates)
+ *   --serve FILE        Load FILE once and answer queries over a local socket
+ *   --connect           Query a running server instead of loading a file
+ *   --socket PATH       Socket file for --serve / --connect
+ *   --sample FILE       Print a sampling estimate of FILE ("-" = stdin) and exit
+ *   --sample-size N     Lines drawn by --sample
+ *   --profile[=FILE]    Enable instrumentation and write a JSON summary at exit
+ *   --trace[=FILE]      Record begin/end events and write a Chrome trace at exit
+ *   --bench FILE        Time load, parse, search, range query, statistics and export, then exit
+ *   --bench-runs N      Measured repetitions per benchmark case
+ *   --bench-warmup N    Unmeasured repetitions before them
+ *   --timezone ZONE     UTC offset of log timestamps: utc (default), local or +HH:MM
+ * 
+ * @param argc Argument count
+ * @param argv Command-line options
+ * @return     0 on successful exit
  */
-int main() {
+int main(int argc, char* argv[]) {
     // Initialize console for UTF-8 and ANSI colors
     setupConsole();
+
+    // Command-line options
+    string serveFile;
+    string socketPath = SERVER_DEFAULT_SOCKET;
+    bool connectMode = false;
+    string sampleFile;
+    size_t sampleSize = SAMPLE_DEFAULT_LINES;
+    string benchFile;
+    unsigned benchRuns = BENCH_DEFAULT_RUNS;
+    unsigned benchWarmup = BENCH_DEFAULT_WARMUP;
+    for (int i = 1; i < argc; ++i) {
+        string option = argv[i];
+        if (option == "--serve" && i + 1 < argc) {
+            serveFile = argv[++i];
+        } else if (option == "--socket" && i + 1 < argc) {
+            socketPath = argv[++i];
+        } else if (option == "--sample" && i + 1 < argc) {
+            sampleFile = argv[++i];
+        } else if (option == "--sample-size" && i + 1 < argc) {
+            try {
+                sampleSize = std::clamp<size_t>(std::stoul(argv[++i]), SAMPLE_MIN_LINES, SAMPLE_MAX_LINES);
+            } catch (...) {
+                cerr << RED << "  ✗ Invalid --sample-size: " << argv[i] << "\n" << RESET;
+            }
+        } else if (option == "--bench" && i + 1 < argc) {
+            benchFile = argv[++i];
+        } else if ((option == "--bench-runs" || option == "--bench-warmup") && i + 1 < argc) {
+            try {
+                unsigned value = static_cast<unsigned>(std::min<unsigned long>(std::stoul(argv[++i]), BENCH_MAX_RUNS));
+                if (option == "--bench-runs") benchRuns = std::max(1u, value);
+                else benchWarmup = value;
+            } catch (...) {
+                cerr << RED << "  ✗ Invalid " << option << ": " << argv[i] << "\n" << RESET;
+            }
+        } else if (option == "--timezone" && i + 1 < argc) {
+            if (!parseUtcOffset(argv[++i], logUtcOffset)) {
+                cerr << RED << "  ✗ Invalid --timezone: " << argv[i] << " (use utc, local or +HH:MM)\n" << RESET;
+            }
+        } else if (option == "--profile" || option.rfind("--profile=", 0) == 0) {
+            profileOutput = option == "--profile" ? PROFILE_DEFAULT_FILE : option.substr(10);
+            profiler.setEnabled(true);
+            memoryTracker.setEnabled(true);
+        } else if (option == "--trace" || option.rfind("--trace=", 0) == 0) {
+            startTracing(option == "--trace" ? TRACE_DEFAULT_FILE : option.substr(8));
+        } else if (option == "--connect") {
+            connectMode = true;
+        } else if (option == "--low-memory") {
+            lowMemoryMode = true;
+        } else if (option == "--collapse") {
+            collapseMode = COLLAPSE_MESSAGES;
+        } else if (option == "--collapse=templates") {
+            collapseMode = COLLAPSE_TEMPLATES;
+        } else if (option == "--max-memory" || option.rfind("--max-memory=", 0) == 0) {
+            string value = option == "--max-memory" ? (i + 1 < argc ? argv[++i] : "") : option.substr(13);
+            size_t budget = 0;
+            if (parseByteSize(value, budget)) {
+                if (budget < MIN_MEMORY_BUDGET) {
+                    cout << YELLOW << "  ⚠ --max-memory raised to the minimum of " << formatBytes(MIN_MEMORY_BUDGET) << "\n" << RESET;
+                    budget = MIN_MEMORY_BUDGET;
+                }
+                logs.setMemoryBudget(budget);
+                resultCache.setCapacity(std::min(RESULT_CACHE_BYTES, budget / RESULT_CACHE_BUDGET_SHARE));
+            } else {
+                cerr << RED << "  ✗ Invalid --max-memory size: " << value << " (use e.g. 512M or 2G)\n" << RESET;
+            }
+        } else {
+            cerr << YELLOW << "  ⚠ Unknown option ignored: " << option << "\n" << RESET;
+        }
+    }
+
+    if (!profileOutput.empty()) std::atexit(writeProfileAtExit);
+
+    // Daemon, thin-client, sampling and benchmark modes skip the interactive menu
+    if (connectMode) return runQueryClient(socketPath) ? 0 : 1;
+    if (!sampleFile.empty()) {
+        if (sampleFile != "-" && !isValidLogPath(sampleFile)) {
+            cerr << RED << "  ✗ Invalid or unauthorized file path.\n" << RESET;
+            return 1;
+        }
+        return sampleLogSource(sampleFile, sampleSize) ? 0 : 1;
+    }
+    if (!benchFile.empty()) return runBenchmark(benchFile, benchWarmup, benchRuns) ? 0 : 1;
+    if (!serveFile.empty()) {
+        if (!loadLogPath(serveFile)) return 1;
+        return runQueryServer(socketPath) ? 0 : 1;
+    }
     
     // Show animated welcome banner
     displayWelcomeBanner();
@@ -1205,11 +10186,15 @@ int main() {
                 break;
                 
             case 12:
+                advancedMenu();
+                break;
+                
+            case 13:
                 cout << "\n  " << GREEN << "✓ Exiting Log Analyzer. Goodbye!\n\n" << RESET; 
                 return 0;
                 
             default: 
-                cout << RED << "\n  ✗ Invalid option. Please select 1-12.\n" << RESET; 
+                cout << RED << "\n  ✗ Invalid option. Please select 1-13.\n" << RESET; 
                 break;
         }
     }